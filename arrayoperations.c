@@ -0,0 +1,202 @@
+/* FILE: arrayoperations.c
+ * AUTHOR: Kyle Notani | 19149918
+ * UNIT: UCP COMP1000
+ * PURPOSE: Operations on creation, growth and deletion of the contiguous
+ *          command array that stores every validated command.
+ * OTHER: Commands are stored by value so drawing walks a single block of
+ *        memory in order. The capacity doubles when full, so appending is
+ *        amortized O(1).
+ *        '-1' evaluates to true, '0' evaluates to false.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "commandarray.h"
+#include "arrayoperations.h"
+#include "structset.h"
+
+
+/* NAME: constructArray()
+ * PURPOSE: Constructs an empty command array.
+ * HOW IT WORKS: Allocates a CommandArray struct in heap memory along with
+ *               room for INITIAL_CAPACITY commands.
+ * RELATIONS:
+ *    main() - Used to construct the core command array to store all
+ *             validated commands.
+ * IMPORTS:
+ *    none
+ * EXPORTS:
+ *    array - a pointer to the allocated CommandArray struct on the heap, or
+ *            NULL if either allocation failed.
+ */
+
+CommandArray* constructArray()
+{
+   /* Allocate a CommandArray struct */
+   CommandArray* array = ( CommandArray* )malloc( sizeof( CommandArray ) );
+
+   if( array != NULL )
+   {
+      array->count = 0;
+      array->capacity = INITIAL_CAPACITY;
+      array->commands = ( Command* )malloc( INITIAL_CAPACITY * sizeof( Command ) );
+
+      /* Give up on the whole array if there is no room for commands */
+      if( array->commands == NULL )
+      {
+         free( array );
+         array = NULL;
+      }
+   }
+
+   return array;
+}
+
+
+/* NAME: insertLast()
+ * PURPOSE: Inserts a given command at the end of a given array. Used
+ *          particularly to maintain the natural ordering of read in commands
+ *          from a file in the same way.
+ * HOW IT WORKS: Doubles the capacity with realloc() when the array is full,
+ *               then copies the command into the next free slot.
+ * RELATIONS:
+ *    storeCommand() - Used by storeCommand() to store a validated command at
+ *                     the end of the array.
+ * IMPORTS:
+ *    array - A given array to insert the command at the end.
+ *    cmd - The command to be copied into the array.
+ * EXPORTS:
+ *    isInserted - Boolean evaluating to '0' (FALSE) if the array could not
+ *                 grow or '-1' (TRUE) if the command was inserted.
+ */
+
+int insertLast( CommandArray* array, Command* cmd )
+{
+   int isInserted = -1;
+   Command* grown = NULL;
+
+   /* Grow the array when every slot is taken */
+   if( array->count == array->capacity )
+   {
+      grown = ( Command* )realloc( array->commands, 2 * array->capacity * sizeof( Command ) );
+
+      if( grown == NULL )
+      {
+         isInserted = 0;
+      }
+      else
+      {
+         array->commands = grown;
+         array->capacity *= 2;
+      }
+   }
+
+   if( isInserted != 0 )
+   {
+      array->commands[array->count] = *cmd;
+      array->count++;
+   }
+
+   return isInserted;
+}
+
+
+/* NAME: appendArray()
+ * PURPOSE: Appends every command of another array to the end of a given
+ *          array, keeping their order.
+ * HOW IT WORKS: Doubles the capacity with realloc() until the commands fit,
+ *               then copies them all with a single memcpy().
+ * RELATIONS:
+ *    validateScript() - Merges the commands of each chunk of a script in
+ *                       line order.
+ * IMPORTS:
+ *    array - A given array to append the commands to.
+ *    other - The array whose commands are copied, left unchanged.
+ * EXPORTS:
+ *    isAppended - Boolean evaluating to '0' (FALSE) if the array could not
+ *                 grow or '-1' (TRUE) if the commands were appended.
+ */
+
+int appendArray( CommandArray* array, CommandArray* other )
+{
+   int isAppended = -1;
+   int capacity = array->capacity;
+   Command* grown = NULL;
+
+   while( capacity - array->count < other->count )
+   {
+      capacity *= 2;
+   }
+
+   if( capacity != array->capacity )
+   {
+      grown = ( Command* )realloc( array->commands, capacity * sizeof( Command ) );
+
+      if( grown == NULL )
+      {
+         isAppended = 0;
+      }
+      else
+      {
+         array->commands = grown;
+         array->capacity = capacity;
+      }
+   }
+
+   if( isAppended != 0 )
+   {
+      memcpy( array->commands + array->count, other->commands, other->count * sizeof( Command ) );
+      array->count += other->count;
+   }
+
+   return isAppended;
+}
+
+
+/* NAME: isEmpty()
+ * PURPOSE: Checks if a given array is empty before carrying out any array
+ *          operations which other functions use.
+ * HOW IT WORKS: Checks if the array holds any commands and returns the
+ *               condition.
+ * RELATIONS:
+ *    draw() - Checks if the commands were never stored within the array before
+ *             commencing drawing.
+ * IMPORTS:
+ *    array - A given array to check if empty.
+ * EXPORTS:
+ *    isEmpty - Boolean evaluating if the array is empty (TRUE) or is not empty.
+ */
+
+int isEmpty( CommandArray* array )
+{
+   int isEmpty = 0;
+
+   if( array->count == 0 )
+   {
+      isEmpty = -1;
+   }
+
+   return isEmpty;
+}
+
+
+/* NAME: freeArray()
+ * PURPOSE: Deallocates the array stored on heap memory along with every
+ *          stored command.
+ * HOW IT WORKS: Commands hold no heap memory of their own, so frees the
+ *               block of commands and then the array struct itself.
+ * RELATIONS:
+ *    main() - Deallocates the constructed array in main() after complete use.
+ * IMPORTS:
+ *    array - A given array to deallocate.
+ * EXPORTS:
+ *    none
+ */
+
+void freeArray( CommandArray* array )
+{
+   free( array->commands );
+   free( array );
+}
@@ -0,0 +1,36 @@
+/* FILE: arrayoperations.h
+ * AUTHOR: Kyle Notani | 19149918
+ * UNIT: UCP COMP1000
+ * PURPOSE: Header file associated with arrayoperations.c
+ */
+
+#ifndef ARRAYOPERATIONS_H
+   #define ARRAYOPERATIONS_H
+
+   #include "commandarray.h"
+
+   /* Constructs an empty command array. */
+   CommandArray* constructArray();
+
+   /* Inserts a given command at the end of a given array. Used particularly to
+    * maintain the natural ordering of read in commands from a file in the same
+    * way.
+    */
+   int insertLast( CommandArray* array, Command* cmd );
+
+   /* Appends every command of another array to the end of a given array,
+    * keeping their order.
+    */
+   int appendArray( CommandArray* array, CommandArray* other );
+
+   /* Checks if a given array is empty before carrying out any array operations
+    * which other functions use.
+    */
+   int isEmpty( CommandArray* array );
+
+   /* Deallocates the array stored on heap memory along with every stored
+    * command.
+    */
+   void freeArray( CommandArray* array );
+
+#endif
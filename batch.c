@@ -0,0 +1,137 @@
+/*
+ * FILE: batch.c
+ * AUTHOR: Kyle Notani | 19149918
+ * UNIT: UCP COMP1000
+ * PURPOSE: Find the directions of whole arrays of angles at once.
+ * OTHER: Every direction is exactly the one defineDirection() gives angle
+ *        by angle, to the last bit. An exact direction is looked up in a
+ *        table filled by defineDirection() itself. Any other angle has its
+ *        direction found by defineDirection(), as drawing finds it, once
+ *        for each run of the same angle.
+ *        '-1' evaluates to true, '0' evaluates to false.
+ */
+
+#define _POSIX_C_SOURCE 199506L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <pthread.h>
+
+#include "batch.h"
+#include "conversions.h"
+
+/* Stores the last direction found, reused while the angle stays the same */
+typedef struct
+{
+   double angle;
+   double dirX;
+   double dirY;
+   int isFound;
+} LastDirection;
+
+static void fillTable( void );
+static void findDirection( double angle, double* dirX, double* dirY, LastDirection* last );
+
+/* Whether the table has been filled, once, by the first batch on any
+ * thread */
+static pthread_once_t isFilled = PTHREAD_ONCE_INIT;
+
+/* Exact directions of every multiple of SINE_STEP degrees within 360 */
+static double cosTable[BATCH_DIRECTIONS];
+static double sinTable[BATCH_DIRECTIONS];
+
+
+/* NAME: defineDirections()
+ * PURPOSE: Finds the unit direction of every angle of an array.
+ * HOW IT WORKS: - Fills the table on the first call.
+ *               - Rounds each angle to the nearest SINE_STEP. A step that
+ *                 gives back exactly the angle, within 360 degrees, is a
+ *                 multiple with its direction in the table. A NaN never
+ *                 compares equal, so is never looked up.
+ *               - Any other angle is found with findDirection().
+ * RELATIONS:
+ *    defineDirection() - Gives the same direction for each angle.
+ *    runChunk() - Finds the direction of each rotate of a block of a run.
+ *    fillTable() - Fills the table, once, with pthread_once().
+ * IMPORTS:
+ *    angles - Angles in degrees.
+ *    dirX/dirY - Set to the cosine and sine of each angle.
+ *    count - The number of angles.
+ * EXPORTS:
+ *    none
+ */
+
+void defineDirections( const double* angles, double* dirX, double* dirY, int count )
+{
+   LastDirection last;
+   double step;
+   int ii;
+
+   pthread_once( &isFilled, &fillTable );
+   last.isFound = 0;
+   for ( ii = 0; ii < count; ii++ )
+   {
+      step = floor( angles[ii] / SINE_STEP + 0.5 );
+      if ( ( angles[ii] >= 0.0 ) && ( angles[ii] < 360.0 ) && ( step * SINE_STEP == angles[ii] ) )
+      {
+         dirX[ii] = cosTable[( int )step];
+         dirY[ii] = sinTable[( int )step];
+      }
+      else
+      {
+         findDirection( angles[ii], &dirX[ii], &dirY[ii], &last );
+      }
+   }
+}
+
+
+/* NAME: fillTable()
+ * PURPOSE: Fills the table of exact directions.
+ * HOW IT WORKS: The table holds defineDirection()'s own direction for each
+ *               multiple of SINE_STEP degrees.
+ * RELATIONS:
+ *    defineDirections() - Fills the table once, with pthread_once().
+ * IMPORTS:
+ *    none
+ * EXPORTS:
+ *    none
+ */
+
+static void fillTable( void )
+{
+   int ii;
+
+   for ( ii = 0; ii < BATCH_DIRECTIONS; ii++ )
+   {
+      defineDirection( ( double )( ii * SINE_STEP ), &cosTable[ii], &sinTable[ii] );
+   }
+}
+
+
+/* NAME: findDirection()
+ * PURPOSE: Finds the direction of an angle not in the table.
+ * HOW IT WORKS: Reuses the last direction found if the angle is the same,
+ *               as it is along a run with one heading, and otherwise finds
+ *               it with defineDirection().
+ * RELATIONS:
+ *    defineDirections() - Finds each angle's direction.
+ * IMPORTS:
+ *    angle - An angle in degrees.
+ *    dirX/dirY - Set to the cosine and sine of the angle.
+ *    last - The last direction found, updated.
+ * EXPORTS:
+ *    none
+ */
+
+static void findDirection( double angle, double* dirX, double* dirY, LastDirection* last )
+{
+   if ( ( last->isFound == 0 ) || ( angle != last->angle ) )
+   {
+      defineDirection( angle, &( last->dirX ), &( last->dirY ) );
+      last->angle = angle;
+      last->isFound = -1;
+   }
+   *dirX = last->dirX;
+   *dirY = last->dirY;
+}
@@ -0,0 +1,18 @@
+/* FILE: batch.h
+ * AUTHOR: Kyle Notani | 19149918
+ * UNIT: UCP COMP1000
+ * PURPOSE: Header file associated with batch.c
+ */
+
+#ifndef BATCH_H
+   #define BATCH_H
+
+   /* Angles with an exact direction, one every SINE_STEP degrees */
+   #define BATCH_DIRECTIONS 24
+
+   /* Finds the unit direction of every angle of an array, exactly as
+    * defineDirection() does for each.
+    */
+   void defineDirections( const double* angles, double* dirX, double* dirY, int count );
+
+#endif
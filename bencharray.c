@@ -0,0 +1,285 @@
+/*
+ * FILE: bencharray.c
+ * AUTHOR: Kyle Notani | 19149918
+ * UNIT: UCP COMP1000
+ * PURPOSE: Time storing commands in the growable command array against a
+ *          linked list walked to its end for every command, as commands
+ *          were stored before the array, and time TurtleGraphics loading
+ *          scripts of as many commands.
+ * COMMAND ARGUMENTS: Optionally the numbers of commands to time, 10000,
+ *                    1000000 and 10000000 if none.
+ * OTHER: Run by 'make bench', from the directory TurtleGraphics is built
+ *        in. Each script is written to bencharray.txt, removed afterwards,
+ *        and ends in an invalid line so TurtleGraphics loads and validates
+ *        every command but draws nothing. The linked list is only timed up
+ *        to LIST_LIMIT commands, taking quadratic time.
+ *        '-1' evaluates to true, '0' evaluates to false.
+ */
+
+#define _POSIX_C_SOURCE 199506L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/times.h>
+
+#include "arrayoperations.h"
+#include "commandarray.h"
+
+/* Commands timed unless given on the command line */
+static const long SIZES[3] = { 10000L, 1000000L, 10000000L };
+
+/* Most commands stored in the linked list */
+#define LIST_LIMIT 20000L
+
+/* Script written and loaded, and how TurtleGraphics is run on it */
+#define SCRIPT_NAME "bencharray.txt"
+#define LOAD_COMMAND "./TurtleGraphics " SCRIPT_NAME " > /dev/null"
+
+/* A node of the linked list timed */
+typedef struct ListNode
+{
+   Command cmd;
+   struct ListNode* next;
+} ListNode;
+
+static double timeArray( long count );
+static double timeList( long count );
+static double timeLoad( long count );
+static void makeCommand( long index, Command* cmd );
+
+
+/*
+ * NAME: main()
+ * PURPOSE: Entry point to the command array benchmark.
+ * HOW IT WORKS: For each number of commands, times storing them in the
+ *               array and in the linked list, then writes a script of as
+ *               many and times TurtleGraphics loading it, printing the
+ *               seconds for each.
+ * RELATIONS:
+ *    timeArray()/timeList()/timeLoad() - Time each way of storing the
+ *                                        commands.
+ *
+ * IMPORTS:
+ *    argc  The number of command-line arguments.
+ *    argv  An array of pointers to chars where each represents the argument
+ *          string (argument vector).
+ *
+ * EXPORTS:
+ *          Exit status condition provided to the OS.
+ */
+
+int main( int argc, char* argv[] )
+{
+   int sizes = ( argc > 1 ) ? argc - 1 : 3;
+   long count;
+   int ii;
+
+   printf( "commands      array s    linked list s    load s\n" );
+   for ( ii = 0; ii < sizes; ii++ )
+   {
+      count = ( argc > 1 ) ? atol( argv[ii + 1] ) : SIZES[ii];
+      printf( "%-10ld %10.3f", count, timeArray( count ) );
+      if ( count <= LIST_LIMIT )
+      {
+         printf( " %16.3f", timeList( count ) );
+      }
+      else
+      {
+         printf( " %16s", "-" );
+      }
+      printf( " %9.3f\n", timeLoad( count ) );
+      fflush( stdout );
+   }
+
+   return 0;
+}
+
+
+/* NAME: timeArray()
+ * PURPOSE: Times storing commands in the command array, returning the
+ *          seconds taken.
+ * HOW IT WORKS: Inserts each command at the end of an empty array with
+ *               insertLast(), as validating a file does, then frees it.
+ * RELATIONS:
+ *    main() - Times each number of commands.
+ * IMPORTS:
+ *    count - The number of commands to store.
+ * EXPORTS:
+ *    seconds - Processor time taken, or -1 if the array could not grow.
+ */
+
+static double timeArray( long count )
+{
+   CommandArray* array = constructArray();
+   Command cmd;
+   clock_t start = clock();
+   double seconds;
+   int isStored = ( array != NULL ) ? -1 : 0;
+   long ii;
+
+   for ( ii = 0; ( ii < count ) && ( isStored != 0 ); ii++ )
+   {
+      makeCommand( ii, &cmd );
+      isStored = insertLast( array, &cmd );
+   }
+   if ( array != NULL )
+   {
+      freeArray( array );
+   }
+   seconds = ( double )( clock() - start ) / CLOCKS_PER_SEC;
+
+   return ( isStored != 0 ) ? seconds : -1.0;
+}
+
+
+/* NAME: timeList()
+ * PURPOSE: Times storing commands in a linked list, returning the seconds
+ *          taken.
+ * HOW IT WORKS: Walks from the head to the last node for every command
+ *               inserted, as the list kept no tail, then frees every node.
+ * RELATIONS:
+ *    main() - Times each number of commands up to LIST_LIMIT.
+ * IMPORTS:
+ *    count - The number of commands to store.
+ * EXPORTS:
+ *    seconds - Processor time taken, or -1 if a node could not be
+ *              allocated.
+ */
+
+static double timeList( long count )
+{
+   ListNode* head = NULL;
+   ListNode* node;
+   ListNode* last;
+   clock_t start = clock();
+   double seconds;
+   int isStored = -1;
+   long ii;
+
+   for ( ii = 0; ( ii < count ) && ( isStored != 0 ); ii++ )
+   {
+      node = ( ListNode* )malloc( sizeof( ListNode ) );
+      if ( node == NULL )
+      {
+         isStored = 0;
+      }
+      else
+      {
+         makeCommand( ii, &node->cmd );
+         node->next = NULL;
+         if ( head == NULL )
+         {
+            head = node;
+         }
+         else
+         {
+            last = head;
+            while ( last->next != NULL )
+            {
+               last = last->next;
+            }
+            last->next = node;
+         }
+      }
+   }
+   while ( head != NULL )
+   {
+      node = head->next;
+      free( head );
+      head = node;
+   }
+   seconds = ( double )( clock() - start ) / CLOCKS_PER_SEC;
+
+   return ( isStored != 0 ) ? seconds : -1.0;
+}
+
+
+/* NAME: timeLoad()
+ * PURPOSE: Times TurtleGraphics loading a script of a number of commands,
+ *          returning the seconds taken.
+ * HOW IT WORKS: Writes the script to SCRIPT_NAME, cycling through a DRAW,
+ *               ROTATE, FG and MOVE and ending in an invalid line, then runs
+ *               TurtleGraphics on it with system(). The processor time of
+ *               the finished child, on every thread, is taken from times().
+ * RELATIONS:
+ *    main() - Times each number of commands.
+ * IMPORTS:
+ *    count - The number of valid commands in the script.
+ * EXPORTS:
+ *    seconds - Processor time taken, or -1 if the script could not be
+ *              written or TurtleGraphics run.
+ */
+
+static double timeLoad( long count )
+{
+   static const char* LINES[4] = { "DRAW 5\n", "ROTATE 90\n", "FG 3\n", "MOVE 2.5\n" };
+   double seconds = -1.0;
+   FILE* script = fopen( SCRIPT_NAME, "w" );
+   struct tms before;
+   struct tms after;
+   long ticks = sysconf( _SC_CLK_TCK );
+   long ii;
+
+   if ( script != NULL )
+   {
+      for ( ii = 0; ii < count; ii++ )
+      {
+         fputs( LINES[ii % 4], script );
+      }
+      fputs( "NOT A COMMAND\n", script );
+
+      if ( ( fclose( script ) == 0 ) && ( ticks > 0 ) )
+      {
+         times( &before );
+         if ( system( LOAD_COMMAND ) != -1 )
+         {
+            times( &after );
+            seconds = ( double )( ( after.tms_cutime - before.tms_cutime ) +
+                                  ( after.tms_cstime - before.tms_cstime ) ) / ticks;
+         }
+      }
+      remove( SCRIPT_NAME );
+   }
+
+   return seconds;
+}
+
+
+/* NAME: makeCommand()
+ * PURPOSE: Makes the command stored at an index.
+ * HOW IT WORKS: Cycles through a DRAW, ROTATE, FG and MOVE, as the script
+ *               loaded by timeLoad() does.
+ * RELATIONS:
+ *    timeArray()/timeList() - Make each command stored.
+ * IMPORTS:
+ *    index - Index of the command.
+ *    cmd - Set to the command.
+ * EXPORTS:
+ *    none
+ */
+
+static void makeCommand( long index, Command* cmd )
+{
+   cmd->jump = ( int )index + 1;
+   switch ( index % 4 )
+   {
+      case 0:
+         cmd->opcode = OP_DRAW;
+         cmd->value.real = 5.0;
+         break;
+      case 1:
+         cmd->opcode = OP_ROTATE;
+         cmd->value.real = 90.0;
+         break;
+      case 2:
+         cmd->opcode = OP_FG;
+         cmd->value.integer = 3;
+         break;
+      default:
+         cmd->opcode = OP_MOVE;
+         cmd->value.real = 2.5;
+         break;
+   }
+}
@@ -0,0 +1,376 @@
+/*
+ * FILE: benchbytes.c
+ * AUTHOR: Kyle Notani | 19149918
+ * UNIT: UCP COMP1000
+ * PURPOSE: Count the bytes TurtleGraphics sends to the terminal to draw
+ *          scripts, in direct mode and from the framebuffer, against
+ *          printing every cell of every line after a move of its own, as
+ *          lines were printed before either.
+ * FILE FORMATS: Reads the graphics.log TurtleGraphics appends to (see
+ *               graphicslog.c).
+ * COMMAND ARGUMENTS: Optionally the names of the scripts to draw,
+ *                    charizard.txt if none.
+ * OTHER: Run by 'make bench', from the directory TurtleGraphics is built
+ *        in. The bytes counted run from the escape blanking the terminal to
+ *        the escape moving the cursor to the bottom, leaving out the report
+ *        printed around them. Printing cell by cell, the colour escapes sent
+ *        for each FG and BG command are left out too, so its count is if
+ *        anything low.
+ *        '-1' evaluates to true, '0' evaluates to false.
+ */
+
+#define _POSIX_C_SOURCE 199506L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "graphicslog.h"
+#include "conversions.h"
+
+/* Script drawn unless given on the command line */
+#define DEFAULT_SCRIPT "charizard.txt"
+
+/* How TurtleGraphics is run on a script, given an option or none */
+#define RUN_FORMAT "./TurtleGraphics %s %s 2> /dev/null"
+
+/* Escapes starting and ending every drawing on the terminal */
+#define CLEAR_ESCAPE "\033[2J"
+#define PEN_ESCAPE "\033[10000;1H"
+
+/* Bytes read from TurtleGraphics at a time */
+#define READ_SIZE 65536
+
+static long countDrawn( const char* option, const char* name );
+static long countPerCell( long* cells );
+static long countLine( int x1, int y1, int x2, int y2, long* cells );
+static double getCoordinate( unsigned char* bytes );
+static long findBytes( const char* data, long length, const char* bytes, int isLast );
+
+
+/*
+ * NAME: main()
+ * PURPOSE: Entry point to the output byte count benchmark.
+ * HOW IT WORKS: Draws each script in direct mode, then counts the cells of
+ *               the lines it logged to graphics.log and the bytes printing
+ *               each of them after a move would take, then draws it from
+ *               the framebuffer, printing the bytes of each.
+ * RELATIONS:
+ *    countDrawn() - Counts the bytes of each drawing.
+ *    countPerCell() - Counts the bytes of printing it cell by cell.
+ *
+ * IMPORTS:
+ *    argc  The number of command-line arguments.
+ *    argv  An array of pointers to chars where each represents the argument
+ *          string (argument vector).
+ *
+ * EXPORTS:
+ *          Exit status condition provided to the OS.
+ */
+
+int main( int argc, char* argv[] )
+{
+   int scripts = ( argc > 1 ) ? argc - 1 : 1;
+   const char* name;
+   long direct;
+   long perCell;
+   long cells;
+   int ii;
+
+   printf( "script                   cells  per cell B    direct B    framebuffer B\n" );
+   for ( ii = 0; ii < scripts; ii++ )
+   {
+      name = ( argc > 1 ) ? argv[ii + 1] : DEFAULT_SCRIPT;
+      direct = countDrawn( "-d", name );
+      printf( "%-20s", name );
+      if ( direct < 0 )
+      {
+         printf( " %10s %11s %11s %16s\n", "-", "-", "-", "-" );
+      }
+      else
+      {
+         perCell = countPerCell( &cells );
+         printf( " %10ld %11ld %11ld %16ld\n", cells, perCell, direct, countDrawn( "", name ) );
+      }
+      fflush( stdout );
+   }
+
+   return 0;
+}
+
+
+/* NAME: countDrawn()
+ * PURPOSE: Counts the bytes TurtleGraphics sends to draw a script.
+ * HOW IT WORKS: Runs TurtleGraphics on the script with popen(), reading all
+ *               it prints, and counts from the first CLEAR_ESCAPE to the end
+ *               of the last PEN_ESCAPE.
+ * RELATIONS:
+ *    main() - Counts each script in each mode.
+ *    findBytes() - Finds where the drawing starts and ends.
+ * IMPORTS:
+ *    option - The option TurtleGraphics is run with, or an empty string.
+ *    name - The name of the script.
+ * EXPORTS:
+ *    count - The bytes of the drawing, or -1 if TurtleGraphics could not be
+ *            run or drew nothing.
+ */
+
+static long countDrawn( const char* option, const char* name )
+{
+   char* command = ( char* )malloc( strlen( RUN_FORMAT ) + strlen( option ) + strlen( name ) + 1 );
+   char* data = NULL;
+   char* grown;
+   FILE* output = NULL;
+   long length = 0;
+   long first = -1;
+   long last = -1;
+   size_t count = READ_SIZE;
+
+   if ( command != NULL )
+   {
+      sprintf( command, RUN_FORMAT, option, name );
+      output = popen( command, "r" );
+      free( command );
+   }
+   if ( output != NULL )
+   {
+      while ( count == READ_SIZE )
+      {
+         grown = ( char* )realloc( data, ( size_t )length + READ_SIZE );
+         if ( grown == NULL )
+         {
+            count = 0;
+            length = 0;
+         }
+         else
+         {
+            data = grown;
+            count = fread( data + length, 1, READ_SIZE, output );
+            length += ( long )count;
+         }
+      }
+      pclose( output );
+
+      first = findBytes( data, length, CLEAR_ESCAPE, 0 );
+      last = findBytes( data, length, PEN_ESCAPE, -1 );
+      free( data );
+   }
+
+   return ( ( first >= 0 ) && ( last >= first ) ) ? last + ( long )strlen( PEN_ESCAPE ) - first : -1;
+}
+
+
+/* NAME: countPerCell()
+ * PURPOSE: Counts the bytes of printing the last drawing in graphics.log a
+ *          cell at a time, each after a move to it.
+ * HOW IT WORKS: Reads the log's records, starting the count again at each
+ *               LOG_RUN marking a drawing. Each DRAW's ends are rounded to
+ *               whole cells, as drawing does, and its cells counted by
+ *               countLine(). Text lines of an older log are skipped.
+ * RELATIONS:
+ *    main() - Counts each script drawn.
+ *    countLine() - Counts the bytes of each line.
+ *    getCoordinate() - Reads each coordinate of a record.
+ * IMPORTS:
+ *    cells - Set to the number of cells printed.
+ * EXPORTS:
+ *    count - The bytes of the drawing, from CLEAR_ESCAPE to PEN_ESCAPE.
+ */
+
+static long countPerCell( long* cells )
+{
+   FILE* log = fopen( LOG_NAME, "rb" );
+   unsigned char bytes[LOG_RECORD_MAX];
+   double startX = 0.0;
+   double startY = 0.0;
+   double endX = 0.0;
+   double endY = 0.0;
+   long count = 0;
+   size_t length;
+   int c = ( log != NULL ) ? getc( log ) : EOF;
+
+   *cells = 0;
+   while ( c != EOF )
+   {
+      if ( c == LOG_RUN )
+      {
+         length = LOG_MAGIC_LENGTH + 1;
+         *cells = 0;
+         count = 0;
+         endX = 0.0;
+         endY = 0.0;
+      }
+      else if ( ( c == LOG_DRAW ) || ( c == LOG_MOVE ) )
+      {
+         length = 16;
+      }
+      else if ( ( c == LOG_DRAW_FROM ) || ( c == LOG_MOVE_FROM ) )
+      {
+         length = 32;
+      }
+      else
+      {
+         length = 0;
+         while ( ( c != EOF ) && ( c != '\n' ) )
+         {
+            c = getc( log );
+         }
+      }
+
+      if ( ( length > 0 ) && ( fread( bytes, 1, length, log ) != length ) )
+      {
+         c = EOF;
+      }
+      else if ( ( c != LOG_RUN ) && ( length > 0 ) )
+      {
+         startX = endX;
+         startY = endY;
+         if ( length == 32 )
+         {
+            startX = getCoordinate( bytes );
+            startY = getCoordinate( bytes + 8 );
+         }
+         endX = getCoordinate( bytes + length - 16 );
+         endY = getCoordinate( bytes + length - 8 );
+         if ( ( c == LOG_DRAW ) || ( c == LOG_DRAW_FROM ) )
+         {
+            count += countLine( round( startX ), round( startY ), round( endX ), round( endY ), cells );
+         }
+      }
+
+      if ( c != EOF )
+      {
+         c = getc( log );
+      }
+   }
+   if ( log != NULL )
+   {
+      fclose( log );
+   }
+
+   return count + ( long )strlen( CLEAR_ESCAPE ) + ( long )strlen( PEN_ESCAPE );
+}
+
+
+/* NAME: countLine()
+ * PURPOSE: Counts the bytes of printing a line a cell at a time.
+ * HOW IT WORKS: Steps along the line as line() in effects.c does, adding
+ *               the move to each cell and the cell itself.
+ * RELATIONS:
+ *    countPerCell() - Counts each line drawn.
+ * IMPORTS:
+ *    x1/y1 - The first cell of the line.
+ *    x2/y2 - The last cell of the line.
+ *    cells - Added to for each cell printed.
+ * EXPORTS:
+ *    count - The bytes printed.
+ */
+
+static long countLine( int x1, int y1, int x2, int y2, long* cells )
+{
+   char escape[32];
+   long count = 0;
+   long majorDelta = labs( ( long )x2 - x1 );
+   long minorDelta = labs( ( long )y2 - y1 );
+   long decision;
+   long ii;
+   int majorX = ( x2 < x1 ) ? -1 : 1;
+   int majorY = 0;
+   int minorX = 0;
+   int minorY = ( y2 < y1 ) ? -1 : 1;
+   int x = x1;
+   int y = y1;
+
+   if ( minorDelta > majorDelta )
+   {
+      decision = majorDelta;
+      majorDelta = minorDelta;
+      minorDelta = decision;
+      majorY = minorY;
+      minorX = majorX;
+      majorX = 0;
+      minorY = 0;
+   }
+
+   *cells += majorDelta + 1;
+   decision = majorDelta / 2;
+   for ( ii = 0; ii <= majorDelta; ii++ )
+   {
+      sprintf( escape, "\033[%d;%dH", y + 1, x + 1 );
+      count += ( long )strlen( escape ) + 1;
+
+      x += majorX;
+      y += majorY;
+      decision += minorDelta;
+      if ( decision >= majorDelta )
+      {
+         decision -= majorDelta;
+         x += minorX;
+         y += minorY;
+      }
+   }
+
+   return count;
+}
+
+
+/* NAME: getCoordinate()
+ * PURPOSE: Reads a coordinate of a graphics.log record.
+ * HOW IT WORKS: Puts the 8 bytes, least significant first, back together as
+ *               the bits of the double, as decodeLog() does.
+ * RELATIONS:
+ *    countPerCell() - Reads the coordinates of each record.
+ * IMPORTS:
+ *    bytes - The 8 bytes of the coordinate.
+ * EXPORTS:
+ *    value - The coordinate.
+ */
+
+static double getCoordinate( unsigned char* bytes )
+{
+   unsigned long bits = 0;
+   double value;
+   int ii;
+
+   for ( ii = 7; ii >= 0; ii-- )
+   {
+      bits = ( bits << 8 ) | bytes[ii];
+   }
+   memcpy( &value, &bits, sizeof( double ) );
+
+   return value;
+}
+
+
+/* NAME: findBytes()
+ * PURPOSE: Finds where a string of bytes appears in a block of data.
+ * HOW IT WORKS: Compares the bytes at every offset, from the start or from
+ *               the end.
+ * RELATIONS:
+ *    countDrawn() - Finds where each drawing starts and ends.
+ * IMPORTS:
+ *    data - The block searched, or NULL.
+ *    length - The bytes in the block.
+ *    bytes - The string searched for.
+ *    isLast - Whether the last appearance is found rather than the first.
+ * EXPORTS:
+ *    offset - Where the bytes start in the block, or -1 if they don't
+ *             appear.
+ */
+
+static long findBytes( const char* data, long length, const char* bytes, int isLast )
+{
+   long size = ( long )strlen( bytes );
+   long offset = -1;
+   long ii;
+
+   for ( ii = 0; ( data != NULL ) && ( ii + size <= length ); ii++ )
+   {
+      if ( ( memcmp( data + ii, bytes, ( size_t )size ) == 0 ) && ( ( isLast != 0 ) || ( offset < 0 ) ) )
+      {
+         offset = ii;
+      }
+   }
+
+   return offset;
+}
@@ -0,0 +1,273 @@
+/*
+ * FILE: benchline.c
+ * AUTHOR: Kyle Notani | 19149918
+ * UNIT: UCP COMP1000
+ * PURPOSE: Time drawing lines into the framebuffer, in cells a second, for
+ *          short and long lines in each octant and along each axis, against
+ *          drawing the same cells one at a time, and printing them straight
+ *          to the terminal as direct mode does.
+ * COMMAND ARGUMENTS: Optionally the number of cells drawn for each line,
+ *                    20000000 if none.
+ * OTHER: Run by 'make bench'. Drawing a cell at a time goes through the
+ *        tile lookup, bounds check and row extent of every cell, as lines
+ *        were drawn before the span fills and Bresenham kernels. Lines
+ *        printed as direct mode does are sent to /dev/null, the table going
+ *        to where standard output first went.
+ *        '-1' evaluates to true, '0' evaluates to false.
+ */
+
+#define _POSIX_C_SOURCE 199506L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "framebuffer.h"
+#include "viewport.h"
+#include "effects.h"
+
+/* Cells drawn for each line unless given on the command line */
+#define BENCH_CELLS 20000000L
+
+/* Size of the canvas the lines are drawn on, and the cell they start at */
+#define BENCH_CANVAS 1024
+#define BENCH_CENTRE 512
+
+/* Lines timed, in cells along their longer axis */
+#define SHORT_LINE 8
+#define LONG_LINE 400
+
+static double timeFrame( FrameBuffer* frame, Viewport* view, int x2, int y2, long lines );
+static double timeCells( FrameBuffer* frame, Viewport* view, int x2, int y2, long lines );
+static double timeDirect( Viewport* view, int x2, int y2, long lines );
+
+/* Directions of the lines timed, a cell along the longer axis for every
+ * half a cell along the other, then along each axis */
+static const int DIRECTIONS[10][2] =
+{
+   { 1, 2 }, { 2, 1 }, { 2, -1 }, { 1, -2 },
+   { -1, -2 }, { -2, -1 }, { -2, 1 }, { -1, 2 },
+   { 2, 0 }, { 0, 2 }
+};
+
+
+/*
+ * NAME: main()
+ * PURPOSE: Entry point to the line benchmark.
+ * HOW IT WORKS: For each direction and length, draws the line from the
+ *               centre of the canvas enough times to draw the cells asked
+ *               for, with clipLine() and frameSegment() as drawing does,
+ *               then a cell at a time, then with drawSegment() as direct
+ *               mode does, printing millions of cells a second for each.
+ * RELATIONS:
+ *    timeFrame()/timeCells()/timeDirect() - Time each way of drawing.
+ *
+ * IMPORTS:
+ *    argc  The number of command-line arguments.
+ *    argv  An array of pointers to chars where each represents the argument
+ *          string (argument vector).
+ *
+ * EXPORTS:
+ *          Exit status condition provided to the OS.
+ */
+
+int main( int argc, char* argv[] )
+{
+   static const int LENGTHS[2] = { SHORT_LINE, LONG_LINE };
+   long cells = BENCH_CELLS;
+   FrameBuffer* frame = constructFrame( BENCH_CANVAS, BENCH_CANVAS );
+   FILE* table = fdopen( dup( STDOUT_FILENO ), "w" );
+   Viewport view;
+   long lines;
+   int x2, y2;
+   int ii, jj;
+
+   if ( argc == 2 )
+   {
+      cells = atol( argv[1] );
+   }
+   view.left = 0;
+   view.top = 0;
+   view.width = BENCH_CANVAS;
+   view.height = BENCH_CANVAS;
+
+   if ( ( frame == NULL ) || ( table == NULL ) || ( freopen( "/dev/null", "w", stdout ) == NULL ) )
+   {
+      printf( "Error: can't allocate the framebuffer or send output to /dev/null\n" );
+   }
+   else
+   {
+      fprintf( table, "Mcells/s     (dx,dy)   frameSegment  a cell at a time  drawSegment\n" );
+      for ( jj = 0; jj < 2; jj++ )
+      {
+         lines = cells / ( LENGTHS[jj] + 1 ) + 1;
+         for ( ii = 0; ii < 10; ii++ )
+         {
+            x2 = BENCH_CENTRE + DIRECTIONS[ii][0] * LENGTHS[jj] / 2;
+            y2 = BENCH_CENTRE + DIRECTIONS[ii][1] * LENGTHS[jj] / 2;
+            fprintf( table, "len %-4d  (%2d,%2d)   %12.1f  %16.1f  %11.1f\n", LENGTHS[jj], DIRECTIONS[ii][0], DIRECTIONS[ii][1],
+                     lines * ( LENGTHS[jj] + 1 ) / timeFrame( frame, &view, x2, y2, lines ) / 1e6,
+                     lines * ( LENGTHS[jj] + 1 ) / timeCells( frame, &view, x2, y2, lines ) / 1e6,
+                     lines * ( LENGTHS[jj] + 1 ) / timeDirect( &view, x2, y2, lines ) / 1e6 );
+         }
+      }
+   }
+
+   if ( frame != NULL )
+   {
+      freeFrame( frame );
+   }
+   if ( table != NULL )
+   {
+      fclose( table );
+   }
+   return 0;
+}
+
+
+/* NAME: timeFrame()
+ * PURPOSE: Times drawing a line into the framebuffer, returning the seconds
+ *          taken.
+ * HOW IT WORKS: Clips the line from the centre and draws it with
+ *               frameSegment(), as many times as asked.
+ * RELATIONS:
+ *    main() - Times each line drawn into the framebuffer.
+ * IMPORTS:
+ *    frame - The framebuffer drawn into.
+ *    view - The whole canvas, clipped to.
+ *    x2/y2 - Cell the line ends on.
+ *    lines - The number of times to draw it.
+ * EXPORTS:
+ *    seconds - Processor time taken.
+ */
+
+static double timeFrame( FrameBuffer* frame, Viewport* view, int x2, int y2, long lines )
+{
+   Segment seg;
+   clock_t start = clock();
+   double seconds;
+   long ii;
+
+   for ( ii = 0; ii < lines; ii++ )
+   {
+      if ( clipLine( view, BENCH_CENTRE, BENCH_CENTRE, x2, y2, &seg ) != 0 )
+      {
+         frameSegment( frame, &seg, ( char )( '!' + ( ii & 63 ) ) );
+      }
+   }
+   seconds = ( double )( clock() - start ) / CLOCKS_PER_SEC;
+
+   return ( seconds > 0.0 ) ? seconds : 1.0 / CLOCKS_PER_SEC;
+}
+
+
+/* NAME: timeCells()
+ * PURPOSE: Times drawing a line into the framebuffer a cell at a time,
+ *          returning the seconds taken.
+ * HOW IT WORKS: Clips the line from the centre, then steps through its
+ *               cells as line() does, drawing each with frameSegment() as a
+ *               segment of a single cell, as many times as asked.
+ * RELATIONS:
+ *    main() - Times each line drawn a cell at a time.
+ * IMPORTS:
+ *    frame - The framebuffer drawn into.
+ *    view - The whole canvas, clipped to.
+ *    x2/y2 - Cell the line ends on.
+ *    lines - The number of times to draw it.
+ * EXPORTS:
+ *    seconds - Processor time taken.
+ */
+
+static double timeCells( FrameBuffer* frame, Viewport* view, int x2, int y2, long lines )
+{
+   Segment seg;
+   Segment cell;
+   clock_t start = clock();
+   double seconds;
+   int decision;
+   long ii;
+   int jj;
+
+   cell.count = 1;
+   cell.majorDelta = 0;
+   cell.minorDelta = 0;
+   cell.decision = 0;
+   cell.stepX = 1;
+   cell.stepY = 1;
+   cell.xIsMajor = -1;
+   for ( ii = 0; ii < lines; ii++ )
+   {
+      if ( clipLine( view, BENCH_CENTRE, BENCH_CENTRE, x2, y2, &seg ) != 0 )
+      {
+         cell.x = seg.x;
+         cell.y = seg.y;
+         decision = seg.decision;
+         for ( jj = 0; jj < seg.count; jj++ )
+         {
+            frameSegment( frame, &cell, ( char )( '!' + ( ii & 63 ) ) );
+            if ( seg.xIsMajor != 0 )
+            {
+               cell.x += seg.stepX;
+            }
+            else
+            {
+               cell.y += seg.stepY;
+            }
+            decision += seg.minorDelta;
+            if ( decision >= seg.majorDelta )
+            {
+               decision -= seg.majorDelta;
+               if ( seg.xIsMajor != 0 )
+               {
+                  cell.y += seg.stepY;
+               }
+               else
+               {
+                  cell.x += seg.stepX;
+               }
+            }
+         }
+      }
+   }
+   seconds = ( double )( clock() - start ) / CLOCKS_PER_SEC;
+
+   return ( seconds > 0.0 ) ? seconds : 1.0 / CLOCKS_PER_SEC;
+}
+
+
+/* NAME: timeDirect()
+ * PURPOSE: Times printing a line straight to the terminal, returning the
+ *          seconds taken.
+ * HOW IT WORKS: Clips the line from the centre and prints it with
+ *               drawSegment(), as many times as asked. Standard output goes
+ *               to /dev/null, so the time is that of forming the output.
+ * RELATIONS:
+ *    main() - Times each line printed as direct mode does.
+ * IMPORTS:
+ *    view - The whole canvas, clipped to.
+ *    x2/y2 - Cell the line ends on.
+ *    lines - The number of times to draw it.
+ * EXPORTS:
+ *    seconds - Processor time taken.
+ */
+
+static double timeDirect( Viewport* view, int x2, int y2, long lines )
+{
+   Segment seg;
+   clock_t start = clock();
+   double seconds;
+   long ii;
+
+   for ( ii = 0; ii < lines; ii++ )
+   {
+      if ( clipLine( view, BENCH_CENTRE, BENCH_CENTRE, x2, y2, &seg ) != 0 )
+      {
+         drawSegment( &seg, view, ( char )( '!' + ( ii & 63 ) ) );
+      }
+   }
+   fflush( stdout );
+   seconds = ( double )( clock() - start ) / CLOCKS_PER_SEC;
+
+   return ( seconds > 0.0 ) ? seconds : 1.0 / CLOCKS_PER_SEC;
+}
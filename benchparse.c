@@ -0,0 +1,213 @@
+/*
+ * FILE: benchparse.c
+ * AUTHOR: Kyle Notani | 19149918
+ * UNIT: UCP COMP1000
+ * PURPOSE: Time parseReal() and parseInteger() against copying each value
+ *          out and converting it with strtod() and strtol(), as values were
+ *          converted before the single-pass parser.
+ * COMMAND ARGUMENTS: Optionally the number of tokens, 2000000 if none.
+ * OTHER: Run by 'make bench'. Prints millions of tokens parsed a second.
+ *        '-1' evaluates to true, '0' evaluates to false.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "stringoperations.h"
+
+/* Tokens parsed unless given on the command line */
+#define BENCH_TOKENS 2000000
+
+/* Longest token written, with its space */
+#define TOKEN_LENGTH 8
+
+static double timeReal( Span* tokens, long count, int isCopied, double* sum );
+static double timeInteger( Span* tokens, long count, int isCopied, double* sum );
+
+
+/*
+ * NAME: main()
+ * PURPOSE: Entry point to the parse benchmark.
+ * HOW IT WORKS: - Writes reals like "12.345" and integers like "-1234"
+ *                 into one buffer, as a script's values sit in its text,
+ *                 and keeps a span of each.
+ *               - Times each parser over every span, and the copy and
+ *                 standard library conversion over the same spans.
+ *               - Sums the values parsed and prints the sums, so neither
+ *                 way can be optimised out and both are seen to agree.
+ * RELATIONS:
+ *    timeReal()/timeInteger() - Time each way of parsing.
+ *
+ * IMPORTS:
+ *    argc  The number of command-line arguments.
+ *    argv  An array of pointers to chars where each represents the argument
+ *          string (argument vector).
+ *
+ * EXPORTS:
+ *          Exit status condition provided to the OS.
+ */
+
+int main( int argc, char* argv[] )
+{
+   long count = BENCH_TOKENS;
+   char* text;
+   Span* reals;
+   Span* integers;
+   char* next;
+   double fastSum;
+   double copySum;
+   double seconds;
+   long ii;
+
+   if ( argc == 2 )
+   {
+      count = atol( argv[1] );
+   }
+   text = ( char* )malloc( ( size_t )count * TOKEN_LENGTH * 2 + 1 );
+   reals = ( Span* )malloc( ( size_t )count * sizeof( Span ) );
+   integers = ( Span* )malloc( ( size_t )count * sizeof( Span ) );
+
+   if ( ( count < 1 ) || ( text == NULL ) || ( reals == NULL ) || ( integers == NULL ) )
+   {
+      printf( "Error: can't allocate %ld tokens\n", count );
+   }
+   else
+   {
+      srand( 1 );
+      next = text;
+      for ( ii = 0; ii < count; ii++ )
+      {
+         reals[ii].start = next;
+         reals[ii].length = ( size_t )sprintf( next, "%d.%03d", rand() % 100, rand() % 1000 );
+         next += reals[ii].length + 1;
+         next[-1] = ' ';
+         integers[ii].start = next;
+         integers[ii].length = ( size_t )sprintf( next, "%d", ( rand() % 20000 ) - 10000 );
+         next += integers[ii].length + 1;
+         next[-1] = ' ';
+      }
+
+      seconds = timeReal( reals, count, 0, &fastSum );
+      printf( "parseReal           %7.1f Mtok/s\n", count / seconds / 1e6 );
+      seconds = timeReal( reals, count, -1, &copySum );
+      printf( "copy + strtod()     %7.1f Mtok/s  (sums %.3f, %.3f)\n", count / seconds / 1e6, fastSum, copySum );
+      seconds = timeInteger( integers, count, 0, &fastSum );
+      printf( "parseInteger        %7.1f Mtok/s\n", count / seconds / 1e6 );
+      seconds = timeInteger( integers, count, -1, &copySum );
+      printf( "copy + strtol()     %7.1f Mtok/s  (sums %.0f, %.0f)\n", count / seconds / 1e6, fastSum, copySum );
+   }
+
+   free( text );
+   free( reals );
+   free( integers );
+   return 0;
+}
+
+
+/* NAME: timeReal()
+ * PURPOSE: Times parsing every real, returning the seconds taken.
+ * HOW IT WORKS: Parses each span with parseReal(), or copies it into a
+ *               terminated buffer and converts it with strtod(), summing
+ *               the values. The fastest of three passes is taken.
+ * RELATIONS:
+ *    main() - Times both ways of parsing reals.
+ * IMPORTS:
+ *    tokens - Spans of the reals.
+ *    count - The number of reals.
+ *    isCopied - Whether to copy and use strtod() in place of parseReal().
+ *    sum - Set to the sum of the values.
+ * EXPORTS:
+ *    seconds - Processor time of the fastest pass.
+ */
+
+static double timeReal( Span* tokens, long count, int isCopied, double* sum )
+{
+   char copy[VALUE_LENGTH];
+   Span remainder;
+   double seconds = 0.0;
+   double taken;
+   clock_t start;
+   long ii;
+   int pass;
+
+   for ( pass = 0; pass < 3; pass++ )
+   {
+      *sum = 0.0;
+      start = clock();
+      for ( ii = 0; ii < count; ii++ )
+      {
+         if ( isCopied != 0 )
+         {
+            memcpy( copy, tokens[ii].start, tokens[ii].length );
+            copy[tokens[ii].length] = '\0';
+            *sum += strtod( copy, NULL );
+         }
+         else
+         {
+            *sum += parseReal( &tokens[ii], &remainder );
+         }
+      }
+      taken = ( double )( clock() - start ) / CLOCKS_PER_SEC;
+      if ( ( pass == 0 ) || ( taken < seconds ) )
+      {
+         seconds = taken;
+      }
+   }
+
+   return ( seconds > 0.0 ) ? seconds : 1.0 / CLOCKS_PER_SEC;
+}
+
+
+/* NAME: timeInteger()
+ * PURPOSE: Times parsing every integer, returning the seconds taken.
+ * HOW IT WORKS: As timeReal(), with parseInteger() and strtol().
+ * RELATIONS:
+ *    main() - Times both ways of parsing integers.
+ * IMPORTS:
+ *    tokens - Spans of the integers.
+ *    count - The number of integers.
+ *    isCopied - Whether to copy and use strtol() in place of
+ *               parseInteger().
+ *    sum - Set to the sum of the values.
+ * EXPORTS:
+ *    seconds - Processor time of the fastest pass.
+ */
+
+static double timeInteger( Span* tokens, long count, int isCopied, double* sum )
+{
+   char copy[VALUE_LENGTH];
+   Span remainder;
+   double seconds = 0.0;
+   double taken;
+   clock_t start;
+   long ii;
+   int pass;
+
+   for ( pass = 0; pass < 3; pass++ )
+   {
+      *sum = 0.0;
+      start = clock();
+      for ( ii = 0; ii < count; ii++ )
+      {
+         if ( isCopied != 0 )
+         {
+            memcpy( copy, tokens[ii].start, tokens[ii].length );
+            copy[tokens[ii].length] = '\0';
+            *sum += ( double )strtol( copy, NULL, 10 );
+         }
+         else
+         {
+            *sum += ( double )parseInteger( &tokens[ii], &remainder );
+         }
+      }
+      taken = ( double )( clock() - start ) / CLOCKS_PER_SEC;
+      if ( ( pass == 0 ) || ( taken < seconds ) )
+      {
+         seconds = taken;
+      }
+   }
+
+   return ( seconds > 0.0 ) ? seconds : 1.0 / CLOCKS_PER_SEC;
+}
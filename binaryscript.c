@@ -0,0 +1,402 @@
+/*
+ * FILE: binaryscript.c
+ * AUTHOR: Kyle Notani | 19149918
+ * UNIT: UCP COMP1000
+ * PURPOSE: Write validated commands to a compiled script, and run one again
+ *          with no parsing, only checking each command's values.
+ * FILE FORMATS: A BinaryHeader followed by the Command structs as they are
+ *               held in memory, so a mapped file is used as the command
+ *               array in place. A script only runs on machines with the same
+ *               byte order and Command layout as the one that compiled it.
+ * OTHER: '-1' evaluates to true, '0' evaluates to false.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <limits.h>
+
+#include "binaryscript.h"
+#include "structset.h"
+#include "validators.h"
+#include "report.h"
+
+/* Offset basis of 32 bit FNV-1a, the checksum of no commands */
+#define CHECKSUM_START 2166136261u
+
+static void normaliseCommand( Command* cmd, Command* record );
+static unsigned int addChecksum( unsigned int checksum, const Command* records, int count );
+static int checkRecord( const Command* records, int index, int count, Report* report );
+static int checkName( const char* name, Report* report );
+
+
+/* NAME: writeBinaryScript()
+ * PURPOSE: Writes the commands of an array to a compiled script, returning
+ *          whether it was written.
+ * HOW IT WORKS: - Writes the header with the checksum left out, then each
+ *                 command with normaliseCommand(), so the bytes written
+ *                 depend only on the commands.
+ *               - Fills in the checksum by writing the header again once
+ *                 every command is written.
+ * RELATIONS:
+ *    processFile() - Compiles a valid file in place of drawing it.
+ *    addChecksum() - Sums each command written.
+ * IMPORTS:
+ *    array - The valid commands, in order.
+ *    filename - Name of the file to create or replace.
+ * EXPORTS:
+ *    isWritten - Boolean evaluating to '0' (FALSE) if the file could not be
+ *                written, or '-1' (TRUE) otherwise.
+ */
+
+int writeBinaryScript( CommandArray* array, char* filename )
+{
+   int isWritten = 0;
+   FILE* file = fopen( filename, "wb" );
+   BinaryHeader header;
+   Command record;
+   int ii;
+
+   if ( file != NULL )
+   {
+      memcpy( header.magic, BINARY_MAGIC, sizeof( header.magic ) );
+      header.version = BINARY_VERSION;
+      header.byteOrder = BINARY_BYTE_ORDER;
+      header.recordSize = ( unsigned int )sizeof( Command );
+      header.count = ( unsigned int )array->count;
+      header.checksum = 0;
+      fwrite( &header, sizeof( BinaryHeader ), 1, file );
+
+      header.checksum = CHECKSUM_START;
+      for ( ii = 0; ii < array->count; ii++ )
+      {
+         normaliseCommand( &( array->commands[ii] ), &record );
+         header.checksum = addChecksum( header.checksum, &record, 1 );
+         fwrite( &record, sizeof( Command ), 1, file );
+      }
+
+      rewind( file );
+      fwrite( &header, sizeof( BinaryHeader ), 1, file );
+
+      if ( ferror( file ) == 0 )
+      {
+         isWritten = -1;
+      }
+      if ( fclose( file ) != 0 )
+      {
+         isWritten = 0;
+      }
+   }
+
+   return isWritten;
+}
+
+
+/* NAME: isBinaryScript()
+ * PURPOSE: Checks if a file's text starts as a compiled script does.
+ * HOW IT WORKS: Compares the start of the text with BINARY_MAGIC, which no
+ *               text script can start with as no command name starts with a
+ *               'T'.
+ * RELATIONS:
+ *    processFile() - Tells a compiled script from a text one.
+ * IMPORTS:
+ *    text - The whole text of the file.
+ * EXPORTS:
+ *    isBinary - Boolean evaluating to '-1' (TRUE) if the file is a compiled
+ *               script, or '0' (FALSE) otherwise.
+ */
+
+int isBinaryScript( Span* text )
+{
+   int isBinary = 0;
+
+   if ( ( text->length >= sizeof( BinaryHeader ) ) &&
+        ( memcmp( text->start, BINARY_MAGIC, strlen( BINARY_MAGIC ) ) == 0 ) )
+   {
+      isBinary = -1;
+   }
+
+   return isBinary;
+}
+
+
+/* NAME: readBinaryScript()
+ * PURPOSE: Points an array at the commands of a compiled script in place,
+ *          returning whether the script is whole, valid and was compiled
+ *          for this machine and version.
+ * HOW IT WORKS: - Checks the header's version, byte order and Command size,
+ *                 and that the file holds exactly its count of commands.
+ *               - Sums the commands with addChecksum() to check none were
+ *                 damaged.
+ *               - Checks each command with checkRecord(), as a checksum
+ *                 only shows the file wasn't changed by accident. Checking
+ *                 stops at the first invalid command.
+ *               - The array then points straight into the text. Nothing is
+ *                 copied, so the text must stay loaded while the array is
+ *                 used, and the array must not be freed or grown.
+ * RELATIONS:
+ *    processFile() - Runs a compiled script with no parsing.
+ *    checkRecord() - Checks each command's opcode and value.
+ * IMPORTS:
+ *    text - The whole text of the file, starting as a compiled script.
+ *    array - Set to the commands of the script.
+ *    report - Collects the error messages of an invalid command.
+ * EXPORTS:
+ *    isRead - Boolean evaluating to '0' (FALSE) if the script is damaged,
+ *             invalid or not for this machine or version, or '-1' (TRUE)
+ *             otherwise.
+ */
+
+int readBinaryScript( Span* text, CommandArray* array, Report* report )
+{
+   int isRead = 0;
+   BinaryHeader header;
+   const Command* records = ( const Command* )( text->start + sizeof( BinaryHeader ) );
+   int ii;
+
+   memcpy( &header, text->start, sizeof( BinaryHeader ) );
+
+   if ( ( header.version == BINARY_VERSION ) && ( header.byteOrder == BINARY_BYTE_ORDER ) &&
+        ( header.recordSize == sizeof( Command ) ) && ( header.count <= INT_MAX ) &&
+        ( text->length - sizeof( BinaryHeader ) == ( size_t )header.count * sizeof( Command ) ) &&
+        ( addChecksum( CHECKSUM_START, records, ( int )header.count ) == header.checksum ) )
+   {
+      isRead = -1;
+      for ( ii = 0; ( ii < ( int )header.count ) && ( isRead != 0 ); ii++ )
+      {
+         isRead = checkRecord( records, ii, ( int )header.count, report );
+      }
+   }
+
+   if ( isRead != 0 )
+   {
+      array->commands = ( Command* )records;
+      array->count = ( int )header.count;
+      array->capacity = ( int )header.count;
+   }
+
+   return isRead;
+}
+
+
+/* NAME: checkRecord()
+ * PURPOSE: Checks a command of a compiled script as a text script's line is
+ *          checked, returning whether it is valid.
+ * HOW IT WORKS: - The opcode must be one of the commands, and its value
+ *                 within the same limits validators.c gives a text script,
+ *                 checked by the same range validators.
+ *               - A pattern must be printable, and a name an upper case
+ *                 letter followed by upper case letters, digits and
+ *                 underscores, padded with '\0'.
+ *               - A REPEAT or PROC must jump forward to just past a ], and
+ *                 a CALL back to just past a PROC, as compileBlocks()
+ *                 links them.
+ * RELATIONS:
+ *    readBinaryScript() - Checks each command read.
+ *    validateDrawRange()/validateMoveRange()/validateRotateRange()/
+ *    validateFgRange()/validateBgRange()/validateRepeatRange() - Check
+ *                                                                 values.
+ *    checkName() - Checks procedure names.
+ * IMPORTS:
+ *    records - The commands of the script.
+ *    index - Index of the command checked.
+ *    count - The number of commands.
+ *    report - Collects the error messages of an invalid command.
+ * EXPORTS:
+ *    isValid - Boolean evaluating to '0' (FALSE) if the command is not
+ *              valid, or '-1' (TRUE) otherwise.
+ */
+
+static int checkRecord( const Command* records, int index, int count, Report* report )
+{
+   int isValid = 0;
+   int isInRange = -1;
+   const Command* record = &records[index];
+   int jump = record->jump;
+   Operand value;
+
+   value.real = record->value.real;
+   value.integer = record->value.integer;
+
+   switch ( record->opcode )
+   {
+      case OP_DRAW:
+         isValid = validateDrawRange( &value, report );
+         break;
+      case OP_MOVE:
+         isValid = validateMoveRange( &value, report );
+         break;
+      case OP_ROTATE:
+         isValid = validateRotateRange( &value, report );
+         break;
+      case OP_FG:
+         isValid = validateFgRange( &value, report );
+         break;
+      case OP_BG:
+         isValid = validateBgRange( &value, report );
+         break;
+      case OP_PATTERN:
+         isValid = ( isprint( ( unsigned char )record->value.pattern ) != 0 ) ? -1 : 0;
+         if ( isValid == 0 )
+         {
+            addMessage( report, "Error: character data type expected\n" );
+         }
+         break;
+      case OP_REPEAT:
+         isValid = validateRepeatRange( &value, report );
+         isInRange = ( jump > index + 1 ) && ( jump <= count ) && ( records[jump - 1].opcode == OP_END );
+         break;
+      case OP_PROC:
+         isValid = checkName( record->value.name, report );
+         isInRange = ( jump > index + 1 ) && ( jump <= count ) && ( records[jump - 1].opcode == OP_END );
+         break;
+      case OP_CALL:
+         isValid = checkName( record->value.name, report );
+         isInRange = ( jump > 0 ) && ( jump <= index ) && ( records[jump - 1].opcode == OP_PROC );
+         break;
+      case OP_END:
+         isValid = -1;
+         break;
+      default:
+         addMessage( report, "Error: Command %d. command unidentified\n\n", index + 1 );
+         break;
+   }
+
+   if ( ( isValid == 0 ) && ( record->opcode >= OP_DRAW ) && ( record->opcode <= OP_END ) )
+   {
+      addMessage( report, "       Command %d. incorrect value for command\n\n", index + 1 );
+   }
+   else if ( ( isValid != 0 ) && ( isInRange == 0 ) )
+   {
+      isValid = 0;
+      addMessage( report, "Error: Command %d. block jumps to the wrong command\n\n", index + 1 );
+   }
+
+   return isValid;
+}
+
+
+/* NAME: checkName()
+ * PURPOSE: Checks a procedure name of a compiled script, returning whether
+ *          it is one a text script could hold.
+ * HOW IT WORKS: Names are kept upper case and padded with '\0' (see
+ *               parseCommand()), so the first character must be an upper
+ *               case letter, then only upper case letters, digits and
+ *               underscores up to the padding, and nothing but '\0' after.
+ * RELATIONS:
+ *    checkRecord() - Checks the name of each PROC and CALL.
+ * IMPORTS:
+ *    name - The PROC_NAME_LENGTH characters of the name.
+ *    report - Collects the error message of an invalid name.
+ * EXPORTS:
+ *    isValid - Boolean evaluating to '0' (FALSE) if the name is not valid,
+ *              or '-1' (TRUE) otherwise.
+ */
+
+static int checkName( const char* name, Report* report )
+{
+   int isValid = ( isupper( ( unsigned char )name[0] ) != 0 ) ? -1 : 0;
+   int isPadding = 0;
+   unsigned char character;
+   int ii;
+
+   for ( ii = 1; ( ii < PROC_NAME_LENGTH ) && ( isValid != 0 ); ii++ )
+   {
+      character = ( unsigned char )name[ii];
+      if ( character == '\0' )
+      {
+         isPadding = -1;
+      }
+      else if ( ( isPadding != 0 ) ||
+                ( ( isupper( character ) == 0 ) && ( isdigit( character ) == 0 ) && ( character != '_' ) ) )
+      {
+         isValid = 0;
+      }
+   }
+
+   if ( isValid == 0 )
+   {
+      addMessage( report, "Error: procedure name expected\n" );
+   }
+
+   return isValid;
+}
+
+
+/* NAME: normaliseCommand()
+ * PURPOSE: Copies a command with every byte not holding its value zeroed.
+ * HOW IT WORKS: Zeroes the record, then copies the opcode and only the
+ *               member of the value the opcode uses, so padding and unused
+ *               bytes of the union are always the same. Only REPEAT, PROC
+ *               and CALL keep their jump, the rest holding a line number.
+ * RELATIONS:
+ *    writeBinaryScript() - Writes each command normalised.
+ * IMPORTS:
+ *    cmd - The command to copy.
+ *    record - Set to the normalised copy.
+ * EXPORTS:
+ *    none
+ */
+
+static void normaliseCommand( Command* cmd, Command* record )
+{
+   memset( record, 0, sizeof( Command ) );
+   record->opcode = cmd->opcode;
+
+   switch ( cmd->opcode )
+   {
+      case OP_FG:
+      case OP_BG:
+         record->value.integer = cmd->value.integer;
+         break;
+      case OP_PATTERN:
+         record->value.pattern = cmd->value.pattern;
+         break;
+      case OP_REPEAT:
+         record->value.integer = cmd->value.integer;
+         record->jump = cmd->jump;
+         break;
+      case OP_PROC:
+      case OP_CALL:
+         memcpy( record->value.name, cmd->value.name, PROC_NAME_LENGTH );
+         record->jump = cmd->jump;
+         break;
+      case OP_END:
+         break;
+      default:
+         record->value.real = cmd->value.real;
+         break;
+   }
+}
+
+
+/* NAME: addChecksum()
+ * PURPOSE: Adds commands to a running checksum.
+ * HOW IT WORKS: FNV-1a taken an unsigned int at a time rather than a byte
+ *               at a time, as the commands are always aligned and whole
+ *               words long, so a few million commands sum in milliseconds.
+ * RELATIONS:
+ *    writeBinaryScript() - Sums each command written.
+ *    readBinaryScript() - Sums the commands read to compare.
+ * IMPORTS:
+ *    checksum - The sum so far, CHECKSUM_START to start.
+ *    records - The commands to add.
+ *    count - The number of commands.
+ * EXPORTS:
+ *    checksum - The sum with the commands added.
+ */
+
+static unsigned int addChecksum( unsigned int checksum, const Command* records, int count )
+{
+   const unsigned int* word = ( const unsigned int* )records;
+   size_t words = ( size_t )count * ( sizeof( Command ) / sizeof( unsigned int ) );
+   size_t ii;
+
+   for ( ii = 0; ii < words; ii++ )
+   {
+      checksum = ( checksum ^ word[ii] ) * 16777619u;
+   }
+
+   return checksum;
+}
@@ -0,0 +1,51 @@
+/* FILE: binaryscript.h
+ * AUTHOR: Kyle Notani | 19149918
+ * UNIT: UCP COMP1000
+ * PURPOSE: Header file associated with binaryscript.c
+ */
+
+#ifndef BINARYSCRIPT_H
+   #define BINARYSCRIPT_H
+
+   #include "commandarray.h"
+   #include "stringoperations.h"
+   #include "report.h"
+
+   /* First bytes of every compiled script */
+   #define BINARY_MAGIC "TGB\n"
+
+   /* Version of the layout written, raised whenever Command changes */
+   #define BINARY_VERSION 2
+
+   /* Written in the machine's own byte order, to tell a compiled script
+    * from a machine of the other byte order */
+   #define BINARY_BYTE_ORDER 0x01020304
+
+   /* Starts a compiled script, followed straight after by count Command
+    * structs exactly as they are held in memory. 24 bytes, keeping the
+    * commands aligned for a double. */
+   typedef struct
+   {
+      char magic[4];
+      unsigned int version;
+      unsigned int byteOrder;
+      /* sizeof( Command ) on the machine that compiled the script */
+      unsigned int recordSize;
+      unsigned int count;
+      /* FNV-1a over the commands, a word at a time */
+      unsigned int checksum;
+   } BinaryHeader;
+
+   /* Writes the commands of an array to a compiled script, returning whether
+    * it was written. */
+   int writeBinaryScript( CommandArray* array, char* filename );
+
+   /* Checks if a file's text starts as a compiled script does. */
+   int isBinaryScript( Span* text );
+
+   /* Points an array at the commands of a compiled script in place,
+    * returning whether the script is whole, valid and was compiled for
+    * this machine and version, adding any error messages to the report. */
+   int readBinaryScript( Span* text, CommandArray* array, Report* report );
+
+#endif
@@ -0,0 +1,417 @@
+/*
+ * FILE: bytecode.c
+ * AUTHOR: Kyle Notani | 19149918
+ * UNIT: UCP COMP1000
+ * PURPOSE: Compile the REPEAT blocks and procedures of a validated script
+ *          into jumps between its commands, and run the compiled script a
+ *          command at a time without unrolling it.
+ * OTHER: A script is its own bytecode. Each command keeps its place in the
+ *        array, and compiling only fills in where REPEAT, PROC and CALL
+ *        jump to, so a script's size is that of its text however much it
+ *        draws.
+ *        A procedure is called by name after its definition, so it can't
+ *        call itself, and every script runs to an end.
+ *        '-1' evaluates to true, '0' evaluates to false.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bytecode.h"
+#include "commandarray.h"
+#include "structset.h"
+#include "report.h"
+
+static int findProcedure( Procedure* procedures, int count, char* name );
+static int addProcedure( Procedure** procedures, int* count, int* capacity, Procedure* procedure );
+
+
+/* NAME: compileBlocks()
+ * PURPOSE: Links each block of a validated script to where it jumps,
+ *          adding any error messages to the report. Returns whether the
+ *          blocks were valid.
+ * HOW IT WORKS: - Goes through the commands once, keeping a stack of the
+ *                 blocks opened and not yet closed. Until linked, each
+ *                 command's jump holds its line number for the messages.
+ *               - At each ], the block on top is closed and its REPEAT or
+ *                 PROC jumps to the command after the ]. A closed PROC is
+ *                 added to the table of procedures.
+ *               - A CALL jumps to the first command of its procedure,
+ *                 which must already be in the table.
+ *               - Counts the frames each point of the script needs to run,
+ *                 one per block open and the most any procedure called
+ *                 needs, so no script runs deeper than MAX_NESTING.
+ *               - Compiling stops at the first error, since the blocks
+ *                 after it can't be matched up reliably. Blocks left open
+ *                 at the end are each reported.
+ * RELATIONS:
+ *    processFile() - Compiles a file once every line is valid.
+ *    findProcedure()/addProcedure() - Look up and add procedures.
+ * IMPORTS:
+ *    array - The valid commands, in order, linked in place.
+ *    report - Collects the error messages of invalid blocks.
+ * EXPORTS:
+ *    isValid - Boolean evaluating to '0' (FALSE) if any block was not
+ *              valid, or '-1' (TRUE) otherwise.
+ */
+
+int compileBlocks( CommandArray* array, Report* report )
+{
+   int isValid = -1;
+   int ii = 0;
+   int line = 0;
+   int frames = 0;
+   int found = -1;
+
+   /* blocks open, innermost last, and the line each opened on */
+   int open[MAX_NESTING];
+   int openLine[MAX_NESTING];
+   int depth = 0;
+
+   /* procedures defined, and the one being defined */
+   Procedure* procedures = NULL;
+   int procCount = 0;
+   int procCapacity = 0;
+   Procedure defining;
+
+   Command* commands = array->commands;
+
+   defining.at = -1;
+   defining.frames = 0;
+
+   for ( ii = 0; ( ii < array->count ) && ( isValid != 0 ); ii++ )
+   {
+      line = commands[ii].jump;
+      frames = 0;
+      switch ( commands[ii].opcode )
+      {
+         case OP_REPEAT:
+            frames = depth + 1;
+            break;
+         case OP_PROC:
+            if ( depth > 0 )
+            {
+               isValid = 0;
+               addMessage( report, "Error: Line %d. PROC can't be inside another block\n\n", line );
+            }
+            else if ( findProcedure( procedures, procCount, commands[ii].value.name ) >= 0 )
+            {
+               isValid = 0;
+               addMessage( report, "Error: Line %d. procedure %.*s is already defined\n\n", line,
+                           PROC_NAME_LENGTH, commands[ii].value.name );
+            }
+            else
+            {
+               memcpy( defining.name, commands[ii].value.name, PROC_NAME_LENGTH );
+               defining.at = ii;
+               defining.frames = 1;
+            }
+            break;
+         case OP_CALL:
+            found = findProcedure( procedures, procCount, commands[ii].value.name );
+            if ( found < 0 )
+            {
+               isValid = 0;
+               addMessage( report, "Error: Line %d. procedure %.*s must be defined before it is called\n\n", line,
+                           PROC_NAME_LENGTH, commands[ii].value.name );
+            }
+            else
+            {
+               commands[ii].jump = procedures[found].at + 1;
+               frames = depth + procedures[found].frames;
+            }
+            break;
+         case OP_END:
+            if ( depth == 0 )
+            {
+               isValid = 0;
+               addMessage( report, "Error: Line %d. ] has no block to close\n\n", line );
+            }
+            else
+            {
+               depth--;
+               commands[open[depth]].jump = ii + 1;
+               if ( commands[open[depth]].opcode == OP_PROC )
+               {
+                  if ( addProcedure( &procedures, &procCount, &procCapacity, &defining ) == 0 )
+                  {
+                     isValid = 0;
+                     addMessage( report, "Error: Line %d. procedure could not be stored\n\n", openLine[depth] );
+                  }
+                  defining.at = -1;
+               }
+            }
+            break;
+         default:
+            break;
+      }
+
+      /* Check the frames needed, then open any block */
+      if ( frames > MAX_NESTING )
+      {
+         isValid = 0;
+         addMessage( report, "Error: Line %d. blocks and calls nested more than %d deep\n\n", line, MAX_NESTING );
+      }
+      else if ( isValid != 0 )
+      {
+         if ( ( defining.at >= 0 ) && ( frames > defining.frames ) )
+         {
+            defining.frames = frames;
+         }
+         if ( ( commands[ii].opcode == OP_REPEAT ) || ( commands[ii].opcode == OP_PROC ) )
+         {
+            open[depth] = ii;
+            openLine[depth] = line;
+            depth++;
+         }
+      }
+   }
+
+   if ( isValid != 0 )
+   {
+      for ( ii = 0; ii < depth; ii++ )
+      {
+         isValid = 0;
+         addMessage( report, "Error: Line %d. block is never closed with ]\n\n", openLine[ii] );
+      }
+   }
+
+   free( procedures );
+
+   return isValid;
+}
+
+
+/* NAME: findProcedure()
+ * PURPOSE: Finds a procedure by name, returning its index in the table.
+ * HOW IT WORKS: Compares the name with each procedure's in turn. Names are
+ *               kept upper case and padded, so are compared whole.
+ * RELATIONS:
+ *    compileBlocks() - Looks up each procedure defined or called.
+ * IMPORTS:
+ *    procedures - The table of procedures defined so far.
+ *    count - The number of procedures in the table.
+ *    name - The name to find.
+ * EXPORTS:
+ *    index - The index of the procedure, or -1 if not found.
+ */
+
+static int findProcedure( Procedure* procedures, int count, char* name )
+{
+   int index = -1;
+   int ii = 0;
+
+   for ( ii = 0; ( ii < count ) && ( index < 0 ); ii++ )
+   {
+      if ( memcmp( procedures[ii].name, name, PROC_NAME_LENGTH ) == 0 )
+      {
+         index = ii;
+      }
+   }
+
+   return index;
+}
+
+
+/* NAME: addProcedure()
+ * PURPOSE: Adds a procedure to the table, returning whether it was added.
+ * HOW IT WORKS: Doubles the table's capacity with realloc() whenever it is
+ *               full, starting from INITIAL_PROCEDURES.
+ * RELATIONS:
+ *    compileBlocks() - Adds each procedure once its ] is reached.
+ * IMPORTS:
+ *    procedures - Points to the table, NULL until the first is added.
+ *    count/capacity - The procedures in the table and its room for them.
+ *    procedure - The procedure to add.
+ * EXPORTS:
+ *    isAdded - Boolean evaluating to '0' (FALSE) if there was no memory
+ *              for it, or '-1' (TRUE) otherwise.
+ */
+
+static int addProcedure( Procedure** procedures, int* count, int* capacity, Procedure* procedure )
+{
+   int isAdded = -1;
+   int grown = ( *capacity == 0 ) ? INITIAL_PROCEDURES : *capacity * 2;
+   Procedure* table = NULL;
+
+   if ( *count == *capacity )
+   {
+      table = ( Procedure* )realloc( *procedures, grown * sizeof( Procedure ) );
+      if ( table == NULL )
+      {
+         isAdded = 0;
+      }
+      else
+      {
+         *procedures = table;
+         *capacity = grown;
+      }
+   }
+
+   if ( isAdded != 0 )
+   {
+      ( *procedures )[*count] = *procedure;
+      ( *count )++;
+   }
+
+   return isAdded;
+}
+
+
+/* NAME: hasBlocks()
+ * PURPOSE: Checks if a script has any REPEAT, PROC, CALL or ].
+ * HOW IT WORKS: Looks through the opcodes, stopping at the first found.
+ * RELATIONS:
+ *    optimiseScript() - Only optimises scripts run straight through.
+ * IMPORTS:
+ *    array - The commands of the script.
+ * EXPORTS:
+ *    isFound - Boolean evaluating to '-1' (TRUE) if any is found, or '0'
+ *              (FALSE) otherwise.
+ */
+
+int hasBlocks( CommandArray* array )
+{
+   int isFound = 0;
+   int ii = 0;
+
+   for ( ii = 0; ( ii < array->count ) && ( isFound == 0 ); ii++ )
+   {
+      if ( array->commands[ii].opcode >= OP_REPEAT )
+      {
+         isFound = -1;
+      }
+   }
+
+   return isFound;
+}
+
+
+/* NAME: startRunner()
+ * PURPOSE: Starts running a compiled script from its first command.
+ * HOW IT WORKS: Points at the first command with no frames running.
+ * RELATIONS:
+ *    draw() - Runs the commands of an array.
+ *    findOverdraw() - Traces the lines the commands draw.
+ * IMPORTS:
+ *    runner - The runner to start.
+ * EXPORTS:
+ *    none
+ */
+
+void startRunner( Runner* runner )
+{
+   runner->next = 0;
+   runner->depth = 0;
+}
+
+
+/* NAME: nextCommand()
+ * PURPOSE: Runs the script on to the next DRAW, MOVE, ROTATE, FG, BG or
+ *          PATTERN, returning it, or NULL once the script ends.
+ * HOW IT WORKS: - A REPEAT pushes a frame looping back to its first
+ *                 command, or jumps past its ] if it runs no times.
+ *               - A PROC reached in order jumps past its body, which only
+ *                 runs when called.
+ *               - A CALL pushes a frame returning to the command after it,
+ *                 then jumps to the procedure.
+ *               - A ] loops back while its REPEAT has times left to run, or
+ *                 pops the frame, returning from a call.
+ *               - Compiled scripts loaded from a file aren't compiled again,
+ *                 so a jump out of the script or past MAX_NESTING frames
+ *                 ends it, as does a REPEAT or PROC jumping backwards.
+ * RELATIONS:
+ *    draw() - Runs each command in turn.
+ *    findOverdraw() - Traces the lines drawn in the same order.
+ * IMPORTS:
+ *    runner - Where the script is up to, moved on past the command.
+ *    array - The compiled script.
+ * EXPORTS:
+ *    command - The next command to run, or NULL at the end.
+ */
+
+Command* nextCommand( Runner* runner, CommandArray* array )
+{
+   Command* command = NULL;
+   Command* at = NULL;
+   Frame* frame = NULL;
+
+   while ( ( command == NULL ) && ( runner->next < array->count ) )
+   {
+      at = &( array->commands[runner->next] );
+      runner->next++;
+      switch ( at->opcode )
+      {
+         case OP_REPEAT:
+            if ( ( at->jump < runner->next ) || ( at->jump > array->count ) || ( runner->depth == MAX_NESTING ) )
+            {
+               runner->next = array->count;
+            }
+            else if ( at->value.integer <= 0 )
+            {
+               runner->next = at->jump;
+            }
+            else
+            {
+               frame = &( runner->frames[runner->depth] );
+               frame->at = runner->next;
+               frame->remaining = at->value.integer;
+               runner->depth++;
+            }
+            break;
+         case OP_PROC:
+            if ( ( at->jump < runner->next ) || ( at->jump > array->count ) )
+            {
+               runner->next = array->count;
+            }
+            else
+            {
+               runner->next = at->jump;
+            }
+            break;
+         case OP_CALL:
+            if ( ( at->jump < 0 ) || ( at->jump > array->count ) || ( runner->depth == MAX_NESTING ) )
+            {
+               runner->next = array->count;
+            }
+            else
+            {
+               frame = &( runner->frames[runner->depth] );
+               frame->at = runner->next;
+               frame->remaining = -1;
+               runner->depth++;
+               runner->next = at->jump;
+            }
+            break;
+         case OP_END:
+            if ( runner->depth == 0 )
+            {
+               runner->next = array->count;
+            }
+            else
+            {
+               frame = &( runner->frames[runner->depth - 1] );
+               if ( frame->remaining > 1 )
+               {
+                  frame->remaining--;
+                  runner->next = frame->at;
+               }
+               else
+               {
+                  if ( frame->remaining < 0 )
+                  {
+                     runner->next = frame->at;
+                  }
+                  runner->depth--;
+               }
+            }
+            break;
+         default:
+            command = at;
+            break;
+      }
+   }
+
+   return command;
+}
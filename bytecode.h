@@ -0,0 +1,65 @@
+/* FILE: bytecode.h
+ * AUTHOR: Kyle Notani | 19149918
+ * UNIT: UCP COMP1000
+ * PURPOSE: Header file associated with bytecode.c
+ */
+
+#ifndef BYTECODE_H
+   #define BYTECODE_H
+
+   #include "commandarray.h"
+   #include "structset.h"
+   #include "report.h"
+
+   /* Most REPEAT blocks and procedure calls running inside one another */
+   #define MAX_NESTING 64
+
+   /* Number of procedures the table of procedures initially has room for */
+   #define INITIAL_PROCEDURES 16
+
+   /* Stores a procedure while compiling, once its ] is reached */
+   typedef struct
+   {
+      char name[PROC_NAME_LENGTH];
+      /* Index of its PROC */
+      int at;
+      /* Most frames its body needs at once, calls included */
+      int frames;
+   } Procedure;
+
+   /* Stores a REPEAT block or procedure call being run */
+   typedef struct
+   {
+      /* Index the block loops back to, or the call returns to */
+      int at;
+      /* Times the block is still to run, -1 for a call */
+      int remaining;
+   } Frame;
+
+   /* Stores where a compiled script is up to as it runs */
+   typedef struct
+   {
+      /* Index of the next command */
+      int next;
+      /* Frames running, innermost last */
+      int depth;
+      Frame frames[MAX_NESTING];
+   } Runner;
+
+   /* Links each block of a validated script to where it jumps, adding any
+    * error messages to the report. Returns whether the blocks were valid.
+    */
+   int compileBlocks( CommandArray* array, Report* report );
+
+   /* Checks if a script has any REPEAT, PROC, CALL or ]. */
+   int hasBlocks( CommandArray* array );
+
+   /* Starts running a compiled script from its first command. */
+   void startRunner( Runner* runner );
+
+   /* Runs the script on to the next DRAW, MOVE, ROTATE, FG, BG or PATTERN,
+    * returning it, or NULL once the script ends.
+    */
+   Command* nextCommand( Runner* runner, CommandArray* array );
+
+#endif
@@ -0,0 +1,457 @@
+/*
+ * FILE: chunks.c
+ * AUTHOR: Kyle Notani | 19149918
+ * UNIT: UCP COMP1000
+ * PURPOSE: Validate the lines of a script in chunks, each on its own thread,
+ *          merging the commands and error messages of the chunks back in
+ *          line order.
+ * OTHER: A chunk only ever touches its own lines, command array and report
+ *        while its thread runs, so the threads share nothing but the
+ *        script's text, which is only read.
+ *        '-1' evaluates to true, '0' evaluates to false.
+ */
+
+#define _POSIX_C_SOURCE 199506L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "chunks.h"
+#include "readinput.h"
+#include "validators.h"
+#include "arrayoperations.h"
+
+static int splitChunks( Span* text, int threads, Chunk* chunks );
+static void runChunks( Chunk* chunks, int count, void* ( *work )( void* ) );
+static void* countChunkLines( void* data );
+static void* validateChunk( void* data );
+
+
+/* NAME: validateScript()
+ * PURPOSE: Validates every line of a script, storing each valid command in
+ *          the array and each error message in the report, in line order.
+ *          Returns whether any line was invalid.
+ * HOW IT WORKS: - Splits the script into one chunk of whole lines per
+ *                 thread with splitChunks(). A threads count of 0 or less
+ *                 uses every processor online.
+ *               - Counts the lines of every chunk at once, so each chunk
+ *                 knows the number of its first line, then validates every
+ *                 chunk at once.
+ *               - The first chunk stores straight into the array. Every
+ *                 other chunk stores into an array of its own, appended in
+ *                 order once all are validated, along with the reports.
+ * RELATIONS:
+ *    processFile() - Validates the file once loaded.
+ *    runChunks() - Runs a step on every chunk at once.
+ *    appendArray()/appendReport() - Merge the chunks in line order.
+ * IMPORTS:
+ *    text - The whole text of the script.
+ *    threads - Most threads to validate on, 0 for one per processor.
+ *    array - The command array to store the valid commands in.
+ *    report - The report to add every error message to.
+ *    cmdsRead - Set to the number of valid commands stored.
+ * EXPORTS:
+ *    isInvalid - Boolean evaluating to '-1' (TRUE) if any line was not valid,
+ *                or '0' (FALSE) otherwise.
+ */
+
+int validateScript( Span* text, int threads, CommandArray* array, Report* report, int* cmdsRead )
+{
+   int isInvalid = 0;
+   Chunk chunks[MAX_THREADS];
+   int count;
+   int firstLine = 0;
+   int ii;
+
+   if ( threads <= 0 )
+   {
+      threads = ( int )sysconf( _SC_NPROCESSORS_ONLN );
+   }
+   count = splitChunks( text, threads, chunks );
+
+   /* Give every chunk but the first its own array, or give up on splitting
+    * should one not be constructed */
+   chunks[0].array = array;
+   for ( ii = 1; ii < count; ii++ )
+   {
+      chunks[ii].array = constructArray();
+      if ( chunks[ii].array == NULL )
+      {
+         while ( ii > 1 )
+         {
+            ii--;
+            freeArray( chunks[ii].array );
+         }
+         chunks[0].text = *text;
+         count = 1;
+      }
+   }
+
+   if ( count > 1 )
+   {
+      runChunks( chunks, count, &countChunkLines );
+   }
+   for ( ii = 0; ii < count; ii++ )
+   {
+      chunks[ii].firstLine = firstLine;
+      firstLine += chunks[ii].lineCount;
+   }
+   runChunks( chunks, count, &validateChunk );
+
+   *cmdsRead = 0;
+   for ( ii = 0; ii < count; ii++ )
+   {
+      if ( ( ii > 0 ) && ( appendArray( array, chunks[ii].array ) == 0 ) )
+      {
+         chunks[ii].isInvalid = -1;
+         addMessage( &( chunks[ii].report ), "Error: commands from line %d could not be stored\n\n",
+                     chunks[ii].firstLine + 1 );
+      }
+      else
+      {
+         *cmdsRead += chunks[ii].cmdsRead;
+      }
+      if ( ii > 0 )
+      {
+         freeArray( chunks[ii].array );
+      }
+      if ( chunks[ii].isInvalid != 0 )
+      {
+         isInvalid = -1;
+      }
+      appendReport( report, &( chunks[ii].report ) );
+   }
+
+   return isInvalid;
+}
+
+
+/* NAME: splitChunks()
+ * PURPOSE: Splits a script into chunks of whole lines, one per thread.
+ * HOW IT WORKS: - Takes one chunk per MIN_CHUNK_LENGTH bytes, up to the
+ *                 number of threads and MAX_THREADS, and at least one.
+ *               - Each chunk ends at the first new line at or after its
+ *                 share of the script, found with memchr(), so the chunks
+ *                 are near even in length and no line is split. A line
+ *                 spanning several shares leaves the chunks after it empty.
+ * RELATIONS:
+ *    validateScript() - Splits the script before validating it.
+ * IMPORTS:
+ *    text - The whole text of the script.
+ *    threads - Most chunks to split into.
+ *    chunks - Array of MAX_THREADS chunks to set up.
+ * EXPORTS:
+ *    count - The number of chunks set up.
+ */
+
+static int splitChunks( Span* text, int threads, Chunk* chunks )
+{
+   int count = ( int )( text->length / MIN_CHUNK_LENGTH );
+   const char* start = text->start;
+   const char* end = text->start + text->length;
+   const char* share;
+   const char* newline;
+   int ii;
+
+   if ( count > threads )
+   {
+      count = threads;
+   }
+   if ( count > MAX_THREADS )
+   {
+      count = MAX_THREADS;
+   }
+   if ( count < 1 )
+   {
+      count = 1;
+   }
+
+   for ( ii = 0; ii < count; ii++ )
+   {
+      chunks[ii].text.start = start;
+      if ( ii == count - 1 )
+      {
+         start = end;
+      }
+      else
+      {
+         share = text->start + ( text->length / count ) * ( ii + 1 );
+         if ( share > start )
+         {
+            newline = ( const char* )memchr( share, '\n', ( size_t )( end - share ) );
+            start = ( newline == NULL ) ? end : newline + 1;
+         }
+      }
+      chunks[ii].text.length = ( size_t )( start - chunks[ii].text.start );
+      chunks[ii].firstLine = 0;
+      chunks[ii].lineCount = 0;
+      chunks[ii].array = NULL;
+      initReport( &( chunks[ii].report ) );
+      chunks[ii].cmdsRead = 0;
+      chunks[ii].isInvalid = 0;
+   }
+
+   return count;
+}
+
+
+/* NAME: runChunks()
+ * PURPOSE: Runs a step on every chunk at once, returning once all are done.
+ * HOW IT WORKS: Starts a thread for every chunk but the first, which is run
+ *               on the calling thread, then joins them. A chunk whose thread
+ *               can't be started is run on the calling thread instead.
+ * RELATIONS:
+ *    validateScript() - Counts and validates the lines of every chunk.
+ * IMPORTS:
+ *    chunks - The chunks to run the step on.
+ *    count - The number of chunks.
+ *    work - The step, given a pointer to its chunk.
+ * EXPORTS:
+ *    none
+ */
+
+static void runChunks( Chunk* chunks, int count, void* ( *work )( void* ) )
+{
+   pthread_t threads[MAX_THREADS];
+   int isStarted[MAX_THREADS];
+   int ii;
+
+   for ( ii = 1; ii < count; ii++ )
+   {
+      isStarted[ii] = 0;
+      if ( pthread_create( &threads[ii], NULL, work, &chunks[ii] ) == 0 )
+      {
+         isStarted[ii] = -1;
+      }
+   }
+
+   ( *work )( &chunks[0] );
+
+   for ( ii = 1; ii < count; ii++ )
+   {
+      if ( isStarted[ii] != 0 )
+      {
+         pthread_join( threads[ii], NULL );
+      }
+      else
+      {
+         ( *work )( &chunks[ii] );
+      }
+   }
+}
+
+
+/* NAME: countChunkLines()
+ * PURPOSE: Counts the new lines of a chunk.
+ * HOW IT WORKS: Jumps from one new line to the next with memchr().
+ * RELATIONS:
+ *    validateScript() - Counts every chunk at once with runChunks().
+ * IMPORTS:
+ *    data - Pointer to the chunk.
+ * EXPORTS:
+ *    NULL
+ */
+
+static void* countChunkLines( void* data )
+{
+   Chunk* chunk = ( Chunk* )data;
+   const char* next = chunk->text.start;
+   const char* end = chunk->text.start + chunk->text.length;
+   const char* newline = NULL;
+
+   chunk->lineCount = 0;
+   while ( next < end )
+   {
+      newline = ( const char* )memchr( next, '\n', ( size_t )( end - next ) );
+      if ( newline == NULL )
+      {
+         next = end;
+      }
+      else
+      {
+         chunk->lineCount++;
+         next = newline + 1;
+      }
+   }
+
+   return NULL;
+}
+
+
+/* NAME: validateChunk()
+ * PURPOSE: Validates each line of a chunk, storing its valid commands.
+ * HOW IT WORKS: - Finds each line (excludes blank lines) with memchr(), then
+ *                 validates it in place with validateLine(), numbering lines
+ *                 on from the chunk's first line.
+ *               - If a single line is not valid then the chunk is marked as
+ *                 invalid, its errors being left in the chunk's report.
+ *               - Each validated command is stored in the chunk's command
+ *                 array using insertLast().
+ * RELATIONS:
+ *    validateScript() - Validates every chunk at once with runChunks().
+ *    validateLine() - Validates each line.
+ * IMPORTS:
+ *    data - Pointer to the chunk.
+ * EXPORTS:
+ *    NULL
+ */
+
+static void* validateChunk( void* data )
+{
+   Chunk* chunk = ( Chunk* )data;
+
+   /* start of the next line and end of the chunk */
+   const char* next = chunk->text.start;
+   const char* end = chunk->text.start + chunk->text.length;
+   const char* newline = NULL;
+
+   /* each line read */
+   Span line;
+
+   /* the command found on each line */
+   Command cmd;
+
+   /* used for easy error identification in file printed to the terminal */
+   int lineNo = chunk->firstLine;
+
+   /* Grab each line, along with its new line if it has one */
+   while ( next < end )
+   {
+      lineNo++;
+
+      line.start = next;
+      newline = ( const char* )memchr( next, '\n', ( size_t )( end - next ) );
+      if ( newline == NULL )
+      {
+         next = end;
+      }
+      else
+      {
+         next = newline + 1;
+      }
+      line.length = ( size_t )( next - line.start );
+
+      /* Skip any line just containing control characters (non-printable) */
+      if ( spanIsCtrl( &line ) == FALSE )
+      {
+         if ( validateLine( &line, lineNo, &cmd, &( chunk->report ) ) == FALSE )
+         {
+            chunk->isInvalid = -1;
+         }
+         /* Insert the command into the chunk's command array */
+         else if ( insertLast( chunk->array, &cmd ) == FALSE )
+         {
+            chunk->isInvalid = -1;
+            addMessage( &( chunk->report ), "Error: Line %d. command could not be stored\n\n", lineNo );
+         }
+         else
+         {
+            /* Increment the no of commands read/found */
+            chunk->cmdsRead++;
+         }
+      }
+   }
+
+   return NULL;
+}
+
+
+/* NAME: validateLine()
+ * PURPOSE: Validates a line that is not blank, setting the command it holds,
+ *          returning whether it was valid.
+ * HOW IT WORKS: - Validates the line in place with various validators.c
+ *                 functions depending on the command identified.
+ *               - If a single validation function returns false then the
+ *                 line is invalid and any errors are added to the report to
+ *                 identify what and where the problem occured in the file.
+ *               - The value parsed by a valid command's validation is
+ *                 stored with parseCommand(), along with the line number
+ *                 compileBlocks() reports block errors against.
+ *               - A line holding only the ] closing a block has no name
+ *                 or value, so is checked for first.
+ * RELATIONS:
+ *    validateChunk() - Validates each line of a chunk.
+ *    streamFile() - Validates each line as soon as it is read.
+ *    validateCommandName() - Validates the name of a command giving its
+ *                            descriptor, which points to the other
+ *                            validator functions.
+ *    validateBlockEnd() - Checks for a line closing a block.
+ * IMPORTS:
+ *    line - The line, including its new line if it has one.
+ *    lineNo - Number of the line within the file.
+ *    cmd - Set to the command held by a valid line.
+ *    report - Collects the error messages of an invalid line.
+ * EXPORTS:
+ *    isValid - Boolean evaluating to '0' (FALSE) if the line is not valid,
+ *              or '-1' (TRUE) otherwise.
+ */
+
+int validateLine( Span* line, int lineNo, Command* cmd, Report* report )
+{
+   int isValid = FALSE;
+
+   /* the part of the line still to be validated */
+   Span rest;
+
+   /* the command value, parsed once by its datatype validation */
+   Operand value;
+
+   /* validator values to verify the line */
+   int correctParameters = FALSE;
+   int correctDataType = FALSE;
+
+   /* descriptor of the command found on the line, giving its operation and
+    * the validators.c functions to validate it */
+   const CommandDescriptor* command = NULL;
+
+   /* Identify the validation operations to commence
+    * (pointers to functions) if the command name is found */
+   rest = *line;
+   if ( validateBlockEnd( line ) != FALSE )
+   {
+      isValid = -1;
+      cmd->opcode = OP_END;
+      cmd->jump = lineNo;
+   }
+   else if ( validateCommandName( &rest, &command ) == FALSE )
+   {
+      addMessage( report, "Error: Line %d. command unidentified\n", lineNo );
+      addMessage( report, "       check if value exists and/or name is spelt correctly\n" );
+   }
+   else
+   {
+      /* Check datatype of value */
+      correctDataType = ( *command->validateDataType )( &rest, &value, report );
+
+      /* Check parameter count */
+      correctParameters = ( *command->validateParameters )( &rest, &value, report );
+
+      if ( correctParameters == FALSE )
+      {
+         addMessage( report, "       Line %d. incorrect number of parameters for command\n\n", lineNo );
+      }
+      if ( correctDataType == FALSE )
+      {
+         addMessage( report, "       Line %d. incorrect data type for command\n\n", lineNo );
+      }
+      if ( ( correctParameters != FALSE ) && ( correctDataType != FALSE ) )
+      {
+         /* Check value range */
+         if ( ( *command->validateRange )( &value, report ) == FALSE )
+         {
+            addMessage( report, "       Line %d. incorrect range for command\n\n", lineNo );
+         }
+         else
+         {
+            isValid = -1;
+            parseCommand( command->opcode, &value, cmd );
+            cmd->jump = lineNo;
+         }
+      }
+   }
+
+   return isValid;
+}
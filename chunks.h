@@ -0,0 +1,50 @@
+/* FILE: chunks.h
+ * AUTHOR: Kyle Notani | 19149918
+ * UNIT: UCP COMP1000
+ * PURPOSE: Header file associated with chunks.c
+ */
+
+#ifndef CHUNKS_H
+   #define CHUNKS_H
+
+   #include "commandarray.h"
+   #include "structset.h"
+   #include "stringoperations.h"
+   #include "report.h"
+
+   /* Most threads a script is validated on */
+   #define MAX_THREADS 64
+
+   /* Fewest bytes of a script given to each thread, so small scripts are
+    * validated on the calling thread alone */
+   #define MIN_CHUNK_LENGTH 262144
+
+   /* Stores a run of whole lines of a script validated on its own thread,
+    * along with everything found validating them */
+   typedef struct
+   {
+      /* Text of the lines, each but the last ending in a new line */
+      Span text;
+      /* Number of lines in the script before the chunk */
+      int firstLine;
+      /* Number of new lines in the chunk */
+      int lineCount;
+      /* Valid commands of the chunk, in line order */
+      CommandArray* array;
+      /* Error messages of the chunk, in line order */
+      Report report;
+      int cmdsRead;
+      int isInvalid;
+   } Chunk;
+
+   /* Validates every line of a script, storing each valid command in the
+    * array and each error message in the report, in line order. Returns
+    * whether any line was invalid. */
+   int validateScript( Span* text, int threads, CommandArray* array, Report* report, int* cmdsRead );
+
+   /* Validates a line that is not blank, setting the command it holds and
+    * adding any error messages to the report. Returns whether the line was
+    * valid. */
+   int validateLine( Span* line, int lineNo, Command* cmd, Report* report );
+
+#endif
@@ -0,0 +1,27 @@
+/* FILE: commandarray.h
+ * AUTHOR: Kyle Notani | 19149918
+ * UNIT: UCP COMP1000
+ * PURPOSE: Header file associated with array operations across a growable
+ *          contiguous array of commands.
+ */
+
+#ifndef COMMANDARRAY_H
+   #define COMMANDARRAY_H
+
+   #include "structset.h"
+
+   /* Number of commands the array initially has room for before growing */
+   #define INITIAL_CAPACITY 64
+
+   /* Struct Declaration for a Growable Command Array
+    * Properties: Contiguous, commands stored by value in insertion order,
+    *             capacity doubles whenever the array is full.
+    */
+   typedef struct
+   {
+      Command* commands;
+      int count;
+      int capacity;
+   } CommandArray;
+
+#endif
@@ -9,17 +9,22 @@
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
+#include <limits.h>
 
 #include "conversions.h"
 
  
 /* NAME: defineCoordinates()
- * PURPOSE:    Converts angles and distances to (x, y) coordinates for commands
- *             that require coordinates to perform drawing on a 2D space.
+ * PURPOSE:    Converts directions and distances to (x, y) coordinates for
+ *             commands that require coordinates to perform drawing on a 2D
+ *             space.
  *             We must define a set of end x and y coordinates for these commands 
  *             to have a destination to point at to plot.
- * HOW IT WORKS:  Uses the cos() and sin() functions from the math.h library
- *                applying trigonometry to identify x and y coordinates.
+ * HOW IT WORKS:  Moves the distance along the unit direction of the current
+ *                angle, already found by defineDirection() when the angle
+ *                last changed, so no trigonometry is done per command.
+ *                y grows downwards on the terminal, so the direction's y is
+ *                subtracted.
  *
  * RELATIONS:  
  *    drawLine() - Called by drawLine() to identify (x, y) coordinates to perform
@@ -31,22 +36,85 @@
  *    y0   Starting y coordinate.
  *    x1   Ending x coordinate.
  *    y1   Ending y coordinate.
- *    angle    The current angle to identify the direction to where coordinates 
- *             will lead to.
+ *    dirX/dirY    The cosine and sine of the current angle, the direction to
+ *                 where coordinates will lead to.
  *    distance    The distance from the starting coordinates(x0, y0) to the 
  *                ending coordinates (x1, y1).
  * EXPORTS:
  *    none
  */
 
-void defineCoordinates( double* x0, double* y0, double* x1, double* y1, double* angle, double* distance )
+void defineCoordinates( double* x0, double* y0, double* x1, double* y1, double* dirX, double* dirY, double* distance )
 {
-   double radianCos = cos( RADIAN( *angle ) );
-   double radianSin = sin( RADIAN( *angle ) );
-
    /* Set x1 and y1 coordinates */
-   *x1 = ( ( *distance * radianCos ) + *x0 );
-   *y1 = ( *y0 - ( *distance * radianSin ) );
+   *x1 = ( ( *distance * *dirX ) + *x0 );
+   *y1 = ( *y0 - ( *distance * *dirY ) );
+}
+
+
+/* NAME: defineDirection()
+ * PURPOSE: Finds the unit direction of an angle, its cosine and sine.
+ * HOW IT WORKS: - An angle that is a whole multiple of 15 degrees takes its
+ *                 sine and cosine from SINE_TABLE, the exact values rounded
+ *                 once, so 90 degrees gives exactly (0, 1) and no error
+ *                 builds up along lines at common angles.
+ *               - The table holds the first quarter turn, the other
+ *                 quarters being the same values swapped and negated.
+ *               - Any other angle uses cos() and sin() from the math.h
+ *                 library.
+ * RELATIONS:
+ *    rotate() - Finds the direction each time the angle changes, the only
+ *               time it does.
+ * IMPORTS:
+ *    angle - An angle in degrees within 360 degrees.
+ *    dirX/dirY - Set to the cosine and sine of the angle.
+ * EXPORTS:
+ *    none
+ */
+
+void defineDirection( double angle, double* dirX, double* dirY )
+{
+   static const double SINE_TABLE[SINE_STEPS + 1] =
+   {
+      0.0,
+      0.25881904510252076235,
+      0.5,
+      0.70710678118654752440,
+      0.86602540378443864676,
+      0.96592582628906828675,
+      1.0
+   };
+
+   /* Nearest multiple of 15 degrees, if the angle is one */
+   int step = ( int )floor( angle / SINE_STEP + 0.5 );
+   int quarter = ( step / SINE_STEPS ) % 4;
+   int part = step % SINE_STEPS;
+
+   if ( ( step * SINE_STEP ) != angle )
+   {
+      *dirX = cos( RADIAN( angle ) );
+      *dirY = sin( RADIAN( angle ) );
+   }
+   else if ( quarter == 0 )
+   {
+      *dirX = SINE_TABLE[SINE_STEPS - part];
+      *dirY = SINE_TABLE[part];
+   }
+   else if ( quarter == 1 )
+   {
+      *dirX = -SINE_TABLE[part];
+      *dirY = SINE_TABLE[SINE_STEPS - part];
+   }
+   else if ( quarter == 2 )
+   {
+      *dirX = -SINE_TABLE[SINE_STEPS - part];
+      *dirY = -SINE_TABLE[part];
+   }
+   else
+   {
+      *dirX = SINE_TABLE[part];
+      *dirY = -SINE_TABLE[SINE_STEPS - part];
+   }
 }
 
 
@@ -58,6 +126,8 @@ void defineCoordinates( double* x0, double* y0, double* x1, double* y1, double*
  *               eg) 2.51 + 0.5 = 3.01
  *                   floor of 3.01 = 3 which is 2.51 rounded to nearest integer 
  *                   value.
+ *               Values past what an int holds, which the turtle can reach
+ *               by moving far enough, are kept to INT_MAX or INT_MIN.
  * RELATIONS:
  *    line() - Used by line to draw coordinates based on x and y starting and 
  *             finishing coordinates, rounded to nearest integer values.
@@ -70,7 +140,20 @@ void defineCoordinates( double* x0, double* y0, double* x1, double* y1, double*
 int round( double x )
 {
    int rounded;
-   rounded = floor( x + 0.5 );
+   double nearest = floor( x + 0.5 );
+
+   if ( nearest >= ( double )INT_MAX )
+   {
+      rounded = INT_MAX;
+   }
+   else if ( nearest <= ( double )INT_MIN )
+   {
+      rounded = INT_MIN;
+   }
+   else
+   {
+      rounded = ( int )nearest;
+   }
 
    return rounded;
 }
@@ -13,10 +13,20 @@
    /* Macro defintion conversion from degrees to radians */
    #define RADIAN(d) ( ( d ) * ( PI / 180 ) )
 
-   /* Converts angles and distances to (x, y) coordinates for commands
+   /* Angles with an exact direction in defineDirection()'s table, every
+    * SINE_STEP degrees, SINE_STEPS to a quarter turn */
+   #define SINE_STEP 15
+   #define SINE_STEPS 6
+
+   /* Converts directions and distances to (x, y) coordinates for commands
     * that require coordinates to perform drawing on a 2D space.
     */
-   void defineCoordinates( double* x0, double* y0, double* x1, double* y1, double* angle, double* distance );
+   void defineCoordinates( double* x0, double* y0, double* x1, double* y1, double* dirX, double* dirY, double* distance );
+
+   /* Finds the unit direction (cosine and sine) of an angle, exactly for
+    * multiples of SINE_STEP degrees.
+    */
+   void defineDirection( double angle, double* dirX, double* dirY );
    
    /* Rounds the series of real-values coordinates to nearest 
     * integer values.
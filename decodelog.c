@@ -0,0 +1,67 @@
+/*
+ * FILE: decodelog.c
+ * AUTHOR: Kyle Notani | 19149918
+ * UNIT: UCP COMP1000
+ * PURPOSE: Print a graphics.log as text, one DRAW or MOVE to a line and
+ *          "---" before each drawing, as older logs were written.
+ * FILE FORMATS: A graphics.log of binary records, possibly appended to a
+ *               text log (see graphicslog.c).
+ * COMMAND ARGUMENTS: Optionally the name of the log, graphics.log if none.
+ * OTHER: '-1' evaluates to true, '0' evaluates to false.
+ */
+
+#include <stdio.h>
+
+#include "graphicslog.h"
+
+
+/*
+ * NAME: main()
+ * PURPOSE: Entry point to DecodeLog. Prints the log named, or graphics.log,
+ *          as text.
+ * HOW IT WORKS: Opens the log and writes it to stdout with decodeLog(),
+ *               saying so should it not be read to the end.
+ * RELATIONS:
+ *    decodeLog() - Turns the records back into text.
+ *
+ * IMPORTS:
+ *    argc  The number of command-line arguments.
+ *    argv  An array of pointers to chars where each represents the argument
+ *          string (argument vector).
+ *
+ * EXPORTS:
+ *          Exit status condition provided to the OS.
+ */
+
+int main( int argc, char* argv[] )
+{
+   const char* name = LOG_NAME;
+   FILE* in;
+
+   if ( argc > 2 )
+   {
+      printf( "       usage: %s [logfile]\n", argv[0] );
+   }
+   else
+   {
+      if ( argc == 2 )
+      {
+         name = argv[1];
+      }
+
+      in = fopen( name, "rb" );
+      if ( in == NULL )
+      {
+         perror( "Error: log file can't be read" );
+      }
+      else
+      {
+         if ( decodeLog( in, stdout ) == 0 )
+         {
+            fprintf( stderr, "Error: log file is cut short or damaged\n" );
+         }
+         fclose( in );
+      }
+   }
+   return 0;
+}
@@ -2,7 +2,7 @@
  * FILE: draw.c
  * AUTHOR: Kyle Notani | 19149918
  * UNIT: UCP COMP1000
- * PURPOSE: Draw a series of validated commands from a linked list
+ * PURPOSE: Draw a series of validated commands from a command array
  *          onto the terminal based on regular, simple and debug modes while
  *          while writing each coordinate based draw or move into a logfile.
  */
@@ -14,69 +14,238 @@
 
 #include "draw.h"
 #include "effects.h"
-#include "linkedlist.h"
-#include "listoperations.h"
+#include "commandarray.h"
+#include "arrayoperations.h"
 #include "structset.h"
-#include "stringoperations.h"
 #include "conversions.h"
+#include "framebuffer.h"
+#include "options.h"
+#include "viewport.h"
+#include "image.h"
+#include "svg.h"
+#include "overdraw.h"
+#include "bytecode.h"
+#include "trace.h"
+#include "graphicslog.h"
 
 /*
  * NAME: draw()
  * PURPOSE: Handles the deciding operation for what command function to call 
- *    based on list contents writing the draw process into a graphics.log file.
+ *    based on array contents writing the draw process into a graphics.log file.
  *          
  * HOW IT WORKS:
- *    - Constructs a GraphicsState struct which indicates the current
- *      state of the applied commands performed during command grabbing.
- *    - The current graphics state starts with default setting for each
- *      command.
- *    - Loop through each node from the list containing the stored commands
- *      as a List node containing Command structs as a value to identify
- *      the command name.
- *    - Each identifiable command name will call it's corresponding command
- *      function operation.
- *    - Any draw or move commands will simply be appended to a graphics.log
- *      file for debugging purposes.
+ *    - An empty array has nothing to draw, so is reported without touching
+ *      the terminal or any image file.
+ *    - Otherwise sets up drawing with beginDraw(), runs each command the
+ *      compiled array gives nextCommand() with runCommand(), following
+ *      its REPEAT blocks and procedure calls, then finishes the drawing
+ *      with endDraw().
+ *    - When drawing straight to the terminal, findOverdraw() first finds
+ *      the cells a later line draws over, so only the cells seen are sent.
+ *    - A script of at least MIN_TRACE_COMMANDS commands with no blocks is
+ *      drawn with drawTraced() instead, unless run on one thread or in
+ *      fixed-point, so where each command takes the turtle is worked out
+ *      on every thread.
  *
  * RELATIONS:
  *    main() - Calling function for drawing operation to commence.
- *    stringUpperCase() - Used to allow case-insensitive comparisons to ensure
- *                        each command is identified correctly to perform its
- *                        operation.
+ *    beginDraw()/runCommand()/endDraw() - Draw the commands.
+ *    startRunner()/nextCommand() - Run the commands in the order drawn.
+ *    findOverdraw() - Finds the cells seen in direct mode.
+ *    drawTraced() - Draws a long script traced on several threads.
  * IMPORTS:
- *    list - The linked list with any read in valid commands.
+ *    array - The command array with any read in valid commands.
+ *    options - Run settings, choosing between framebuffer, direct and image
+ *              mode.
+ *    shown - Points to the frame shown on the terminal, NULL if unknown.
+ *            Updated to the frame drawn, or NULL if drawn directly.
  * EXPORTS:
  *    none
  *
  */
 
-void draw(LinkedList* list)
+void draw(CommandArray* array, Options* options, FrameBuffer** shown)
 {
-   /* Initially open logfile */
-   FILE* log = fopen("graphics.log", "a");
-
    /* Current state of Graphics maintained during command operations */
-   GraphicsState* current = (GraphicsState*)malloc( sizeof(GraphicsState) );
-   
-   /* Command struct contained within each list node in the list */
+   GraphicsState* current = NULL;
+
+   /* Cells seen of each line drawn straight to the terminal */
+   Overdraw* overdraw = NULL;
+
+   /* Where the commands are up to, and the command run next */
+   Runner runner;
    Command* cmd = NULL;
 
-   /* Point a temporary current list node to the head of the list */
-   LinkedListNode* currentNode = list->head;
+   /* Check if the array is empty */
+   if(isEmpty(array) != FALSE)
+   {
+      forgetShown(shown);
+      printf("Error: No commands to perform drawing\n");
+      printf("       Check if file contains any commands\n");
+   }
+   else
+   {
+      current = beginDraw(options, shown);
+      if(current != NULL)
+      {
+         if((current->frame == NULL) && (current->image == NULL) && (current->svg == NULL))
+         {
+            overdraw = findOverdraw(array, &(current->clip), current->isFixed);
+            current->overdraw = overdraw;
+         }
 
-   /* Temp coordinate variables */
-   double prevX = 0.0;
-   double prevY = 0.0;
+         /* Trace a long script run straight through ahead on every
+          * thread, or run the commands in the order the blocks give */
+         if((options->threads == 1) || (array->count < MIN_TRACE_COMMANDS) || (current->isFixed != FALSE) ||
+            (hasBlocks(array) != FALSE) || (drawTraced(array, current, options->threads) == FALSE))
+         {
+            startRunner(&runner);
+            cmd = nextCommand(&runner, array);
+            while(cmd != NULL)
+            {
+               runCommand(current, cmd);
+               cmd = nextCommand(&runner, array);
+            }
+         }
+         endDraw(current, options, shown);
+         freeOverdraw(overdraw);
+      }
+   }
+}
+
+
+
+
+
+/*
+ * NAME: drawTraced()
+ * PURPOSE: Draws the commands of a script with no blocks, tracing where
+ *          each takes the turtle ahead on several threads, returning
+ *          whether there was memory to trace them.
+ *
+ * HOW IT WORKS:
+ *    - Traces TRACE_WINDOW commands at a time with traceSteps(), from
+ *      where the turtle is, then runs each with runStep() in order. Only
+ *      the drawing of each line is left to this thread.
+ *    - The steps traced are exactly those drawLine() and move() would
+ *      work out, so the drawing and graphics.log are the same.
+ *
+ * RELATIONS:
+ *    draw() - Draws a long script run straight through.
+ *    traceSteps() - Traces each window of commands.
+ *    runStep() - Runs each command with its step.
+ * IMPORTS:
+ *    array - The commands, with no blocks.
+ *    current - The graphics state set up by beginDraw().
+ *    threads - Most threads to trace on, 0 for one per processor.
+ * EXPORTS:
+ *    isDrawn - A boolean evaluating to '0' (FALSE) if there was no memory
+ *              for the steps, so nothing was drawn, or '-1' (TRUE) otherwise.
+ *
+ */
 
-   /* Initial Read is set to TRUE */
-   int initialRead = -1;
+int drawTraced(CommandArray* array, GraphicsState* current, int threads)
+{
+   int isDrawn = FALSE;
+
+   /* Where each command of the window takes the turtle */
+   Step* steps = (Step*)malloc(TRACE_WINDOW * sizeof(Step));
+
+   /* Where the turtle is, ahead of the drawing by a window */
+   Turtle turtle;
+
+   int first;
+   int count;
+   int ii;
+
+   if(steps != NULL)
+   {
+      isDrawn = -1;
+      turtle.x = current->x;
+      turtle.y = current->y;
+      turtle.angle = current->angle;
+      turtle.dirX = current->dirX;
+      turtle.dirY = current->dirY;
+      turtle.lineX = 0.0;
+      turtle.lineY = 0.0;
+
+      for(first = 0; first < array->count; first += count)
+      {
+         count = array->count - first;
+         if(count > TRACE_WINDOW)
+         {
+            count = TRACE_WINDOW;
+         }
+         traceSteps(&(array->commands[first]), count, &turtle, steps, threads);
+         for(ii = 0; ii < count; ii++)
+         {
+            runStep(current, &(array->commands[first + ii]), &(steps[ii]));
+         }
+      }
+      free(steps);
+   }
+
+   return isDrawn;
+}
+
+
+
+
+
+/*
+ * NAME: beginDraw()
+ * PURPOSE: Sets up a graphics state ready to run commands on, returning NULL
+ *          if there is nowhere to draw them.
+ *
+ * HOW IT WORKS:
+ *    - Constructs a GraphicsState struct which indicates the current
+ *      state of the applied commands performed during command grabbing.
+ *    - The current graphics state starts with default setting for each
+ *      command.
+ *    - Unless direct mode is chosen, commands are drawn into a framebuffer
+ *      which is flushed to the terminal once all commands have run.
+ *    - When an image file is chosen, commands are drawn into an image
+ *      instead, written to the file once all commands have run, and nothing
+ *      is sent to the terminal. An SVG file is instead written as each line
+ *      is drawn.
+ *    - The terminal is only cleared when no frame is known to be shown on
+ *      it.
+ *    - Opens graphics.log, marking the start of the drawing in it.
+ *
+ * RELATIONS:
+ *    draw() - Sets up drawing the commands of an array.
+ *    streamFile() - Sets up drawing at the first valid command streamed.
+ * IMPORTS:
+ *    options - Run settings, choosing between framebuffer, direct and image
+ *              mode.
+ *    shown - Points to the frame shown on the terminal, NULL if unknown.
+ *            Set to NULL when drawing over it in place is not possible.
+ * EXPORTS:
+ *    current - The graphics state on the heap, or NULL if the image could
+ *              not be set up.
+ *
+ */
+
+GraphicsState* beginDraw(Options* options, FrameBuffer** shown)
+{
+   /* Current state of Graphics maintained during command operations */
+   GraphicsState* current = (GraphicsState*)malloc( sizeof(GraphicsState) );
+
+   /* Rectangle of cells kept by the framebuffer */
+   Viewport canvas;
 
    /* Default Position */
    current->x = 0.0;
    current->y = 0.0;
 
-   /* Default Angle */
+   /* Default Angle, facing right */
    current->angle = 0.0;
+   current->dirX = 1.0;
+   current->dirY = 0.0;
+
+   /* Fixed-point engine, starting in the same place */
+   current->isFixed = options->fixed;
+   startFixed(&(current->fixed));
    
    /* Default Colours */
    #ifndef SIMPLE
@@ -91,110 +260,318 @@ void draw(LinkedList* list)
    /* Default Pattern */
    current->pattern = '+';
 
-   if(log == NULL)
+   /* Export to an image in place of the terminal, or draw straight to the
+    * terminal in direct mode */
+   current->frame = NULL;
+   current->image = NULL;
+   current->svg = NULL;
+   current->overdraw = NULL;
+   if(options->imageName != NULL)
+   {
+      forgetShown(shown);
+      if(options->imageFormat == FORMAT_SVG)
+      {
+         current->svg = constructSvg(options->imageName, options->imageWidth, options->imageHeight,
+                                     &(options->view), current->bgColour);
+      }
+      else
+      {
+         current->image = constructImage(options->imageWidth, options->imageHeight,
+                                         (options->imageFormat == FORMAT_PGM) ? 1 : 3, &(options->view));
+      }
+   }
+   else if(options->direct == FALSE)
    {
-      perror("Error: log file can't be updated\n");
+      current->frame = constructFrame(options->canvasWidth, options->canvasHeight);
+      if(current->frame == NULL)
+      {
+         forgetShown(shown);
+         printf("Error: could not construct framebuffer, drawing directly\n");
+      }
    }
    else
    {
-      fprintf(log, "---\n");
+      forgetShown(shown);
    }
 
-   /* Check if the list is empty */
-   if(isEmpty(list) != FALSE)
+   /* Only the viewport is drawn, and only the canvas is kept in a
+    * framebuffer */
+   current->clip = options->view;
+   if(current->frame != NULL)
    {
-      printf("Error: No commands to perform drawing\n");
-      printf("       Check if file contains any commands\n");
+      canvas.left = 0;
+      canvas.top = 0;
+      canvas.width = options->canvasWidth;
+      canvas.height = options->canvasHeight;
+      intersectViewport(&(current->clip), &canvas);
+   }
+
+   if((options->imageName != NULL) && (current->image == NULL) && (current->svg == NULL))
+   {
+      if(options->imageFormat == FORMAT_SVG)
+      {
+         printf("Error: image file %s can't be written\n", options->imageName);
+      }
+      else
+      {
+         printf("Error: could not allocate a %d by %d image\n", options->imageWidth, options->imageHeight);
+      }
       free(current);
       current = NULL;
-      fclose(log);
    }
    else
    {
-      /* Initially blank the terminal before drawing */
-      clearScreen();
+      /* Initially open logfile */
+      current->log = openLog(LOG_NAME);
+      if(current->log == NULL)
+      {
+         perror("Error: log file can't be updated\n");
+      }
+
+      /* Initially blank the terminal before drawing, unless a frame is
+       * already shown to draw over or nothing is drawn on it */
+      if((*shown == NULL) && (options->imageName == NULL))
+      {
+         clearScreen();
+      }
 
       /* Default simple mode colours overriding any colour changes */
       #ifdef SIMPLE
-      setFgColour(current->fgColour);
-      setBgColour(current->bgColour);
+      if(current->svg != NULL)
+      {
+         current->svg->fgColour = current->fgColour;
+      }
+      else if(current->image != NULL)
+      {
+         current->image->fgColour = current->fgColour;
+         current->image->bgColour = current->bgColour;
+      }
+      else if(current->frame != NULL)
+      {
+         current->frame->fgColour = current->fgColour;
+         current->frame->bgColour = current->bgColour;
+      }
+      else
+      {
+         setFgColour(current->fgColour);
+         setBgColour(current->bgColour);
+      }
       #endif
+   }
 
-      /* Iterate through the list and run the commands */
-      /* Use a do while loop to assure that a single command by itself 
-       * can be read */
-      do
-      {
-         /* Only iterate if a single command is already done */
-         if ((currentNode->next != NULL) && (initialRead == FALSE))
-         {
-            currentNode = currentNode->next;
-         }
+   return current;
+}
+
+
+
+
+
+/*
+ * NAME: runCommand()
+ * PURPOSE: Runs a single command on the graphics state.
+ *
+ * HOW IT WORKS:
+ *    - The command's opcode selects its corresponding command function
+ *      operation through a switch.
+ *    - Any draw or move commands will simply be appended to a graphics.log
+ *      file for debugging purposes.
+ *
+ * RELATIONS:
+ *    draw() - Runs each command of an array.
+ *    streamFile() - Runs each valid command as soon as it is read.
+ *    runStep() - Runs the command, working out its step.
+ * IMPORTS:
+ *    current - The graphics state set up by beginDraw().
+ *    cmd - The command to run.
+ * EXPORTS:
+ *    none
+ *
+ */
+
+void runCommand(GraphicsState* current, Command* cmd)
+{
+   runStep(current, cmd, NULL);
+}
 
-         /* Grab command from list */
-         cmd = (Command*)currentNode->data;
-         stringUpperCase(cmd->name);
 
-         /* Draw */
-         if(strcmp(cmd->name, "DRAW") == 0)
+
+
+
+/*
+ * NAME: runStep()
+ * PURPOSE: Runs a single command on the graphics state, taking a DRAW or
+ *          MOVE to where its step, traced ahead, says.
+ *
+ * HOW IT WORKS:
+ *    - As runCommand(), but a draw is drawn with drawStep() and a move
+ *      moves straight to the step, with no coordinates worked out.
+ *    - With no step, coordinates are worked out with drawLine() and
+ *      move() as each command runs, or drawFixed() and moveFixed() in
+ *      fixed-point.
+ *
+ * RELATIONS:
+ *    runCommand() - Runs a command with no step.
+ *    drawTraced() - Runs each command of a window once traced.
+ * IMPORTS:
+ *    current - The graphics state set up by beginDraw().
+ *    cmd - The command to run.
+ *    step - Where the command takes the turtle, NULL if not traced.
+ * EXPORTS:
+ *    none
+ *
+ */
+
+void runStep(GraphicsState* current, Command* cmd, Step* step)
+{
+   /* Temp coordinate variables */
+   double prevX = 0.0;
+   double prevY = 0.0;
+
+   switch(cmd->opcode)
+   {
+      /* Draw */
+      case OP_DRAW:
+         if(current->isFixed != FALSE)
+         {
+            drawFixed(cmd, current, &prevX, &prevY);
+         }
+         else if(step == NULL)
          {
             drawLine(cmd, current, &prevX, &prevY);
-
-            /* Append to logfile */
-            fprintf(log, "DRAW (%7.3f,%7.3f)-(%7.3f,%7.3f)\n", prevX, prevY, current->x, current->y);
-            #ifdef DEBUG
-            fprintf(stderr, "DRAW (%7.3f,%7.3f)-(%7.3f,%7.3f)\n", prevX, prevY, current->x, current->y);
-            #endif
          }
-         /* Move */
-         else if(strcmp(cmd->name, "MOVE") == 0)
+         else
          {
-            move(cmd, current, &prevX, &prevY);
-            
-            /* Append to logfile */
-            fprintf(log, "MOVE (%7.3f,%7.3f)-(%7.3f,%7.3f)\n", prevX, prevY, current->x, current->y);
-            #ifdef DEBUG
-            fprintf(stderr, "MOVE (%7.3f,%7.3f)-(%7.3f,%7.3f)\n", prevX, prevY, current->x, current->y);
-            #endif
+            drawStep(step, current, &prevX, &prevY);
          }
-         /* Rotate */
-         else if (strcmp(cmd->name, "ROTATE") == 0)
+
+         /* Append to logfile */
+         if(current->log != NULL)
          {
-            rotate(cmd, current);
+            logStep(current->log, LOG_DRAW, prevX, prevY, current->x, current->y);
          }
-         /* Change Foreground Colour */
-         else if (strcmp(cmd->name, "FG") == 0)
+         #ifdef DEBUG
+         fprintf(stderr, "DRAW (%7.3f,%7.3f)-(%7.3f,%7.3f)\n", prevX, prevY, current->x, current->y);
+         #endif
+         break;
+      /* Move */
+      case OP_MOVE:
+         if(current->isFixed != FALSE)
          {
-            changeFgColour(cmd, current);
+            moveFixed(cmd, current, &prevX, &prevY);
          }
-         /* Change Background Colour */
-         else if(strcmp(cmd->name, "BG") == 0)
+         else if(step == NULL)
          {
-            changeBgColour(cmd, current);
+            move(cmd, current, &prevX, &prevY);
          }
-         /* Change Pattern */
-         else if(strcmp(cmd->name, "PATTERN") == 0)
+         else
          {
-            setPattern(cmd, current);
+            prevX = current->x;
+            prevY = current->y;
+            current->x = step->x;
+            current->y = step->y;
          }
 
-         if (initialRead != FALSE)
+         /* Append to logfile */
+         if(current->log != NULL)
          {
-            initialRead = FALSE;
+            logStep(current->log, LOG_MOVE, prevX, prevY, current->x, current->y);
          }
+         #ifdef DEBUG
+         fprintf(stderr, "MOVE (%7.3f,%7.3f)-(%7.3f,%7.3f)\n", prevX, prevY, current->x, current->y);
+         #endif
+         break;
+      /* Rotate */
+      case OP_ROTATE:
+         rotate(cmd, current);
+         break;
+      /* Change Foreground Colour */
+      case OP_FG:
+         changeFgColour(cmd, current);
+         break;
+      /* Change Background Colour */
+      case OP_BG:
+         changeBgColour(cmd, current);
+         break;
+      /* Change Pattern */
+      case OP_PATTERN:
+         setPattern(cmd, current);
+         break;
+      /* Blocks and calls are followed by nextCommand(), never run */
+      default:
+         break;
+   }
+}
 
-      /* We will increment the current pointer after command reading only if
-       * there exists a next pointer
-       */
-      } while(currentNode->next != NULL);
-   
-      /* Point cursor to the bottom of terminal after command operations */
+
+
+
+
+/*
+ * NAME: endDraw()
+ * PURPOSE: Finishes drawing once every command has run, deallocating the
+ *          graphics state.
+ *
+ * HOW IT WORKS:
+ *    - Flushes the framebuffer to the terminal, sending only the cells that
+ *      differ from any frame shown, then keeps it as the frame shown.
+ *    - Writes out an image, or finishes an SVG file, or otherwise leaves
+ *      the cursor at the bottom of the terminal.
+ *    - Closes graphics.log.
+ *
+ * RELATIONS:
+ *    draw() - Finishes drawing the commands of an array.
+ *    streamFile() - Finishes drawing once the stream has ended.
+ * IMPORTS:
+ *    current - The graphics state set up by beginDraw().
+ *    options - Run settings, naming any image file.
+ *    shown - Points to the frame shown on the terminal, NULL if unknown.
+ *            Updated to the frame drawn, or NULL if drawn directly.
+ * EXPORTS:
+ *    none
+ *
+ */
+
+void endDraw(GraphicsState* current, Options* options, FrameBuffer** shown)
+{
+   /* Write out the whole frame at once */
+   if(current->frame != NULL)
+   {
+      flushFrame(current->frame, *shown, &(options->view));
+   }
+
+   /* Write out the whole image at once, or point cursor to the bottom
+    * of terminal after command operations */
+   if(current->image != NULL)
+   {
+      if(writeImage(current->image, options->imageName) == FALSE)
+      {
+         printf("Error: image file %s can't be written\n", options->imageName);
+      }
+      freeImage(current->image);
+   }
+   else if(current->svg != NULL)
+   {
+      if(finishSvg(current->svg) == FALSE)
+      {
+         printf("Error: image file %s can't be written\n", options->imageName);
+      }
+   }
+   else
+   {
       penDown();
-      fclose(log);
+   }
+   if(current->log != NULL)
+   {
+      closeLog(current->log);
+   }
 
-      free(current);
-      current = NULL;
+   /* The frame drawn is now the one shown on the terminal */
+   if(current->frame != NULL)
+   {
+      forgetShown(shown);
+      *shown = current->frame;
    }
+   free(current);
 }
 
 
@@ -210,7 +587,7 @@ void draw(LinkedList* list)
  *          current x and y values at the current state assuring following 
  *          commands continue along where the cursor is located.
  *
- * HOW IT WORKS: - Grabs the distance (using atof()) from the passed in command 
+ * HOW IT WORKS: - Grabs the already parsed distance from the passed in command 
  *                 and reducing its value by one to prevent double printing to 
  *                 the terminal.
  *               - Store the current x and y value to previous values.
@@ -220,16 +597,14 @@ void draw(LinkedList* list)
  *                 printing.
  * RELATIONS:
  *    draw() - Calling function to draw line. (Passes in current state of 
- *             graphics and command data from list.)
+ *             graphics and command data from array.)
  *    defineCoordinates() - Used to define coordinates (x, y) with trigonometry 
  *                          to identify the coordinates from distance-1 and 
  *                          current angle as well as the start move to complete 
  *                          a single line draw.
- *    line() - Calls line() passing rounded x and y start and finish coordinates,
- *             the plot function as well as the current pattern to draw a line() 
- *             output to the terminal.
- *    plotPoint - pointer to a function passed for line to simple print a 
- *                given character (pattern) on screen.
+ *    plotLine() - Draws the line from its start to the end of distance-1.
+ *    svgLine() - Adds the line to the vector image when exporting one, from
+ *                the same coordinates logged to graphics.log.
  * IMPORTS:
  *    cmd - Command data to grab distance value to draw.
  *    current - Graphics state data to identify current angle and current x 
@@ -256,7 +631,7 @@ void drawLine( Command* cmd, GraphicsState* current, double* prevX, double* prev
    /* Cursor move distance */
    double finalMove = 1.0;
 
-   distance = atof( cmd->value );
+   distance = cmd->value.real;
    distance -= 1;
 
    /* Set prev temp values to current x and y coordinates */
@@ -264,17 +639,170 @@ void drawLine( Command* cmd, GraphicsState* current, double* prevX, double* prev
    *prevY = ( current->y );
 
    /* Define coordinates to distance-1 and current angle */
-   defineCoordinates( prevX, prevY, &endDrawX, &endDrawY, &( current->angle ), &distance );
+   defineCoordinates( prevX, prevY, &endDrawX, &endDrawY, &( current->dirX ), &( current->dirY ), &distance );
 
-   /* Draw line */
-   line( round( *prevX ), round( *prevY ), round( endDrawX ), round( endDrawY ), &plotPoint, &( current->pattern ) );
+   /* Draw the part of the line within the viewport, if any */
+   plotLine( current, *prevX, *prevY, endDrawX, endDrawY );
 
-   /* End at correct coordinates */
-   endDrawX = ( double )round( endDrawX );
-   endDrawY = ( double )round( endDrawY );
+   /* End at correct coordinates, rounded as round() does without
+    * limiting them to an int */
+   endDrawX = floor( endDrawX + 0.5 );
+   endDrawY = floor( endDrawY + 0.5 );
 
    /* Move cursor along by one */
-   defineCoordinates( &endDrawX, &endDrawY, &( current->x ), &( current->y ), &( current->angle ), &finalMove );
+   defineCoordinates( &endDrawX, &endDrawY, &( current->x ), &( current->y ), &( current->dirX ), &( current->dirY ), &finalMove );
+
+   if ( current->svg != NULL )
+   {
+      svgLine( current->svg, *prevX, *prevY, current->x, current->y );
+   }
+}
+
+
+
+
+
+/*
+ * NAME: drawStep()
+ * PURPOSE: Draws a line whose ends were traced ahead by traceSteps().
+ *
+ * HOW IT WORKS: - Draws from the current coordinates to the traced end of
+ *                 the line with plotLine(), then takes the coordinates the
+ *                 step leaves the cursor at.
+ *               - The step was worked out with the same arithmetic as
+ *                 drawLine(), so the line drawn and logged is the same.
+ * RELATIONS:
+ *    runStep() - Draws each traced draw command.
+ *    plotLine() - Draws the line.
+ *    svgLine() - Adds the line to the vector image when exporting one.
+ * IMPORTS:
+ *    step - Where the draw takes the cursor, and the end of its line.
+ *    current - Graphics state data, moved on to the step's coordinates.
+ *    prevX/prevY - Set to the coordinates drawn from, for the logfile.
+ * EXPORTS:
+ *    none
+ *
+ */
+
+void drawStep( Step* step, GraphicsState* current, double* prevX, double* prevY )
+{
+   *prevX = current->x;
+   *prevY = current->y;
+
+   plotLine( current, *prevX, *prevY, step->endX, step->endY );
+
+   current->x = step->x;
+   current->y = step->y;
+
+   if ( current->svg != NULL )
+   {
+      svgLine( current->svg, *prevX, *prevY, current->x, current->y );
+   }
+}
+
+
+
+
+
+/*
+ * NAME: plotLine()
+ * PURPOSE: Draws the part of a line within the viewport, if any.
+ *
+ * HOW IT WORKS: - An image takes the unrounded line.
+ *               - Otherwise the ends are rounded to whole cells and drawn
+ *                 with plotCells().
+ *               - A vector image takes the whole line once the cursor has
+ *                 moved on, so nothing is drawn here.
+ * RELATIONS:
+ *    drawLine()/drawStep() - Draw each line.
+ *    plotCells() - Draws the line between the rounded ends.
+ *    imageLine() - Draws the unrounded line into the image when exporting,
+ *                  in place of the above.
+ * IMPORTS:
+ *    current - Graphics state data, giving where to draw and the pattern.
+ *    startX/startY - Start of the line.
+ *    endX/endY - Unrounded end of the line.
+ * EXPORTS:
+ *    none
+ *
+ */
+
+void plotLine( GraphicsState* current, double startX, double startY, double endX, double endY )
+{
+   if ( current->image != NULL )
+   {
+      imageLine( current->image, startX, startY, endX, endY );
+   }
+   else if ( current->svg == NULL )
+   {
+      plotCells( current, round( startX ), round( startY ), round( endX ), round( endY ) );
+   }
+}
+
+
+
+
+
+/*
+ * NAME: plotCells()
+ * PURPOSE: Draws the part of a line between two whole cells within the
+ *          viewport, if any.
+ *
+ * HOW IT WORKS: - The line is clipped to the viewport, then drawn into the
+ *                 framebuffer, or straight to the terminal in direct mode,
+ *                 skipping any cell a later line draws over.
+ * RELATIONS:
+ *    plotLine() - Draws each line once its ends are rounded.
+ *    drawFixed() - Draws each fixed-point line, its ends rounded in
+ *                  fixed-point.
+ *    clipLine() - Clips the line to the viewport (and canvas), so lines
+ *                 outside it cost no drawing at all.
+ *    drawSegment() - Draws the clipped line with the current pattern, to the
+ *                    terminal in direct mode.
+ *    takeLine()/drawSeenSegment() - Draw only the cells seen instead, when
+ *                                   the overdraw was found.
+ *    frameSegment() - Draws the clipped line into the framebuffer otherwise.
+ * IMPORTS:
+ *    current - Graphics state data, giving where to draw and the pattern.
+ *    x1/y1 - Cell the line starts on.
+ *    x2/y2 - Cell the line ends on.
+ * EXPORTS:
+ *    none
+ *
+ */
+
+void plotCells( GraphicsState* current, int x1, int y1, int x2, int y2 )
+{
+   /* Part of the line within the viewport, and whether there is any */
+   Segment seg;
+   int isVisible;
+
+   /* Bit of the line's first cell seen, or whether to draw it at all */
+   long first = LINE_UNCHECKED;
+
+   isVisible = clipLine( &( current->clip ), x1, y1, x2, y2, &seg );
+
+   /* Lines drawn over later are left out in direct mode */
+   if ( current->overdraw != NULL )
+   {
+      first = takeLine( current->overdraw, x1, y1, x2, y2, ( isVisible != FALSE ) ? seg.count : 0 );
+   }
+
+   if ( isVisible != FALSE )
+   {
+      if ( current->frame != NULL )
+      {
+         frameSegment( current->frame, &seg, current->pattern );
+      }
+      else if ( first >= 0 )
+      {
+         drawSeenSegment( &seg, &( current->clip ), current->pattern, current->overdraw->seen, first );
+      }
+      else if ( first == LINE_UNCHECKED )
+      {
+         drawSegment( &seg, &( current->clip ), current->pattern );
+      }
+   }
 }
 
 
@@ -290,13 +818,13 @@ void drawLine( Command* cmd, GraphicsState* current, double* prevX, double* prev
  *          current x and y values at the current state assuring following 
  *          commands continue along where the cursor is located.
  *
- * HOW IT WORKS: - Grabs the distance (using atof()) from the passed in command.
+ * HOW IT WORKS: - Grabs the already parsed distance from the passed in command.
  *               - Store the current x and y value to previous values.
  *               - Call defineCoordinates to move (uses trigonometry to identify 
  *                 the coordinates from distance and current angle).
  * RELATIONS:
  *    draw() - Calling function to move cursor. (Passes in current state of 
- *             graphics and command data from list.)
+ *             graphics and command data from array.)
  *    defineCoordinates() - Used to define coordinates (x, y) with trigonometry
  *                          to identify the coordinates from distance and 
  *                          current angle.
@@ -317,28 +845,127 @@ void move( Command* cmd, GraphicsState* current, double* prevX, double* prevY )
    /* Distance to move cursor to */
    double distance = 0.0;
 
-   distance = atof( cmd->value );
+   distance = cmd->value.real;
    *prevX = current->x;
    *prevY = current->y;
 
    /* Perform the move */
-   defineCoordinates( prevX, prevY, &( current->x ), &( current->y ), &( current->angle ), &distance );
+   defineCoordinates( prevX, prevY, &( current->x ), &( current->y ), &( current->dirX ), &( current->dirY ), &distance );
+}
+
+
+
+/*
+ * NAME: drawFixed()
+ * PURPOSE: Commences the draw command in fixed-point.
+ *
+ * HOW IT WORKS: - Moves the fixed-point turtle with fixedDraw(), which goes
+ *                 distance-1 along the direction, rounds the end and moves
+ *                 on by one, as drawLine() does in doubles.
+ *               - The ends of the line are rounded to whole cells in
+ *                 fixed-point and drawn with plotCells(), no double taking
+ *                 part. An image or vector image takes the line converted
+ *                 to doubles, exactly.
+ * RELATIONS:
+ *    runStep() - Draws each line in fixed-point.
+ *    fixedDraw() - Moves the turtle along the line.
+ *    plotCells() - Draws the line between its whole cells.
+ *    imageLine()/svgLine() - Draw the line when exporting an image.
+ * IMPORTS:
+ *    cmd - Command data to grab distance value to draw.
+ *    current - Graphics state data, moved on past the line.
+ *    prevX/prevY - Set to the coordinates drawn from, for the logfile.
+ * EXPORTS:
+ *    none
+ *
+ */
+
+void drawFixed( Command* cmd, GraphicsState* current, double* prevX, double* prevY )
+{
+   /* Start and unrounded end of the line */
+   Fixed startX = current->fixed.x;
+   Fixed startY = current->fixed.y;
+   Fixed endX;
+   Fixed endY;
+
+   *prevX = current->x;
+   *prevY = current->y;
+
+   fixedDraw( &( current->fixed ), cmd->value.real, &endX, &endY );
+
+   if ( current->image != NULL )
+   {
+      imageLine( current->image, *prevX, *prevY, fromFixed( endX ), fromFixed( endY ) );
+   }
+   else if ( current->svg == NULL )
+   {
+      plotCells( current, fixedToCell( startX ), fixedToCell( startY ), fixedToCell( endX ), fixedToCell( endY ) );
+   }
+
+   current->x = fromFixed( current->fixed.x );
+   current->y = fromFixed( current->fixed.y );
+
+   if ( current->svg != NULL )
+   {
+      svgLine( current->svg, *prevX, *prevY, current->x, current->y );
+   }
+}
+
+
+
+
+
+/*
+ * NAME: moveFixed()
+ * PURPOSE: Commences the move command in fixed-point.
+ *
+ * HOW IT WORKS: Moves the fixed-point turtle with fixedMove(), then takes
+ *               its coordinates converted to doubles.
+ * RELATIONS:
+ *    runStep() - Moves the cursor in fixed-point.
+ *    fixedMove() - Moves the turtle.
+ * IMPORTS:
+ *    cmd - Command data to grab distance value to move.
+ *    current - Graphics state data, moved on.
+ *    prevX/prevY - Set to the coordinates moved from, for the logfile.
+ * EXPORTS:
+ *    none
+ *
+ */
+
+void moveFixed( Command* cmd, GraphicsState* current, double* prevX, double* prevY )
+{
+   *prevX = current->x;
+   *prevY = current->y;
+
+   fixedMove( &( current->fixed ), cmd->value.real );
+
+   current->x = fromFixed( current->fixed.x );
+   current->y = fromFixed( current->fixed.y );
 }
 
 
 
+
+
 /*
  * NAME: rotate()
  * PURPOSE: Rotates the angle based on rotate command ensuring the rotation is 
  *          within 360 degrees.
- * HOW IT WORKS: - Grabs the rotate value (using atof()) from the passed in 
+ * HOW IT WORKS: - Grabs the already parsed rotate value from the passed in 
  *                 command.
  *               - Calls defineAngle to mod the angle by 360 to keep it within 
  *                 360 degree range.
+ *               - Calls defineDirection to find the direction of the new
+ *                 angle once, for every draw and move until the next rotate.
+ *               - In fixed-point the turtle is turned by fixedRotate()
+ *                 instead.
  * RELATIONS:
  *    draw() - Calling function to rotate angle. (Passes in current state of 
- *             graphics and command data from list.)
+ *             graphics and command data from array.)
  *    defineAngle() - Used to mod a given value by 360.
+ *    defineDirection() - Used to find the cosine and sine of the angle.
+ *    fixedRotate() - Turns the fixed-point turtle.
  * IMPORTS:
  *    cmd - Command data to grab angle value to rotate.
  *    current - Graphics state data to set current angle.
@@ -349,9 +976,19 @@ void move( Command* cmd, GraphicsState* current, double* prevX, double* prevY )
 
 void rotate( Command* cmd, GraphicsState* current )
 {
-   current->angle += atof( cmd->value );
-   /* Mod by 360 */
-   current->angle = defineAngle( current->angle );
+   if ( current->isFixed != FALSE )
+   {
+      fixedRotate( &( current->fixed ), cmd->value.real );
+      current->angle = fromFixed( current->fixed.angle );
+   }
+   else
+   {
+      current->angle += cmd->value.real;
+      /* Mod by 360 */
+      current->angle = defineAngle( current->angle );
+      /* Direction draws and moves go in until the next rotate */
+      defineDirection( current->angle, &( current->dirX ), &( current->dirY ) );
+   }
 }
 
 
@@ -360,13 +997,14 @@ void rotate( Command* cmd, GraphicsState* current )
 /*
  * NAME: changeFgColour()
  * PURPOSE: Sets the foreground colour of the terminal.
- * HOW IT WORKS: - Grabs the foreground colour value from the command struct 
- *                 using atoi() to store the validated command in the current 
+ * HOW IT WORKS: - Grabs the already parsed foreground colour value from the
+ *                 command struct to store the validated command in the current 
  *                 graphics state.
- *               - Calls setFgColour to the command value grabbed.
+ *               - Calls setFgColour to the command value grabbed, or gives
+ *                 the framebuffer the colour for the cells drawn next.
  * RELATIONS:
  *    draw() - Calling function to set foreground colour. 
- *            (passes in current state of graphics and command data  from list.)
+ *            (passes in current state of graphics and command data from array.)
  *    setFgColour - function within effects.c file to set the foreground colour 
  *                  of the terminal.
  * IMPORTS:
@@ -380,8 +1018,23 @@ void rotate( Command* cmd, GraphicsState* current )
 void changeFgColour( Command* cmd, GraphicsState* current )
 {
    #ifndef SIMPLE
-   current->fgColour = atoi( cmd->value );
-   setFgColour( current->fgColour );
+   current->fgColour = cmd->value.integer;
+   if ( current->svg != NULL )
+   {
+      current->svg->fgColour = current->fgColour;
+   }
+   else if ( current->image != NULL )
+   {
+      current->image->fgColour = current->fgColour;
+   }
+   else if ( current->frame != NULL )
+   {
+      current->frame->fgColour = current->fgColour;
+   }
+   else
+   {
+      setFgColour( current->fgColour );
+   }
    #endif
 }
 
@@ -391,13 +1044,14 @@ void changeFgColour( Command* cmd, GraphicsState* current )
 /*
  * NAME: changeBgColour()
  * PURPOSE: Sets the background colour of the terminal.
- * HOW IT WORKS: - Grabs the background colour value from the command struct 
- *                 using atoi() to store the validated command in the current 
+ * HOW IT WORKS: - Grabs the already parsed background colour value from the
+ *                 command struct to store the validated command in the current 
  *                 graphics state.
- *               - Calls setBgColour to the command value grabbed.
+ *               - Calls setBgColour to the command value grabbed, or gives
+ *                 the framebuffer the colour for the cells drawn next.
  * RELATIONS:
  *    draw() - Calling function to set background colour.
- *            (passes in current state of graphics and command data  from list.)
+ *            (passes in current state of graphics and command data from array.)
  *    setBgColour - function within effects.c file to set the background colour 
  *                  of the terminal.
  * IMPORTS:
@@ -411,8 +1065,20 @@ void changeFgColour( Command* cmd, GraphicsState* current )
 void changeBgColour( Command* cmd, GraphicsState* current )
 {
    #ifndef SIMPLE
-   current->bgColour = atoi( cmd->value );
-   setBgColour( current->bgColour );
+   current->bgColour = cmd->value.integer;
+   if ( current->image != NULL )
+   {
+      current->image->bgColour = current->bgColour;
+   }
+   else if ( current->frame != NULL )
+   {
+      current->frame->bgColour = current->bgColour;
+   }
+   /* Vector images leave out backgrounds */
+   else if ( current->svg == NULL )
+   {
+      setBgColour( current->bgColour );
+   }
    #endif
 }
 
@@ -422,12 +1088,12 @@ void changeBgColour( Command* cmd, GraphicsState* current )
 /*
  * NAME: setPattern()
  * PURPOSE: Sets the pattern (character) to be drawn with on the terminal.
- * HOW IT WORKS: - Grabs the pattern value from the command struct by simply 
- *                 grabbing the first char within the validated value string.
+ * HOW IT WORKS: - Grabs the pattern character already stored within the
+ *                 command struct.
  *               - Sets the current pattern to the character value.
  * RELATIONS:
  *    draw() - Calling function to set pattern.
- *            (passes in current state of graphics and command data from list.)
+ *            (passes in current state of graphics and command data from array.)
  *    line() - line() requires a current pattern to be printed onto the 
  *             terminal output.
  * IMPORTS:
@@ -439,7 +1105,7 @@ void changeBgColour( Command* cmd, GraphicsState* current )
 
 void setPattern( Command* cmd, GraphicsState* current )
 {
-   current->pattern = ( cmd->value )[0];
+   current->pattern = cmd->value.pattern;
 }
   
 
@@ -452,7 +1118,6 @@ void setPattern( Command* cmd, GraphicsState* current )
  *                 to a pointer to a character, printing the character out to 
  *                 the terminal.
  * RELATIONS:
- *    drawLine() - Passes pointer to this function to line().
  *    line() - line() requires a current pattern data to be printed onto the 
  *             terminal output.
  * IMPORTS:
@@ -7,8 +7,9 @@
 #ifndef DRAW_H
    #define DRAW_H
 
-   #include "linkedlist.h"
+   #include "commandarray.h"
    #include "structset.h"
+   #include "options.h"
    
    /* Boolean Conditions */
    #define FALSE 0
@@ -16,9 +17,38 @@
 
    
    /* Handles the deciding operation for what command function to call based
-    * on list contents writing the draw process into a graphics.log file.
+    * on array contents writing the draw process into a graphics.log file.
     */
-   void draw( LinkedList* list );
+   void draw( CommandArray* array, Options* options, FrameBuffer** shown );
+
+
+   /* Sets up a graphics state ready to run commands on, returning NULL if
+    * there is nowhere to draw them.
+    */
+   GraphicsState* beginDraw( Options* options, FrameBuffer** shown );
+
+
+   /* Draws the commands of a script with no blocks, tracing where each
+    * takes the turtle ahead on several threads, returning whether there was
+    * memory to trace them.
+    */
+   int drawTraced( CommandArray* array, GraphicsState* current, int threads );
+
+
+   /* Runs a single command on the graphics state. */
+   void runCommand( GraphicsState* current, Command* cmd );
+
+
+   /* Runs a single command on the graphics state, taking a DRAW or MOVE to
+    * where its step, traced ahead, says.
+    */
+   void runStep( GraphicsState* current, Command* cmd, Step* step );
+
+
+   /* Finishes drawing once every command has run, deallocating the graphics
+    * state.
+    */
+   void endDraw( GraphicsState* current, Options* options, FrameBuffer** shown );
    
    
    /* Commences the draw command. Draw a line on the terminal based on current 
@@ -31,6 +61,24 @@
  
    void drawLine( Command* cmd, GraphicsState* current, double* prevX, double* prevY );  
    
+   /* Draws a line whose ends were traced ahead by traceSteps(). */
+   void drawStep( Step* step, GraphicsState* current, double* prevX, double* prevY );
+
+
+   /* Draws the part of a line within the viewport, if any, into whatever
+    * the graphics state draws on.
+    */
+   void plotLine( GraphicsState* current, double startX, double startY, double endX, double endY );
+
+   /* Draws the part of a line between two whole cells within the viewport,
+    * if any, into the framebuffer or straight to the terminal.
+    */
+   void plotCells( GraphicsState* current, int x1, int y1, int x2, int y2 );
+
+   /* Commences the draw command with the turtle moved in fixed-point. */
+   void drawFixed( Command* cmd, GraphicsState* current, double* prevX, double* prevY );
+
+   
    /* Commences the move command. Moves the cursor based on current angle and 
     * distance.
     * Uses trigonometetry to maintain coordinate locations on the terminal
@@ -39,6 +87,9 @@
     * where the cursor is located.
     */
    void move( Command* cmd, GraphicsState* current, double* prevX, double* prevY );
+
+   /* Commences the move command with the turtle moved in fixed-point. */
+   void moveFixed( Command* cmd, GraphicsState* current, double* prevX, double* prevY );
    
    
    /* Rotates the angle based on rotate command ensuring the rotation is within 
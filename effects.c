@@ -12,6 +12,11 @@
 
 typedef void (*MoveFunc)(int* x, int* y);
 
+/* What has been sent to the terminal, so that escapes it doesn't need can be
+ * left out. -1 means unknown. */
+static int cursorX = -1, cursorY = -1;
+static int fgColour = -1, bgColour = -1;
+
 /* These are utility functions used by line(). */
 static void moveRight(int* x, int* y) { (*x)++; }
 static void moveLeft(int* x, int* y)  { (*x)--; }
@@ -21,6 +26,9 @@ static void moveUp(int* x, int* y)    { (*y)--; }
 /**
  * Draw a line from (x1,y1) to (x2,y2) using the *plotter function to actually 
  * plot each "pixel" (character).
+ *
+ * The plotter may print anything, so the cursor is moved to every point and
+ * is unknown afterwards.
  */
 void line(int x1, int y1, int x2, int y2, PlotFunc plotter, void *plotData)
 {
@@ -70,6 +78,97 @@ void line(int x1, int y1, int x2, int y2, PlotFunc plotter, void *plotData)
             (*minorMove)(&x, &y);
         }
     }    
+
+    cursorX = -1;
+    cursorY = -1;
+}
+
+
+/**
+ * Draw the visible part of a line, as clipped by clipLine(), printing the 
+ * pattern at each "pixel". The points plotted are those line() would plot for
+ * the whole line that lie within the viewport, with the viewport's top left 
+ * corner placed at the top left of the terminal.
+ *
+ * Each point is a single character, leaving the cursor just after it, so the
+ * cursor is only moved when the next point is elsewhere. The viewport is held
+ * within the terminal's width by parseOptions(), so no point reaches past the
+ * right margin and wraps onto the next row.
+ */
+void drawSegment(Segment* seg, Viewport* view, char pattern)
+{
+    int x = seg->x - view->left, y = seg->y - view->top;
+    int decision = seg->decision, i;
+
+    for(i = 0; i < seg->count; i++)
+    {
+        if(x != cursorX || y != cursorY)
+        {
+            printf("\033[%d;%dH", y + 1, x + 1);
+        }
+        putchar(pattern);
+        cursorX = x + 1;
+        cursorY = y;
+
+        /* Move along one "pixel" and (possibly) across one as well. */
+        if(seg->xIsMajor)
+            x += seg->stepX;
+        else
+            y += seg->stepY;
+        decision += seg->minorDelta;
+        if(decision >= seg->majorDelta)
+        {
+            decision -= seg->majorDelta;
+            if(seg->xIsMajor)
+                y += seg->stepY;
+            else
+                x += seg->stepX;
+        }
+    }
+}
+
+
+/**
+ * Draw the visible part of a line like drawSegment(), but only plot the cells 
+ * whose bit is set in seen, counting from bit first. The others are drawn over 
+ * later anyway, so the cursor simply jumps past them.
+ */
+void drawSeenSegment(Segment* seg, Viewport* view, char pattern,
+                     unsigned char* seen, long first)
+{
+    int x = seg->x - view->left, y = seg->y - view->top;
+    int decision = seg->decision, i;
+    long bit;
+
+    for(i = 0; i < seg->count; i++)
+    {
+        bit = first + i;
+        if(seen[bit >> 3] & (1 << (bit & 7)))
+        {
+            if(x != cursorX || y != cursorY)
+            {
+                printf("\033[%d;%dH", y + 1, x + 1);
+            }
+            putchar(pattern);
+            cursorX = x + 1;
+            cursorY = y;
+        }
+
+        /* Move along one "pixel" and (possibly) across one as well. */
+        if(seg->xIsMajor)
+            x += seg->stepX;
+        else
+            y += seg->stepY;
+        decision += seg->minorDelta;
+        if(decision >= seg->majorDelta)
+        {
+            decision -= seg->majorDelta;
+            if(seg->xIsMajor)
+                y += seg->stepY;
+            else
+                x += seg->stepX;
+        }
+    }
 }
 
 
@@ -89,24 +188,36 @@ void clearScreen()
 void penDown()
 {
     printf("\033[10000;1H");
+
+    /* Whatever is printed next moves the cursor on from here. */
+    cursorX = -1;
+    cursorY = -1;
 }
 
 
 /**
- * Changes the foreground colour to a code from 0-15.
+ * Changes the foreground colour to a code from 0-15, unless already in use.
  */
 void setFgColour(int code)
 {
-    printf("\033[22;%dm", (code % 8) + 30);
-    if((code % 16) >= 8)
-        printf("\033[1m");
+    code = code % 16;
+    if(code != fgColour)
+    {
+        printf("\033[%d;%dm", (code >= 8) ? 1 : 22, (code % 8) + 30);
+        fgColour = code;
+    }
 }
 
 
 /**
- * Changes the background colour to a code from 0-7.
+ * Changes the background colour to a code from 0-7, unless already in use.
  */
 void setBgColour(int code)
 {
-    printf("\033[%dm", (code % 8) + 40);
+    code = code % 8;
+    if(code != bgColour)
+    {
+        printf("\033[%dm", code + 40);
+        bgColour = code;
+    }
 }
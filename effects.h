@@ -1,3 +1,8 @@
+#ifndef EFFECTS_H
+#define EFFECTS_H
+
+#include "viewport.h"
+
 /**
  * Defines the plotter functions required by line().
  */
@@ -9,6 +14,20 @@ typedef void (*PlotFunc)(void *plotData);
  */
 void line(int x1, int y1, int x2, int y2, PlotFunc plotter, void *plotData);
 
+/**
+ * Draw the visible part of a line, as clipped by clipLine(), printing the 
+ * pattern at each "pixel", with the viewport's top left corner placed at the
+ * top left of the terminal. The cursor is only moved when needed.
+ */
+void drawSegment(Segment* seg, Viewport* view, char pattern);
+
+/**
+ * Draw the visible part of a line like drawSegment(), but only plot the cells
+ * whose bit is set in seen, counting from bit first.
+ */
+void drawSeenSegment(Segment* seg, Viewport* view, char pattern,
+                     unsigned char* seen, long first);
+
 /**
  * Blanks the terminal.
  */
@@ -21,11 +40,13 @@ void clearScreen();
 void penDown();
 
 /**
- * Changes the foreground colour to a code from 0-15.
+ * Changes the foreground colour to a code from 0-15, unless already in use.
  */
 void setFgColour(int code);
 
 /**
- * Changes the background colour to a code from 0-7.
+ * Changes the background colour to a code from 0-7, unless already in use.
  */
 void setBgColour(int code);
+
+#endif
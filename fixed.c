@@ -0,0 +1,453 @@
+/*
+ * FILE: fixed.c
+ * AUTHOR: Kyle Notani | 19149918
+ * UNIT: UCP COMP1000
+ * PURPOSE: Move the turtle in 32.32 fixed-point, with whole-number
+ *          arithmetic only, as an alternative to the floating-point
+ *          conversions.c engine.
+ * OTHER: Each command's value is converted to fixed-point once, exactly
+ *        rounded, and every step after that is done on longs, so a script
+ *        draws the same cells to the last bit with any compiler, flags or
+ *        maths library. Sines come from a table of whole degrees, written
+ *        out here rather than worked out with sin(), with angles between
+ *        them turned to by a short series.
+ *        '-1' evaluates to true, '0' evaluates to false.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "fixed.h"
+
+/* Fails to compile unless a long holds 32.32 fixed-point */
+typedef char FixedNeedsLong64[( sizeof( long ) >= 8 ) ? 1 : -1];
+
+static Fixed alongDirection( Fixed distance, long direction );
+static Fixed addFixed( Fixed position, Fixed offset );
+static long shiftRound( long value, int bits );
+
+/* Sine of each whole degree of a quarter turn in 2.30 fixed-point, rounded
+ * once from the exact value */
+static const long SINE_DEGREES[91] =
+{
+   0L, 18739379L, 37473049L, 56195305L, 74900443L, 93582766L,
+   112236583L, 130856211L, 149435979L, 167970228L, 186453311L, 204879599L,
+   223243478L, 241539355L, 259761657L, 277904834L, 295963357L, 313931728L,
+   331804471L, 349576144L, 367241333L, 384794656L, 402230767L, 419544355L,
+   436730145L, 453782903L, 470697435L, 487468587L, 504091252L, 520560366L,
+   536870912L, 553017922L, 568996477L, 584801711L, 600428808L, 615873009L,
+   631129609L, 646193961L, 661061475L, 675727625L, 690187940L, 704438018L,
+   718473518L, 732290163L, 745883746L, 759250125L, 772385229L, 785285058L,
+   797945680L, 810363241L, 822533958L, 834454122L, 846120104L, 857528349L,
+   868675383L, 879557810L, 890172315L, 900515665L, 910584710L, 920376381L,
+   929887697L, 939115760L, 948057759L, 956710970L, 965072759L, 973140576L,
+   980911966L, 988384560L, 995556083L, 1002424350L, 1008987269L, 1015242840L,
+   1021189159L, 1026824413L, 1032146887L, 1037154959L, 1041847103L, 1046221891L,
+   1050277989L, 1054014162L, 1057429273L, 1060522280L, 1063292242L, 1065738315L,
+   1067859754L, 1069655912L, 1071126243L, 1072270298L, 1073087729L, 1073578288L,
+   1073741824L
+};
+
+
+/* NAME: startFixed()
+ * PURPOSE: Places the turtle at 0,0 facing right.
+ * HOW IT WORKS: Sets each field as beginDraw() does in floating-point.
+ * RELATIONS:
+ *    beginDraw() - Starts the fixed-point turtle of a drawing.
+ *    traceLines() - Starts tracing the lines of a drawing.
+ * IMPORTS:
+ *    turtle - The turtle to place.
+ * EXPORTS:
+ *    none
+ */
+
+void startFixed( FixedTurtle* turtle )
+{
+   turtle->x = 0;
+   turtle->y = 0;
+   turtle->angle = 0;
+   turtle->dirX = DIRECTION_ONE;
+   turtle->dirY = 0;
+}
+
+
+/* NAME: toFixed()
+ * PURPOSE: Converts a command's value to the nearest fixed-point value.
+ * HOW IT WORKS: Multiplies by 2^32 and adds a half, then takes the floor by
+ *               truncating to a long and stepping down one if that went up.
+ *               Each step is exact, so the value is the same on any IEEE
+ *               machine. Values beyond FIXED_LIMIT cells are kept to it,
+ *               so the result is within FIXED_MAX, and a NaN taken as 0.
+ * RELATIONS:
+ *    fixedRotate()/fixedMove()/fixedDraw() - Convert each command's value.
+ * IMPORTS:
+ *    value - A distance or angle.
+ * EXPORTS:
+ *    fixed - The value in 32.32 fixed-point.
+ */
+
+Fixed toFixed( double value )
+{
+   Fixed fixed = 0;
+   double scaled;
+
+   if ( value > FIXED_LIMIT )
+   {
+      value = FIXED_LIMIT;
+   }
+   else if ( value < -FIXED_LIMIT )
+   {
+      value = -FIXED_LIMIT;
+   }
+   if ( value == value )
+   {
+      scaled = ( value * ( double )FIXED_ONE ) + 0.5;
+      fixed = ( Fixed )scaled;
+      if ( ( double )fixed > scaled )
+      {
+         fixed--;
+      }
+   }
+
+   return fixed;
+}
+
+
+/* NAME: fromFixed()
+ * PURPOSE: Converts a fixed-point value to a double.
+ * HOW IT WORKS: Multiplies by 2^-32, exactly as dividing by 2^32 would.
+ *               Any coordinate within 2^21 cells has at most 53
+ *               significant bits, so is exact in a double.
+ * RELATIONS:
+ *    drawFixed()/moveFixed() - Give the coordinates logged and exported.
+ * IMPORTS:
+ *    value - A value in 32.32 fixed-point.
+ * EXPORTS:
+ *    real - The value as a double.
+ */
+
+double fromFixed( Fixed value )
+{
+   return ( double )value * ( 1.0 / ( double )FIXED_ONE );
+}
+
+
+/* NAME: fixedToCell()
+ * PURPOSE: Rounds a fixed-point coordinate to the nearest whole cell.
+ * HOW IT WORKS: Adds a half, then takes the floor of dividing by 2^32, as
+ *               round() takes floor( x + 0.5 ). Shifts are only done on
+ *               unsigned values, whose result C fixes for every compiler.
+ * RELATIONS:
+ *    drawFixed() - Rounds the ends of each line.
+ *    fixedDraw() - Rounds the end of a line the turtle moves on from.
+ *    traceLines() - Rounds the ends of each line traced.
+ * IMPORTS:
+ *    value - A coordinate in 32.32 fixed-point.
+ * EXPORTS:
+ *    cell - The nearest whole cell, a half rounding up.
+ */
+
+int fixedToCell( Fixed value )
+{
+   Fixed shifted = value + FIXED_HALF;
+   long cell;
+
+   if ( shifted >= 0 )
+   {
+      cell = ( long )( ( unsigned long )shifted >> FIXED_SHIFT );
+   }
+   else
+   {
+      cell = -( long )( ( -( unsigned long )shifted + ( unsigned long )( FIXED_ONE - 1 ) ) >> FIXED_SHIFT );
+   }
+
+   return ( int )cell;
+}
+
+
+/* NAME: fixedDirection()
+ * PURPOSE: Finds the unit direction of a fixed-point angle.
+ * HOW IT WORKS: - Takes the sine and cosine of the nearest whole degree
+ *                 from SINE_DEGREES, the other quarters being the same
+ *                 values swapped and negated, as defineDirection() does.
+ *               - A whole degree is exactly the table's direction, so 90
+ *                 degrees gives exactly (0, 1).
+ *               - Otherwise the angle is at most half a degree off. That
+ *                 small angle's sine and cosine are found in fixed-point
+ *                 radians by the first terms of their series, r - r^3/6
+ *                 and 1 - r^2/2 + r^4/24, whose next terms are too small to
+ *                 change the result, then added to the whole degree's with
+ *                 the angle sum identities.
+ * RELATIONS:
+ *    fixedRotate() - Finds the direction each time the angle changes.
+ * IMPORTS:
+ *    angle - An angle in 32.32 fixed-point degrees, within a whole turn.
+ *    dirX/dirY - Set to the cosine and sine of the angle, in 2.30
+ *                fixed-point.
+ * EXPORTS:
+ *    none
+ */
+
+void fixedDirection( Fixed angle, long* dirX, long* dirY )
+{
+   long degree = ( long )( ( ( unsigned long )angle + FIXED_HALF ) >> FIXED_SHIFT );
+   Fixed offset = angle - ( degree * FIXED_ONE );
+   int isNegative = ( offset < 0 ) ? -1 : 0;
+   long part;
+   long sine;
+   long cosine;
+   long radians;
+   long square;
+   long cube;
+   long fourth;
+   long sineOffset;
+   long cosineOffset;
+
+   degree %= 360;
+   part = degree % 90;
+   switch ( degree / 90 )
+   {
+      case 0:
+         cosine = SINE_DEGREES[90 - part];
+         sine = SINE_DEGREES[part];
+         break;
+      case 1:
+         cosine = -SINE_DEGREES[part];
+         sine = SINE_DEGREES[90 - part];
+         break;
+      case 2:
+         cosine = -SINE_DEGREES[90 - part];
+         sine = -SINE_DEGREES[part];
+         break;
+      default:
+         cosine = SINE_DEGREES[part];
+         sine = -SINE_DEGREES[90 - part];
+         break;
+   }
+
+   if ( offset == 0 )
+   {
+      *dirX = cosine;
+      *dirY = sine;
+   }
+   else
+   {
+      /* Series of the offset's size, in 32.32 fixed-point radians */
+      if ( isNegative != 0 )
+      {
+         offset = -offset;
+      }
+      radians = shiftRound( offset * FIXED_RADIANS, FIXED_SHIFT );
+      square = shiftRound( radians * radians, FIXED_SHIFT );
+      cube = shiftRound( square * radians, FIXED_SHIFT );
+      fourth = shiftRound( square * square, FIXED_SHIFT );
+      sineOffset = shiftRound( radians - ( cube / 6 ), FIXED_SHIFT - DIRECTION_SHIFT );
+      cosineOffset = shiftRound( FIXED_ONE - ( square / 2 ) + ( fourth / 24 ), FIXED_SHIFT - DIRECTION_SHIFT );
+      if ( isNegative != 0 )
+      {
+         sineOffset = -sineOffset;
+      }
+
+      *dirX = shiftRound( ( cosine * cosineOffset ) - ( sine * sineOffset ), DIRECTION_SHIFT );
+      *dirY = shiftRound( ( sine * cosineOffset ) + ( cosine * sineOffset ), DIRECTION_SHIFT );
+   }
+}
+
+
+/* NAME: fixedRotate()
+ * PURPOSE: Turns the turtle by a ROTATE's angle.
+ * HOW IT WORKS: Takes the turn within 360 degrees with fmod(), which is
+ *               exact, converts it, then adds it and keeps the angle within
+ *               a whole turn. The direction is found once, for every draw
+ *               and move until the next rotate.
+ * RELATIONS:
+ *    rotate() - Turns the turtle in the fixed-point engine.
+ *    traceLines() - Turns the turtle as lines are traced.
+ * IMPORTS:
+ *    turtle - The turtle, turned.
+ *    turn - The ROTATE's angle in degrees.
+ * EXPORTS:
+ *    none
+ */
+
+void fixedRotate( FixedTurtle* turtle, double turn )
+{
+   turtle->angle += toFixed( fmod( turn, 360.0 ) );
+   if ( turtle->angle < 0 )
+   {
+      turtle->angle += FIXED_TURN;
+   }
+   else if ( turtle->angle >= FIXED_TURN )
+   {
+      turtle->angle -= FIXED_TURN;
+   }
+   fixedDirection( turtle->angle, &( turtle->dirX ), &( turtle->dirY ) );
+}
+
+
+/* NAME: fixedMove()
+ * PURPOSE: Moves the turtle by a MOVE's distance.
+ * HOW IT WORKS: Moves the distance along the direction, y growing
+ *               downwards, as defineCoordinates() does. The turtle stops at
+ *               FIXED_LIMIT cells rather than going past it.
+ * RELATIONS:
+ *    moveFixed() - Moves the turtle in the fixed-point engine.
+ *    traceLines() - Moves the turtle as lines are traced.
+ * IMPORTS:
+ *    turtle - The turtle, moved.
+ *    distance - The MOVE's distance.
+ * EXPORTS:
+ *    none
+ */
+
+void fixedMove( FixedTurtle* turtle, double distance )
+{
+   Fixed length = toFixed( distance );
+
+   turtle->x = addFixed( turtle->x, alongDirection( length, turtle->dirX ) );
+   turtle->y = addFixed( turtle->y, -alongDirection( length, turtle->dirY ) );
+}
+
+
+/* NAME: fixedDraw()
+ * PURPOSE: Moves the turtle by a DRAW's distance, giving the unrounded end
+ *          of the line drawn.
+ * HOW IT WORKS: Goes distance-1 along the direction to the end of the
+ *               line, rounds the end to a whole cell, then moves on by one,
+ *               as drawLine() does. Neither the end nor the turtle goes past
+ *               FIXED_LIMIT cells.
+ * RELATIONS:
+ *    drawFixed() - Draws a line in the fixed-point engine.
+ *    traceLines() - Traces each line of a drawing.
+ * IMPORTS:
+ *    turtle - The turtle, moved on past the line.
+ *    distance - The DRAW's distance.
+ *    endX/endY - Set to the unrounded end of the line.
+ * EXPORTS:
+ *    none
+ */
+
+void fixedDraw( FixedTurtle* turtle, double distance, Fixed* endX, Fixed* endY )
+{
+   Fixed length = toFixed( distance ) - FIXED_ONE;
+
+   *endX = addFixed( turtle->x, alongDirection( length, turtle->dirX ) );
+   *endY = addFixed( turtle->y, -alongDirection( length, turtle->dirY ) );
+
+   /* One cell on is exactly the direction, in 32.32 fixed-point */
+   turtle->x = addFixed( ( Fixed )fixedToCell( *endX ) * FIXED_ONE, turtle->dirX * ( FIXED_ONE / DIRECTION_ONE ) );
+   turtle->y = addFixed( ( Fixed )fixedToCell( *endY ) * FIXED_ONE, -turtle->dirY * ( FIXED_ONE / DIRECTION_ONE ) );
+}
+
+
+/* NAME: alongDirection()
+ * PURPOSE: Multiplies a fixed-point distance by a cosine or sine.
+ * HOW IT WORKS: Multiplies the sizes as unsigned longs, the whole and
+ *               fractional parts of the distance separately so neither
+ *               product overflows, rounding the fractional part's to the
+ *               nearest 2^-32. The sign is put back afterwards, so a
+ *               negative distance goes exactly as far as a positive one.
+ *               A distance beyond FIXED_MAX, only a draw's distance-1 can
+ *               be, is kept to it, so the offset is within FIXED_MAX too.
+ * RELATIONS:
+ *    fixedMove()/fixedDraw() - Move the turtle along its direction.
+ * IMPORTS:
+ *    distance - A distance in 32.32 fixed-point.
+ *    direction - A cosine or sine in 2.30 fixed-point.
+ * EXPORTS:
+ *    offset - The distance along the direction, in 32.32 fixed-point.
+ */
+
+static Fixed alongDirection( Fixed distance, long direction )
+{
+   unsigned long size = ( distance < 0 ) ? -( unsigned long )distance : ( unsigned long )distance;
+   unsigned long scale = ( direction < 0 ) ? -( unsigned long )direction : ( unsigned long )direction;
+   unsigned long whole;
+   unsigned long fraction;
+   Fixed offset;
+
+   if ( size > ( unsigned long )FIXED_MAX )
+   {
+      size = ( unsigned long )FIXED_MAX;
+   }
+   whole = ( size >> FIXED_SHIFT ) * scale * ( 1UL << ( FIXED_SHIFT - DIRECTION_SHIFT ) );
+   fraction = ( ( ( size & ( unsigned long )( FIXED_ONE - 1 ) ) * scale ) +
+                ( 1UL << ( DIRECTION_SHIFT - 1 ) ) ) >> DIRECTION_SHIFT;
+   offset = ( Fixed )( whole + fraction );
+
+   if ( ( distance < 0 ) != ( direction < 0 ) )
+   {
+      offset = -offset;
+   }
+
+   return offset;
+}
+
+
+/* NAME: addFixed()
+ * PURPOSE: Adds an offset to a fixed-point position, keeping it within
+ *          FIXED_MAX.
+ * HOW IT WORKS: Checks the room left before adding, so the sum never
+ *               overflows a long, and gives FIXED_MAX, or -FIXED_MAX, if
+ *               the position would go past it.
+ * RELATIONS:
+ *    fixedMove()/fixedDraw() - Move the turtle and find the ends of lines.
+ * IMPORTS:
+ *    position - A coordinate in 32.32 fixed-point, within FIXED_MAX.
+ *    offset - A distance to add, within FIXED_MAX.
+ * EXPORTS:
+ *    sum - The coordinate moved by the offset.
+ */
+
+static Fixed addFixed( Fixed position, Fixed offset )
+{
+   Fixed sum;
+
+   if ( ( offset > 0 ) && ( position > FIXED_MAX - offset ) )
+   {
+      sum = FIXED_MAX;
+   }
+   else if ( ( offset < 0 ) && ( position < -FIXED_MAX - offset ) )
+   {
+      sum = -FIXED_MAX;
+   }
+   else
+   {
+      sum = position + offset;
+   }
+
+   return sum;
+}
+
+
+/* NAME: shiftRound()
+ * PURPOSE: Divides a value by a power of two, rounding to the nearest.
+ * HOW IT WORKS: Shifts the size of the value as an unsigned long, a half
+ *               rounding away from zero, then puts the sign back, so the
+ *               result doesn't rest on how a compiler shifts negatives.
+ * RELATIONS:
+ *    fixedDirection() - Scales each product of fixed-point values.
+ * IMPORTS:
+ *    value - The value.
+ *    bits - The power of two to divide by, at least 1.
+ * EXPORTS:
+ *    rounded - The value divided and rounded.
+ */
+
+static long shiftRound( long value, int bits )
+{
+   unsigned long half = 1UL << ( bits - 1 );
+   long rounded;
+
+   if ( value < 0 )
+   {
+      rounded = -( long )( ( -( unsigned long )value + half ) >> bits );
+   }
+   else
+   {
+      rounded = ( long )( ( ( unsigned long )value + half ) >> bits );
+   }
+
+   return rounded;
+}
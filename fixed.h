@@ -0,0 +1,79 @@
+/* FILE: fixed.h
+ * AUTHOR: Kyle Notani | 19149918
+ * UNIT: UCP COMP1000
+ * PURPOSE: Header file associated with fixed.c
+ */
+
+#ifndef FIXED_H
+   #define FIXED_H
+
+   /* A coordinate, distance or angle in 32.32 fixed-point, a whole number
+    * of 2^-32ths, needing a long of 64 bits */
+   typedef long Fixed;
+
+   #define FIXED_SHIFT 32
+   #define FIXED_ONE ( 1L << FIXED_SHIFT )
+   #define FIXED_HALF ( 1L << ( FIXED_SHIFT - 1 ) )
+
+   /* Largest whole number of cells a value is kept within */
+   #define FIXED_LIMIT 2147483647.0
+
+   /* FIXED_LIMIT cells in 32.32 fixed-point, the furthest the turtle goes
+    * from 0,0 along either axis */
+   #define FIXED_MAX ( 2147483647L * FIXED_ONE )
+
+   /* A unit direction's cosine or sine in 2.30 fixed-point, so that two
+    * multiplied together still fit a long */
+   #define DIRECTION_SHIFT 30
+   #define DIRECTION_ONE ( 1L << DIRECTION_SHIFT )
+
+   /* A whole turn, in 32.32 fixed-point degrees */
+   #define FIXED_TURN ( 360L << FIXED_SHIFT )
+
+   /* Pi / 180 in 0.32 fixed-point, radians in a degree */
+   #define FIXED_RADIANS 74961321L
+
+   /* Stores where the turtle is in the fixed-point engine, as drawLine(),
+    * move() and rotate() move it in the floating-point one */
+   typedef struct
+   {
+      Fixed x;
+      Fixed y;
+      /* Angle in degrees within a whole turn */
+      Fixed angle;
+      /* Unit direction of the angle, in 2.30 fixed-point */
+      long dirX;
+      long dirY;
+   } FixedTurtle;
+
+   /* Places the turtle at 0,0 facing right. */
+   void startFixed( FixedTurtle* turtle );
+
+   /* Converts a command's value to the nearest fixed-point value. */
+   Fixed toFixed( double value );
+
+   /* Converts a fixed-point value to a double, exactly. */
+   double fromFixed( Fixed value );
+
+   /* Rounds a fixed-point coordinate to the nearest whole cell, as round()
+    * rounds a double.
+    */
+   int fixedToCell( Fixed value );
+
+   /* Finds the unit direction of a fixed-point angle from the table of
+    * whole degrees.
+    */
+   void fixedDirection( Fixed angle, long* dirX, long* dirY );
+
+   /* Turns the turtle by a ROTATE's angle. */
+   void fixedRotate( FixedTurtle* turtle, double turn );
+
+   /* Moves the turtle by a MOVE's distance. */
+   void fixedMove( FixedTurtle* turtle, double distance );
+
+   /* Moves the turtle by a DRAW's distance, giving the unrounded end of
+    * the line drawn.
+    */
+   void fixedDraw( FixedTurtle* turtle, double distance, Fixed* endX, Fixed* endY );
+
+#endif
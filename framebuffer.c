@@ -0,0 +1,1366 @@
+/*
+ * FILE: framebuffer.c
+ * AUTHOR: Kyle Notani | 19149918
+ * UNIT: UCP COMP1000
+ * PURPOSE: Rasterize drawing commands into an off-screen canvas of cells and
+ *          emit the viewport of the finished frame to the terminal with a
+ *          single write().
+ * OTHER: The canvas is stored as fixed-size tiles allocated the first time
+ *        they are drawn to, so a mostly empty canvas of millions of cells
+ *        across costs only the tiles actually drawn on.
+ *        A cell drawn over many times is only emitted once, with its final
+ *        pattern and colours, so overwritten cells cost no output bytes.
+ *        When a previous frame is still on the terminal only the cells that
+ *        changed are sent, found through each tile row's drawn extent.
+ *        Runs of identical cells are sent once and repeated with REP.
+ *        Relative cursor moves and REP runs rely on the viewport fitting
+ *        within the terminal's width, which parseOptions() sees to.
+ *        '-1' evaluates to true, '0' evaluates to false.
+ */
+
+#define _POSIX_C_SOURCE 199506L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "framebuffer.h"
+
+/* Stores the bytes of a frame before it is written to the terminal */
+typedef struct
+{
+   char* data;
+   size_t length;
+   size_t capacity;
+} OutBuffer;
+
+/* Stores what has been sent to the terminal so far during a flush */
+typedef struct
+{
+   OutBuffer out;
+   /* Canvas cell shown at the top left of the terminal, and the columns
+    * of the viewport */
+   int left;
+   int top;
+   int width;
+   /* Cursor position on the terminal, -1 when unknown */
+   int x;
+   int y;
+   /* Colours in use */
+   int fgColour;
+   int bgColour;
+} Terminal;
+
+/* Identifies a tile drawn to in either frame during a flush */
+typedef struct
+{
+   int tileX;
+   int tileY;
+} TileKey;
+
+static Tile* findTile( FrameBuffer* frame, int tileX, int tileY );
+static Tile* makeTile( FrameBuffer* frame, int tileX, int tileY );
+static int growTable( FrameBuffer* frame );
+static unsigned long hashTile( int tileX, int tileY );
+static void fillRow( FrameBuffer* frame, int first, int last, int y, char pattern );
+static void fillColumn( FrameBuffer* frame, int x, int first, int last, char pattern );
+static void lineAlongX( FrameBuffer* frame, Segment* seg, char pattern );
+static void lineAlongY( FrameBuffer* frame, Segment* seg, char pattern );
+static Cell makeInk( FrameBuffer* frame, char pattern );
+static void widenRow( Tile* tile, int row, int first, int last );
+static int collectKeys( FrameBuffer* frame, Viewport* view, TileKey* keys, int count );
+static int compareKeys( const void* first, const void* second );
+static void appendBytes( OutBuffer* out, const char* bytes, size_t count );
+static void forgetMargin( Terminal* term );
+static void appendColours( Terminal* term, int fgColour, int bgColour );
+static int formatMove( Terminal* term, int x, int y, char* escape );
+static void formatStep( char* escape, int distance, char forward, char backward );
+static void appendGap( Terminal* term, FrameBuffer* frame, FrameBuffer* shown, int x, int y );
+static void appendCell( Terminal* term, FrameBuffer* frame, int x, int y );
+static int appendRepeat( Terminal* term, FrameBuffer* frame, FrameBuffer* shown, int x, int y, int last );
+static Cell* getCell( FrameBuffer* frame, int x, int y );
+static int cellsDiffer( Cell* cell, Cell* other );
+
+/* A cell never drawn to */
+static Cell blankCell = { '\0', DEFAULT_COLOUR, DEFAULT_COLOUR };
+
+
+/* NAME: constructFrame()
+ * PURPOSE: Constructs an empty framebuffer for a canvas of width by height
+ *          cells.
+ * HOW IT WORKS: Allocates a FrameBuffer struct and an empty table of
+ *               INITIAL_TILES slots. No cells are allocated until drawn to.
+ *               Draws in the terminal's default colours until told
+ *               otherwise.
+ * RELATIONS:
+ *    draw() - Constructs the framebuffer to draw every command into.
+ * IMPORTS:
+ *    width/height - Size of the canvas in cells.
+ * EXPORTS:
+ *    frame - a pointer to the allocated FrameBuffer struct on the heap, or
+ *            NULL if any allocation failed.
+ */
+
+FrameBuffer* constructFrame( int width, int height )
+{
+   FrameBuffer* frame = ( FrameBuffer* )malloc( sizeof( FrameBuffer ) );
+
+   if ( frame != NULL )
+   {
+      frame->capacity = INITIAL_TILES;
+      frame->count = 0;
+      frame->lastTile = NULL;
+      frame->width = width;
+      frame->height = height;
+      frame->fgColour = DEFAULT_COLOUR;
+      frame->bgColour = DEFAULT_COLOUR;
+      frame->tiles = ( Tile** )calloc( INITIAL_TILES, sizeof( Tile* ) );
+
+      if ( frame->tiles == NULL )
+      {
+         free( frame );
+         frame = NULL;
+      }
+   }
+
+   return frame;
+}
+
+
+/* NAME: frameSegment()
+ * PURPOSE: Draws a clipped line of a pattern into the framebuffer, visiting
+ *          the same cells as line() in effects.c would along the segment.
+ * HOW IT WORKS: - Horizontal and vertical segments are filled as spans with
+ *                 fillRow() and fillColumn(), a tile at a time.
+ *               - Other segments continue Bresenham's line algorithm from
+ *                 the segment's state, in a kernel for lines mostly along x
+ *                 (lineAlongX()) or along y (lineAlongY()). Each kernel
+ *                 steps through the cells of a tile directly, only looking
+ *                 up a tile when the line crosses into it.
+ * RELATIONS:
+ *    drawLine() - Draws each clipped line command into the framebuffer.
+ *    clipLine() - Clips lines to within the canvas.
+ * IMPORTS:
+ *    frame - The framebuffer to draw into.
+ *    seg - The segment to draw, lying within the canvas.
+ *    pattern - The character to draw.
+ * EXPORTS:
+ *    none
+ */
+
+void frameSegment( FrameBuffer* frame, Segment* seg, char pattern )
+{
+   long steps = seg->count - 1;
+   long across = 0;
+   int lastX, lastY;
+
+   /* Finishing cell of the segment */
+   if ( seg->majorDelta > 0 )
+   {
+      across = ( seg->decision + steps * seg->minorDelta ) / seg->majorDelta;
+   }
+   if ( seg->xIsMajor != 0 )
+   {
+      lastX = seg->x + ( int )( seg->stepX * steps );
+      lastY = seg->y + ( int )( seg->stepY * across );
+   }
+   else
+   {
+      lastX = seg->x + ( int )( seg->stepX * across );
+      lastY = seg->y + ( int )( seg->stepY * steps );
+   }
+
+   if ( seg->y == lastY )
+   {
+      fillRow( frame, ( seg->x < lastX ) ? seg->x : lastX, ( seg->x > lastX ) ? seg->x : lastX, lastY, pattern );
+   }
+   else if ( seg->x == lastX )
+   {
+      fillColumn( frame, lastX, ( seg->y < lastY ) ? seg->y : lastY, ( seg->y > lastY ) ? seg->y : lastY, pattern );
+   }
+   else if ( seg->xIsMajor != 0 )
+   {
+      lineAlongX( frame, seg, pattern );
+   }
+   else
+   {
+      lineAlongY( frame, seg, pattern );
+   }
+}
+
+
+/* NAME: fillRow()
+ * PURPOSE: Fills a horizontal span of cells with a pattern.
+ * HOW IT WORKS: Splits the span at tile edges. Within each tile, copies one
+ *               prepared cell into each cell of the span and widens the
+ *               row's drawn extent once.
+ * RELATIONS:
+ *    frameSegment() - Draws horizontal segments, and single points.
+ * IMPORTS:
+ *    frame - The framebuffer to draw into.
+ *    first/last - Leftmost and rightmost column of the span.
+ *    y - Row of the span.
+ *    pattern - The character to draw.
+ * EXPORTS:
+ *    none
+ */
+
+static void fillRow( FrameBuffer* frame, int first, int last, int y, char pattern )
+{
+   Cell ink = makeInk( frame, pattern );
+   Tile* tile;
+   Cell* cell;
+   Cell* end;
+   int x = first;
+   int stop;
+
+   while ( x <= last )
+   {
+      /* Last column of the span within this tile */
+      stop = x | TILE_MASK;
+      if ( stop > last )
+      {
+         stop = last;
+      }
+
+      /* Making a tile only fails when memory runs out, dropping its cells */
+      tile = makeTile( frame, x >> TILE_SHIFT, y >> TILE_SHIFT );
+      if ( tile != NULL )
+      {
+         cell = &( tile->cells[( ( y & TILE_MASK ) << TILE_SHIFT ) + ( x & TILE_MASK )] );
+         end = cell + ( stop - x );
+         while ( cell <= end )
+         {
+            *cell = ink;
+            cell++;
+         }
+         widenRow( tile, y & TILE_MASK, x & TILE_MASK, stop & TILE_MASK );
+      }
+
+      x = stop + 1;
+   }
+}
+
+
+/* NAME: fillColumn()
+ * PURPOSE: Fills a vertical span of cells with a pattern.
+ * HOW IT WORKS: Splits the span at tile edges. Within each tile, copies one
+ *               prepared cell into each cell of the span, one row apart,
+ *               widening each row's drawn extent.
+ * RELATIONS:
+ *    frameSegment() - Draws vertical segments.
+ * IMPORTS:
+ *    frame - The framebuffer to draw into.
+ *    x - Column of the span.
+ *    first/last - Top and bottom row of the span.
+ *    pattern - The character to draw.
+ * EXPORTS:
+ *    none
+ */
+
+static void fillColumn( FrameBuffer* frame, int x, int first, int last, char pattern )
+{
+   Cell ink = makeInk( frame, pattern );
+   Tile* tile;
+   Cell* cell;
+   int y = first;
+   int stop, row;
+
+   while ( y <= last )
+   {
+      /* Last row of the span within this tile */
+      stop = y | TILE_MASK;
+      if ( stop > last )
+      {
+         stop = last;
+      }
+
+      /* Making a tile only fails when memory runs out, dropping its cells */
+      tile = makeTile( frame, x >> TILE_SHIFT, y >> TILE_SHIFT );
+      if ( tile != NULL )
+      {
+         cell = &( tile->cells[( ( y & TILE_MASK ) << TILE_SHIFT ) + ( x & TILE_MASK )] );
+         for ( row = y & TILE_MASK; row <= ( stop & TILE_MASK ); row++ )
+         {
+            *cell = ink;
+            cell += TILE_SIZE;
+            widenRow( tile, row, x & TILE_MASK, x & TILE_MASK );
+         }
+      }
+
+      y = stop + 1;
+   }
+}
+
+
+/* NAME: lineAlongX()
+ * PURPOSE: Draws a segment that runs further along x than along y.
+ * HOW IT WORKS: Bresenham's line algorithm with x as the major axis, the
+ *               same decisions line() in effects.c makes. Tracks the cell's
+ *               column and row within its tile, stepping one column per
+ *               cell drawn and one row across whenever the decision value
+ *               overflows. The next tile is only looked up once the line
+ *               steps off the edge of the current one.
+ * RELATIONS:
+ *    frameSegment() - Draws diagonal segments in the four octants either
+ *                     side of the x axis.
+ * IMPORTS:
+ *    frame - The framebuffer to draw into.
+ *    seg - The segment to draw.
+ *    pattern - The character to draw.
+ * EXPORTS:
+ *    none
+ */
+
+static void lineAlongX( FrameBuffer* frame, Segment* seg, char pattern )
+{
+   Cell ink = makeInk( frame, pattern );
+   int x = seg->x;
+   int y = seg->y;
+   int column = x & TILE_MASK;
+   int row = y & TILE_MASK;
+   int stepX = seg->stepX;
+   int stepY = seg->stepY;
+   int majorDelta = seg->majorDelta;
+   int minorDelta = seg->minorDelta;
+   int decision = seg->decision;
+   Tile* tile = makeTile( frame, x >> TILE_SHIFT, y >> TILE_SHIFT );
+   int ii;
+
+   for ( ii = 0; ii < seg->count; ii++ )
+   {
+      if ( tile != NULL )
+      {
+         tile->cells[( row << TILE_SHIFT ) + column] = ink;
+         widenRow( tile, row, column, column );
+      }
+
+      x += stepX;
+      column += stepX;
+
+      decision += minorDelta;
+      if ( decision >= majorDelta )
+      {
+         decision -= majorDelta;
+         y += stepY;
+         row += stepY;
+      }
+
+      /* Crossing into the next tile */
+      if ( ( ( column < 0 ) || ( column >= TILE_SIZE ) || ( row < 0 ) || ( row >= TILE_SIZE ) ) &&
+           ( ii + 1 < seg->count ) )
+      {
+         tile = makeTile( frame, x >> TILE_SHIFT, y >> TILE_SHIFT );
+         column = x & TILE_MASK;
+         row = y & TILE_MASK;
+      }
+   }
+}
+
+
+/* NAME: lineAlongY()
+ * PURPOSE: Draws a segment that runs further along y than along x.
+ * HOW IT WORKS: Bresenham's line algorithm with y as the major axis, the
+ *               same decisions line() in effects.c makes. Tracks the cell's
+ *               column and row within its tile, stepping one row per cell
+ *               drawn and one column across whenever the decision value
+ *               overflows. The next tile is only looked up once the line
+ *               steps off the edge of the current one.
+ * RELATIONS:
+ *    frameSegment() - Draws diagonal segments in the four octants either
+ *                     side of the y axis.
+ * IMPORTS:
+ *    frame - The framebuffer to draw into.
+ *    seg - The segment to draw.
+ *    pattern - The character to draw.
+ * EXPORTS:
+ *    none
+ */
+
+static void lineAlongY( FrameBuffer* frame, Segment* seg, char pattern )
+{
+   Cell ink = makeInk( frame, pattern );
+   int x = seg->x;
+   int y = seg->y;
+   int column = x & TILE_MASK;
+   int row = y & TILE_MASK;
+   int stepX = seg->stepX;
+   int stepY = seg->stepY;
+   int majorDelta = seg->majorDelta;
+   int minorDelta = seg->minorDelta;
+   int decision = seg->decision;
+   Tile* tile = makeTile( frame, x >> TILE_SHIFT, y >> TILE_SHIFT );
+   int ii;
+
+   for ( ii = 0; ii < seg->count; ii++ )
+   {
+      if ( tile != NULL )
+      {
+         tile->cells[( row << TILE_SHIFT ) + column] = ink;
+         widenRow( tile, row, column, column );
+      }
+
+      y += stepY;
+      row += stepY;
+
+      decision += minorDelta;
+      if ( decision >= majorDelta )
+      {
+         decision -= majorDelta;
+         x += stepX;
+         column += stepX;
+      }
+
+      /* Crossing into the next tile */
+      if ( ( ( column < 0 ) || ( column >= TILE_SIZE ) || ( row < 0 ) || ( row >= TILE_SIZE ) ) &&
+           ( ii + 1 < seg->count ) )
+      {
+         tile = makeTile( frame, x >> TILE_SHIFT, y >> TILE_SHIFT );
+         column = x & TILE_MASK;
+         row = y & TILE_MASK;
+      }
+   }
+}
+
+
+/* NAME: makeInk()
+ * PURPOSE: Prepares the cell drawn by the line kernels.
+ * HOW IT WORKS: Combines the pattern with the framebuffer's current colours.
+ * RELATIONS:
+ *    fillRow()/fillColumn()/lineAlongX()/lineAlongY() - Copy the cell into
+ *                                                       each cell drawn.
+ * IMPORTS:
+ *    frame - The framebuffer being drawn into.
+ *    pattern - The character to draw.
+ * EXPORTS:
+ *    ink - The cell to draw.
+ */
+
+static Cell makeInk( FrameBuffer* frame, char pattern )
+{
+   Cell ink;
+
+   ink.pattern = pattern;
+   ink.fgColour = ( signed char )frame->fgColour;
+   ink.bgColour = ( signed char )frame->bgColour;
+
+   return ink;
+}
+
+
+/* NAME: widenRow()
+ * PURPOSE: Widens the drawn extent of a row of a tile to include the
+ *          columns first to last.
+ * HOW IT WORKS: Moves whichever end of the extent the columns lie beyond.
+ * RELATIONS:
+ *    fillRow()/fillColumn()/lineAlongX()/lineAlongY() - Record each cell
+ *                                                       drawn.
+ * IMPORTS:
+ *    tile - The tile drawn into.
+ *    row - The row of the tile drawn to.
+ *    first/last - Leftmost and rightmost column of the tile drawn.
+ * EXPORTS:
+ *    none
+ */
+
+static void widenRow( Tile* tile, int row, int first, int last )
+{
+   if ( ( tile->rowFirst[row] == -1 ) || ( first < tile->rowFirst[row] ) )
+   {
+      tile->rowFirst[row] = ( signed char )first;
+   }
+   if ( last > tile->rowLast[row] )
+   {
+      tile->rowLast[row] = ( signed char )last;
+   }
+}
+
+
+/* NAME: findTile()
+ * PURPOSE: Finds a tile of the framebuffer, if it has been drawn to.
+ * HOW IT WORKS: - Checks the tile found last first, as lines and flushes
+ *                 visit many cells of one tile in a row.
+ *               - Otherwise probes the hash table from the tile's hash,
+ *                 one slot at a time, until the tile or an empty slot.
+ * RELATIONS:
+ *    makeTile() - Finds a tile before making it.
+ *    getCell() - Finds the tile holding a cell.
+ * IMPORTS:
+ *    frame - The framebuffer holding the tile, or NULL.
+ *    tileX/tileY - Position of the tile, in tiles.
+ * EXPORTS:
+ *    tile - Pointer to the tile, or NULL if it was never drawn to.
+ */
+
+static Tile* findTile( FrameBuffer* frame, int tileX, int tileY )
+{
+   Tile* tile = NULL;
+   unsigned long slot;
+
+   if ( frame != NULL )
+   {
+      tile = frame->lastTile;
+      if ( ( tile == NULL ) || ( tile->tileX != tileX ) || ( tile->tileY != tileY ) )
+      {
+         slot = hashTile( tileX, tileY ) & ( frame->capacity - 1 );
+         tile = frame->tiles[slot];
+         while ( ( tile != NULL ) && ( ( tile->tileX != tileX ) || ( tile->tileY != tileY ) ) )
+         {
+            slot = ( slot + 1 ) & ( frame->capacity - 1 );
+            tile = frame->tiles[slot];
+         }
+
+         if ( tile != NULL )
+         {
+            frame->lastTile = tile;
+         }
+      }
+   }
+
+   return tile;
+}
+
+
+/* NAME: makeTile()
+ * PURPOSE: Finds a tile of the framebuffer, allocating it the first time it
+ *          is drawn to.
+ * HOW IT WORKS: A new tile starts blank, with no row drawn to, and goes in
+ *               the first empty slot from its hash. The table doubles first
+ *               if it would become more than half full, keeping probes
+ *               short.
+ * RELATIONS:
+ *    fillRow()/fillColumn()/lineAlongX()/lineAlongY() - Find the tile each
+ *                                                       cell is drawn into.
+ * IMPORTS:
+ *    frame - The framebuffer holding the tile.
+ *    tileX/tileY - Position of the tile, in tiles.
+ * EXPORTS:
+ *    tile - Pointer to the tile, or NULL if memory ran out.
+ */
+
+static Tile* makeTile( FrameBuffer* frame, int tileX, int tileY )
+{
+   Tile* tile = findTile( frame, tileX, tileY );
+   unsigned long slot;
+
+   if ( ( tile == NULL ) && ( ( 2 * ( frame->count + 1 ) <= frame->capacity ) || ( growTable( frame ) != 0 ) ) )
+   {
+      /* calloc() leaves every cell blank */
+      tile = ( Tile* )calloc( 1, sizeof( Tile ) );
+      if ( tile != NULL )
+      {
+         tile->tileX = tileX;
+         tile->tileY = tileY;
+         memset( tile->rowFirst, -1, sizeof( tile->rowFirst ) );
+         memset( tile->rowLast, -1, sizeof( tile->rowLast ) );
+
+         slot = hashTile( tileX, tileY ) & ( frame->capacity - 1 );
+         while ( frame->tiles[slot] != NULL )
+         {
+            slot = ( slot + 1 ) & ( frame->capacity - 1 );
+         }
+         frame->tiles[slot] = tile;
+         frame->count++;
+         frame->lastTile = tile;
+      }
+   }
+
+   return tile;
+}
+
+
+/* NAME: growTable()
+ * PURPOSE: Doubles the number of slots in the framebuffer's table of tiles.
+ * HOW IT WORKS: Allocates the larger table and moves every tile into the
+ *               first empty slot from its hash.
+ * RELATIONS:
+ *    makeTile() - Grows the table before it becomes more than half full.
+ * IMPORTS:
+ *    frame - The framebuffer whose table to grow.
+ * EXPORTS:
+ *    isGrown - Boolean evaluating to '0' (FALSE) if memory ran out, leaving
+ *              the table as it was, or '-1' (TRUE) if it grew.
+ */
+
+static int growTable( FrameBuffer* frame )
+{
+   int isGrown = 0;
+   int capacity = 2 * frame->capacity;
+   Tile** tiles = ( Tile** )calloc( capacity, sizeof( Tile* ) );
+   Tile* tile;
+   unsigned long slot;
+   int ii;
+
+   if ( tiles != NULL )
+   {
+      for ( ii = 0; ii < frame->capacity; ii++ )
+      {
+         tile = frame->tiles[ii];
+         if ( tile != NULL )
+         {
+            slot = hashTile( tile->tileX, tile->tileY ) & ( capacity - 1 );
+            while ( tiles[slot] != NULL )
+            {
+               slot = ( slot + 1 ) & ( capacity - 1 );
+            }
+            tiles[slot] = tile;
+         }
+      }
+
+      free( frame->tiles );
+      frame->tiles = tiles;
+      frame->capacity = capacity;
+      isGrown = -1;
+   }
+
+   return isGrown;
+}
+
+
+/* NAME: hashTile()
+ * PURPOSE: Hashes the position of a tile.
+ * HOW IT WORKS: Multiplies each coordinate by a different large odd constant
+ *               and mixes the high bits down, so neighbouring tiles spread
+ *               across the table.
+ * RELATIONS:
+ *    findTile()/makeTile()/growTable() - Find the first slot to probe.
+ * IMPORTS:
+ *    tileX/tileY - Position of the tile, in tiles.
+ * EXPORTS:
+ *    hash - The hash of the position.
+ */
+
+static unsigned long hashTile( int tileX, int tileY )
+{
+   unsigned long hash = ( unsigned long )tileX * 2654435761UL + ( unsigned long )tileY * 40503UL;
+
+   return hash ^ ( hash >> 15 );
+}
+
+
+/* NAME: flushFrame()
+ * PURPOSE: Writes the viewport of the framebuffer to the terminal in a
+ *          single pass, sending only the cells that differ from the frame
+ *          already shown (if any).
+ * HOW IT WORKS: - Lists the tiles of either frame within the viewport,
+ *                 sorted by row of tiles and then column, so tiles never
+ *                 drawn to in both frames cost no work at all.
+ *               - Walks each row of the viewport through those tiles in
+ *                 order, between the leftmost and rightmost column drawn to
+ *                 in either frame.
+ *               - Each cell differing from the shown frame is sent, and a
+ *                 cell no longer drawn to is blanked. Without a shown frame
+ *                 the terminal is taken as freshly cleared.
+ *               - Cursor moves are as short as possible (see formatMove()),
+ *                 and short gaps between changed cells are printed again
+ *                 when cheaper than moving over them (see appendGap()).
+ *               - A run of identical cells is sent as the first cell and a
+ *                 REP escape when shorter (see appendRepeat()).
+ *               - Colour escapes are only added when the colours change.
+ *               - The terminal is left in the framebuffer's current colours,
+ *                 as if each colour command had been sent directly.
+ *               - The whole frame is built in memory and handed to write()
+ *                 at once.
+ * RELATIONS:
+ *    draw() - Flushes the frame once every command has been drawn.
+ * IMPORTS:
+ *    frame - The framebuffer to write out.
+ *    shown - The framebuffer currently on the terminal, NULL if the terminal
+ *            was just cleared.
+ *    view - The rectangle of the canvas to show, placed at the top left of
+ *           the terminal.
+ * EXPORTS:
+ *    none
+ */
+
+void flushFrame( FrameBuffer* frame, FrameBuffer* shown, Viewport* view )
+{
+   Terminal term;
+   TileKey* keys;
+   Tile* tile;
+   Tile* old;
+   int count = frame->count;
+   int right = view->left + view->width - 1;
+   int bottom = view->top + view->height - 1;
+   int band, next, bandLast, ii, first, last, sent, x, y;
+   ssize_t written;
+   size_t offset = 0;
+
+   term.out.length = 0;
+   term.out.capacity = 0;
+   term.out.data = NULL;
+   term.left = view->left;
+   term.top = view->top;
+   term.width = view->width;
+   term.x = -1;
+   term.y = -1;
+   term.fgColour = DEFAULT_COLOUR;
+   term.bgColour = DEFAULT_COLOUR;
+
+   if ( shown != NULL )
+   {
+      /* The terminal kept the colours the shown frame finished with */
+      term.fgColour = shown->fgColour;
+      term.bgColour = shown->bgColour;
+      count += shown->count;
+   }
+
+   keys = ( TileKey* )malloc( ( count + 1 ) * sizeof( TileKey ) );
+   if ( keys == NULL )
+   {
+      printf( "Error: frame could not be flushed\n" );
+      count = 0;
+   }
+   else
+   {
+      count = collectKeys( frame, view, keys, 0 );
+      count = collectKeys( shown, view, keys, count );
+      qsort( keys, count, sizeof( TileKey ), &compareKeys );
+   }
+
+   /* Each band of tiles sharing a row of tiles */
+   for ( band = 0; band < count; band = next )
+   {
+      next = band + 1;
+      while ( ( next < count ) && ( keys[next].tileY == keys[band].tileY ) )
+      {
+         next++;
+      }
+
+      /* Rows of the band within the viewport */
+      y = keys[band].tileY << TILE_SHIFT;
+      bandLast = y + TILE_MASK;
+      if ( y < view->top )
+      {
+         y = view->top;
+      }
+      if ( bandLast > bottom )
+      {
+         bandLast = bottom;
+      }
+
+      for ( ; y <= bandLast; y++ )
+      {
+         /* A run repeated into the next tile leaves cells already sent */
+         sent = view->left - 1;
+
+         for ( ii = band; ii < next; ii++ )
+         {
+            /* The same tile listed by both frames is only walked once */
+            if ( ( ii == band ) || ( keys[ii].tileX != keys[ii - 1].tileX ) )
+            {
+               tile = findTile( frame, keys[ii].tileX, keys[ii].tileY );
+               old = findTile( shown, keys[ii].tileX, keys[ii].tileY );
+
+               /* Union of the row's drawn extent in both tiles */
+               first = -1;
+               last = -1;
+               if ( tile != NULL )
+               {
+                  first = tile->rowFirst[y & TILE_MASK];
+                  last = tile->rowLast[y & TILE_MASK];
+               }
+               if ( ( old != NULL ) && ( old->rowFirst[y & TILE_MASK] != -1 ) )
+               {
+                  if ( ( first == -1 ) || ( old->rowFirst[y & TILE_MASK] < first ) )
+                  {
+                     first = old->rowFirst[y & TILE_MASK];
+                  }
+                  if ( old->rowLast[y & TILE_MASK] > last )
+                  {
+                     last = old->rowLast[y & TILE_MASK];
+                  }
+               }
+
+               if ( first != -1 )
+               {
+                  first += keys[ii].tileX << TILE_SHIFT;
+                  last += keys[ii].tileX << TILE_SHIFT;
+                  if ( first < view->left )
+                  {
+                     first = view->left;
+                  }
+                  if ( last > right )
+                  {
+                     last = right;
+                  }
+                  if ( first <= sent )
+                  {
+                     first = sent + 1;
+                  }
+               }
+
+               for ( x = first; ( first != -1 ) && ( x <= last ); x++ )
+               {
+                  if ( cellsDiffer( getCell( frame, x, y ), getCell( shown, x, y ) ) != 0 )
+                  {
+                     appendGap( &term, frame, shown, x, y );
+                     appendCell( &term, frame, x, y );
+                     x = appendRepeat( &term, frame, shown, x, y, right );
+                     sent = x;
+                  }
+               }
+            }
+         }
+      }
+   }
+
+   appendColours( &term, frame->fgColour, frame->bgColour );
+
+   /* Anything printed with stdio must reach the terminal first */
+   fflush( stdout );
+
+   while ( offset < term.out.length )
+   {
+      written = write( STDOUT_FILENO, term.out.data + offset, term.out.length - offset );
+      if ( written <= 0 )
+      {
+         perror( "Error: frame could not be written\n" );
+         offset = term.out.length;
+      }
+      else
+      {
+         offset += ( size_t )written;
+      }
+   }
+
+   free( keys );
+   free( term.out.data );
+}
+
+
+/* NAME: collectKeys()
+ * PURPOSE: Lists the tiles of a framebuffer that overlap the viewport.
+ * HOW IT WORKS: Walks every slot of the table, adding the position of each
+ *               tile with any cell within the viewport.
+ * RELATIONS:
+ *    flushFrame() - Lists the tiles of both frames to walk.
+ * IMPORTS:
+ *    frame - The framebuffer whose tiles to list, or NULL.
+ *    view - The rectangle of the canvas shown.
+ *    keys - List to add to, with room for every tile.
+ *    count - Number of tiles already in the list.
+ * EXPORTS:
+ *    count - Number of tiles in the list afterwards.
+ */
+
+static int collectKeys( FrameBuffer* frame, Viewport* view, TileKey* keys, int count )
+{
+   Tile* tile;
+   long left, top;
+   int ii;
+
+   for ( ii = 0; ( frame != NULL ) && ( ii < frame->capacity ); ii++ )
+   {
+      tile = frame->tiles[ii];
+      if ( tile != NULL )
+      {
+         left = ( long )tile->tileX << TILE_SHIFT;
+         top = ( long )tile->tileY << TILE_SHIFT;
+         if ( ( left + TILE_MASK >= view->left ) && ( left < ( long )view->left + view->width ) &&
+              ( top + TILE_MASK >= view->top ) && ( top < ( long )view->top + view->height ) )
+         {
+            keys[count].tileX = tile->tileX;
+            keys[count].tileY = tile->tileY;
+            count++;
+         }
+      }
+   }
+
+   return count;
+}
+
+
+/* NAME: compareKeys()
+ * PURPOSE: Orders tiles by row of tiles and then by column, for qsort().
+ * HOW IT WORKS: Compares the rows, then the columns if the rows are equal.
+ * RELATIONS:
+ *    flushFrame() - Sorts the tiles into the order they are shown.
+ * IMPORTS:
+ *    first/second - The TileKeys to compare.
+ * EXPORTS:
+ *    order - Negative, zero or positive as first comes before, with or
+ *            after second.
+ */
+
+static int compareKeys( const void* first, const void* second )
+{
+   const TileKey* one = ( const TileKey* )first;
+   const TileKey* two = ( const TileKey* )second;
+   int order = 0;
+
+   if ( one->tileY != two->tileY )
+   {
+      order = ( one->tileY < two->tileY ) ? -1 : 1;
+   }
+   else if ( one->tileX != two->tileX )
+   {
+      order = ( one->tileX < two->tileX ) ? -1 : 1;
+   }
+
+   return order;
+}
+
+
+/* NAME: freeFrame()
+ * PURPOSE: Deallocates the framebuffer along with its tiles.
+ * HOW IT WORKS: Frees every tile in the table, the table and then the struct
+ *               itself.
+ * RELATIONS:
+ *    draw() - Deallocates the framebuffer it replaces on the terminal.
+ *    main() - Deallocates the last framebuffer shown.
+ * IMPORTS:
+ *    frame - The framebuffer to deallocate.
+ * EXPORTS:
+ *    none
+ */
+
+void freeFrame( FrameBuffer* frame )
+{
+   int ii;
+
+   for ( ii = 0; ii < frame->capacity; ii++ )
+   {
+      free( frame->tiles[ii] );
+   }
+   free( frame->tiles );
+   free( frame );
+}
+
+
+/* NAME: forgetShown()
+ * PURPOSE: Drops the frame known to be on the terminal, once something else
+ *          has been printed over it.
+ * HOW IT WORKS: Deallocates the shown frame, if any, and sets it to NULL so
+ *               the next frame is drawn in full on a cleared terminal.
+ * RELATIONS:
+ *    processFile() - Forgets the shown frame before printing any errors.
+ *    draw() - Forgets the shown frame when drawing straight to the terminal.
+ * IMPORTS:
+ *    shown - Points to the frame shown on the terminal, or to NULL.
+ * EXPORTS:
+ *    none
+ */
+
+void forgetShown( FrameBuffer** shown )
+{
+   if ( *shown != NULL )
+   {
+      freeFrame( *shown );
+      *shown = NULL;
+   }
+}
+
+
+/* NAME: appendBytes()
+ * PURPOSE: Appends bytes to the end of an output buffer.
+ * HOW IT WORKS: Doubles the buffer's capacity whenever the bytes don't fit.
+ *               Running out of memory drops the bytes.
+ * RELATIONS:
+ *    flushFrame() - Builds the frame in an output buffer.
+ * IMPORTS:
+ *    out - The buffer to append to.
+ *    bytes - The bytes to append.
+ *    count - Number of bytes to append.
+ * EXPORTS:
+ *    none
+ */
+
+static void appendBytes( OutBuffer* out, const char* bytes, size_t count )
+{
+   size_t capacity = out->capacity;
+   char* grown;
+
+   if ( out->length + count > capacity )
+   {
+      if ( capacity == 0 )
+      {
+         capacity = 4096;
+      }
+      while ( out->length + count > capacity )
+      {
+         capacity *= 2;
+      }
+
+      grown = ( char* )realloc( out->data, capacity );
+      if ( grown != NULL )
+      {
+         out->data = grown;
+         out->capacity = capacity;
+      }
+   }
+
+   if ( out->length + count <= out->capacity )
+   {
+      memcpy( out->data + out->length, bytes, count );
+      out->length += count;
+   }
+}
+
+
+/* NAME: appendColours()
+ * PURPOSE: Appends the escapes switching the terminal to the given colours,
+ *          if it isn't using them already.
+ * HOW IT WORKS: - Matches the escapes of setFgColour() and setBgColour(),
+ *                 with bright foreground colours (8-15) shown in bold.
+ *               - Returning a colour to the terminal default resets both
+ *                 colours, so the other colour is set again afterwards.
+ * RELATIONS:
+ *    flushFrame() - Leaves the terminal in the framebuffer's colours.
+ *    appendCell() - Sets the colours of each cell.
+ * IMPORTS:
+ *    term - The terminal output, whose colours are updated to match.
+ *    fgColour/bgColour - The colours wanted.
+ * EXPORTS:
+ *    none
+ */
+
+static void appendColours( Terminal* term, int fgColour, int bgColour )
+{
+   char escape[32];
+
+   if ( ( ( fgColour == DEFAULT_COLOUR ) && ( term->fgColour != DEFAULT_COLOUR ) ) ||
+        ( ( bgColour == DEFAULT_COLOUR ) && ( term->bgColour != DEFAULT_COLOUR ) ) )
+   {
+      appendBytes( &( term->out ), "\033[0m", 4 );
+      term->fgColour = DEFAULT_COLOUR;
+      term->bgColour = DEFAULT_COLOUR;
+   }
+
+   if ( fgColour != term->fgColour )
+   {
+      sprintf( escape, "\033[%d;%dm", ( ( fgColour % 16 ) >= 8 ) ? 1 : 22, ( fgColour % 8 ) + 30 );
+      appendBytes( &( term->out ), escape, strlen( escape ) );
+      term->fgColour = fgColour;
+   }
+
+   if ( bgColour != term->bgColour )
+   {
+      sprintf( escape, "\033[%dm", ( bgColour % 8 ) + 40 );
+      appendBytes( &( term->out ), escape, strlen( escape ) );
+      term->bgColour = bgColour;
+   }
+}
+
+
+/* NAME: formatMove()
+ * PURPOSE: Formats the shortest escape moving the cursor to (x, y) on the
+ *          terminal.
+ * HOW IT WORKS: - Nothing is needed when the cursor is already in place.
+ *               - An absolute move (CUP) always works. When the cursor
+ *                 position is known, a relative move up/down followed by
+ *                 either a relative move left/right or a carriage return
+ *                 and a move right is tried as well, keeping whichever is
+ *                 shortest.
+ * RELATIONS:
+ *    appendCell() - Moves to each cell sent.
+ *    appendGap() - Weighs a move against printing a gap of cells again.
+ * IMPORTS:
+ *    term - The terminal output holding the cursor position.
+ *    x/y - Column and row of the terminal to move to.
+ *    escape - At least 32 chars to format the move into.
+ * EXPORTS:
+ *    length - Length of the formatted move.
+ */
+
+static int formatMove( Terminal* term, int x, int y, char* escape )
+{
+   char vertical[16];
+   char horizontal[16];
+   char relative[36];
+
+   escape[0] = '\0';
+
+   if ( ( term->x != x ) || ( term->y != y ) )
+   {
+      sprintf( escape, "\033[%d;%dH", y + 1, x + 1 );
+
+      if ( term->x >= 0 )
+      {
+         formatStep( vertical, y - term->y, 'B', 'A' );
+
+         /* Moving right or left from the current column */
+         formatStep( horizontal, x - term->x, 'C', 'D' );
+         sprintf( relative, "%s%s", vertical, horizontal );
+         if ( strlen( relative ) < strlen( escape ) )
+         {
+            strcpy( escape, relative );
+         }
+
+         /* Returning to the first column and moving right from there */
+         formatStep( horizontal, x, 'C', 'D' );
+         sprintf( relative, "%s\r%s", vertical, horizontal );
+         if ( strlen( relative ) < strlen( escape ) )
+         {
+            strcpy( escape, relative );
+         }
+      }
+   }
+
+   return strlen( escape );
+}
+
+
+/* NAME: formatStep()
+ * PURPOSE: Formats a relative cursor move along one axis.
+ * HOW IT WORKS: Uses the forward escape for a positive distance and the
+ *               backward escape for a negative one, leaving out a count of
+ *               one. A distance of zero needs no escape.
+ * RELATIONS:
+ *    formatMove() - Builds relative moves from a step along each axis.
+ * IMPORTS:
+ *    escape - At least 16 chars to format the step into.
+ *    distance - Number of cells to move.
+ *    forward/backward - Final char of the escape in each direction.
+ * EXPORTS:
+ *    none
+ */
+
+static void formatStep( char* escape, int distance, char forward, char backward )
+{
+   char direction = forward;
+
+   escape[0] = '\0';
+
+   if ( distance < 0 )
+   {
+      distance = -distance;
+      direction = backward;
+   }
+
+   if ( distance == 1 )
+   {
+      sprintf( escape, "\033[%c", direction );
+   }
+   else if ( distance > 1 )
+   {
+      sprintf( escape, "\033[%d%c", distance, direction );
+   }
+}
+
+
+/* NAME: appendGap()
+ * PURPOSE: Prints the unchanged cells between the cursor and a changed cell
+ *          again when that is cheaper than moving over them.
+ * HOW IT WORKS: Only applies to a gap to the right of the cursor on the same
+ *               row, no longer than the move it replaces, whose cells are
+ *               all unchanged, drawn to and in the colours already in use.
+ * RELATIONS:
+ *    flushFrame() - Coalesces nearby changed cells into a single run.
+ * IMPORTS:
+ *    term - The terminal output.
+ *    frame - The framebuffer being flushed.
+ *    shown - The framebuffer on the terminal, or NULL.
+ *    x/y - The changed cell about to be sent, on the canvas.
+ * EXPORTS:
+ *    none
+ */
+
+static void appendGap( Terminal* term, FrameBuffer* frame, FrameBuffer* shown, int x, int y )
+{
+   char escape[32];
+   Cell* cell;
+   int isCheaper = 0;
+   int column = x - term->left;
+   int gx;
+
+   if ( ( term->y == y - term->top ) && ( term->x >= 0 ) && ( term->x < column ) )
+   {
+      if ( column - term->x <= formatMove( term, column, y - term->top, escape ) )
+      {
+         isCheaper = -1;
+      }
+
+      for ( gx = term->x + term->left; ( isCheaper != 0 ) && ( gx < x ); gx++ )
+      {
+         cell = getCell( frame, gx, y );
+         if ( ( cell->pattern == '\0' ) || ( cellsDiffer( cell, getCell( shown, gx, y ) ) != 0 ) ||
+              ( cell->fgColour != term->fgColour ) || ( cell->bgColour != term->bgColour ) )
+         {
+            isCheaper = 0;
+         }
+      }
+
+      while ( ( isCheaper != 0 ) && ( term->x < column ) )
+      {
+         appendBytes( &( term->out ), &( getCell( frame, term->x + term->left, y )->pattern ), 1 );
+         term->x++;
+      }
+   }
+}
+
+
+/* NAME: appendCell()
+ * PURPOSE: Appends a single cell of the framebuffer to the terminal output.
+ * HOW IT WORKS: Moves the cursor to the cell, switches colours if needed and
+ *               prints the pattern. A blank cell is printed as a space in
+ *               the terminal's default colours, as left by clearing it.
+ * RELATIONS:
+ *    flushFrame() - Sends each changed cell.
+ * IMPORTS:
+ *    term - The terminal output.
+ *    frame - The framebuffer holding the cell.
+ *    x/y - Column and row of the cell on the canvas.
+ * EXPORTS:
+ *    none
+ */
+
+static void appendCell( Terminal* term, FrameBuffer* frame, int x, int y )
+{
+   char escape[32];
+   Cell* cell = getCell( frame, x, y );
+
+   appendBytes( &( term->out ), escape, formatMove( term, x - term->left, y - term->top, escape ) );
+
+   if ( cell->pattern == '\0' )
+   {
+      appendColours( term, DEFAULT_COLOUR, DEFAULT_COLOUR );
+      appendBytes( &( term->out ), " ", 1 );
+   }
+   else
+   {
+      appendColours( term, cell->fgColour, cell->bgColour );
+      appendBytes( &( term->out ), &( cell->pattern ), 1 );
+   }
+
+   term->x = x - term->left + 1;
+   term->y = y - term->top;
+   forgetMargin( term );
+}
+
+
+/* NAME: appendRepeat()
+ * PURPOSE: Repeats the cell just sent over the identical cells following it,
+ *          using a single REP escape.
+ * HOW IT WORKS: - Follows the run of cells that look the same as the cell
+ *                 at (x, y), up to the last cell in the run that changed.
+ *                 Unchanged cells within the run are simply sent again.
+ *               - The ECMA-48 REP escape (CSI n b) repeats the last printed
+ *                 character n times in the colours in use, so it is used
+ *                 only when shorter than printing the n cells one by one.
+ * RELATIONS:
+ *    flushFrame() - Coalesces runs of identical changed cells.
+ * IMPORTS:
+ *    term - The terminal output, with the cursor just after (x, y).
+ *    frame - The framebuffer being flushed.
+ *    shown - The framebuffer on the terminal, or NULL.
+ *    x/y - The cell just sent, on the canvas.
+ *    last - Last column of the row to consider.
+ * EXPORTS:
+ *    end - Column of the last cell sent, x if the run was not repeated.
+ */
+
+static int appendRepeat( Terminal* term, FrameBuffer* frame, FrameBuffer* shown, int x, int y, int last )
+{
+   char escape[32];
+   Cell* cell = getCell( frame, x, y );
+   int end = x;
+   int rx;
+
+   for ( rx = x + 1; ( rx <= last ) && ( cellsDiffer( getCell( frame, rx, y ), cell ) == 0 ); rx++ )
+   {
+      if ( cellsDiffer( getCell( frame, rx, y ), getCell( shown, rx, y ) ) != 0 )
+      {
+         end = rx;
+      }
+   }
+
+   if ( end > x )
+   {
+      sprintf( escape, "\033[%db", end - x );
+      if ( ( int )strlen( escape ) < end - x )
+      {
+         appendBytes( &( term->out ), escape, strlen( escape ) );
+         term->x = end - term->left + 1;
+         forgetMargin( term );
+         x = end;
+      }
+   }
+
+   return x;
+}
+
+
+/* NAME: forgetMargin()
+ * PURPOSE: Forgets the cursor's column once a cell is sent in the last
+ *          column of the viewport.
+ * HOW IT WORKS: The viewport can end at the terminal's right margin, where
+ *               the cursor stays on the cell just printed rather than
+ *               moving past it, so the next move is made absolute.
+ * RELATIONS:
+ *    appendCell()/appendRepeat() - Check the column after each cell sent.
+ * IMPORTS:
+ *    term - The terminal output.
+ * EXPORTS:
+ *    none
+ */
+
+static void forgetMargin( Terminal* term )
+{
+   if ( term->x >= term->width )
+   {
+      term->x = -1;
+   }
+}
+
+
+/* NAME: getCell()
+ * PURPOSE: Finds the cell of a framebuffer at (x, y).
+ * HOW IT WORKS: Cells off the canvas, in tiles never drawn to, or of a
+ *               missing framebuffer are blank.
+ * RELATIONS:
+ *    flushFrame() - Compares the cells of two frames.
+ * IMPORTS:
+ *    frame - The framebuffer holding the cell, or NULL.
+ *    x/y - Column and row of the cell on the canvas.
+ * EXPORTS:
+ *    cell - Pointer to the cell, which must not be changed.
+ */
+
+static Cell* getCell( FrameBuffer* frame, int x, int y )
+{
+   Cell* cell = &blankCell;
+   Tile* tile;
+
+   if ( ( x >= 0 ) && ( y >= 0 ) )
+   {
+      tile = findTile( frame, x >> TILE_SHIFT, y >> TILE_SHIFT );
+      if ( tile != NULL )
+      {
+         cell = &( tile->cells[( ( y & TILE_MASK ) << TILE_SHIFT ) + ( x & TILE_MASK )] );
+      }
+   }
+
+   return cell;
+}
+
+
+/* NAME: cellsDiffer()
+ * PURPOSE: Checks if two cells look different on the terminal.
+ * HOW IT WORKS: Blank cells look the same whatever colours they hold, other
+ *               cells must match in pattern and both colours.
+ * RELATIONS:
+ *    flushFrame() - Finds the cells that changed since the shown frame.
+ * IMPORTS:
+ *    cell/other - The cells to compare.
+ * EXPORTS:
+ *    differ - Boolean evaluating to '-1' (TRUE) if the cells differ.
+ */
+
+static int cellsDiffer( Cell* cell, Cell* other )
+{
+   int differ = 0;
+
+   if ( cell->pattern != other->pattern )
+   {
+      differ = -1;
+   }
+   else if ( ( cell->pattern != '\0' ) &&
+             ( ( cell->fgColour != other->fgColour ) || ( cell->bgColour != other->bgColour ) ) )
+   {
+      differ = -1;
+   }
+
+   return differ;
+}
@@ -0,0 +1,87 @@
+/* FILE: framebuffer.h
+ * AUTHOR: Kyle Notani | 19149918
+ * UNIT: UCP COMP1000
+ * PURPOSE: Header file associated with framebuffer.c
+ */
+
+#ifndef FRAMEBUFFER_H
+   #define FRAMEBUFFER_H
+
+   #include "viewport.h"
+
+   /* Tiles are TILE_SIZE by TILE_SIZE cells, TILE_SIZE being 2 to the power
+    * of TILE_SHIFT */
+   #define TILE_SHIFT 6
+   #define TILE_SIZE ( 1 << TILE_SHIFT )
+   #define TILE_MASK ( TILE_SIZE - 1 )
+
+   /* Number of slots the table of tiles starts with, a power of 2 */
+   #define INITIAL_TILES 64
+
+   /* Colour code of a cell drawn before any colour command, left as the
+    * terminal's own default colour */
+   #define DEFAULT_COLOUR -1
+
+   /* Stores a single terminal cell */
+   typedef struct
+   {
+      /* Printed character, '\0' for a cell never drawn to */
+      char pattern;
+      /* Foreground colour code 0-15 */
+      signed char fgColour;
+      /* Background colour code 0-7 */
+      signed char bgColour;
+   } Cell;
+
+   /* Stores a square block of cells of the canvas in row-major order */
+   typedef struct
+   {
+      /* Position of the tile, in tiles from the canvas origin */
+      int tileX;
+      int tileY;
+      /* Leftmost and rightmost column drawn to within each row of the tile,
+       * -1 for a row never drawn to */
+      signed char rowFirst[TILE_SIZE];
+      signed char rowLast[TILE_SIZE];
+      Cell cells[TILE_SIZE * TILE_SIZE];
+   } Tile;
+
+   /* Stores an off-screen canvas of cells as the tiles drawn to so far, found
+    * through a hash table, so memory grows with what is drawn rather than
+    * with the size of the canvas */
+   typedef struct
+   {
+      /* Hash table of tiles, NULL for an empty slot */
+      Tile** tiles;
+      int capacity;
+      int count;
+      /* Tile most recently found, checked before the table */
+      Tile* lastTile;
+      /* Size of the canvas in cells */
+      int width;
+      int height;
+      /* Colours given to every cell drawn from now on */
+      int fgColour;
+      int bgColour;
+   } FrameBuffer;
+
+   /* Constructs an empty framebuffer for a canvas of width by height cells. */
+   FrameBuffer* constructFrame( int width, int height );
+
+   /* Draws a clipped line of a pattern into the framebuffer, visiting the
+    * same cells as line() in effects.c would along the segment. */
+   void frameSegment( FrameBuffer* frame, Segment* seg, char pattern );
+
+   /* Writes the viewport of the framebuffer to the terminal in a single pass,
+    * sending only the cells that differ from the frame already shown (if
+    * any). */
+   void flushFrame( FrameBuffer* frame, FrameBuffer* shown, Viewport* view );
+
+   /* Deallocates the framebuffer along with its tiles. */
+   void freeFrame( FrameBuffer* frame );
+
+   /* Deallocates the frame shown on the terminal, if any, and sets it to NULL
+    * so the next frame is drawn in full. */
+   void forgetShown( FrameBuffer** shown );
+
+#endif
@@ -0,0 +1,516 @@
+/*
+ * FILE: graphicslog.c
+ * AUTHOR: Kyle Notani | 19149918
+ * UNIT: UCP COMP1000
+ * PURPOSE: Append each DRAW and MOVE of a drawing to graphics.log as a short
+ *          binary record, written to the file on a thread of its own, and
+ *          turn the records back into the text of older logs on demand.
+ * OTHER: The drawing puts records into a ring buffer and the writing thread
+ *        takes them out, each side only ever storing its own count of the
+ *        bytes, so neither takes a lock while there is room and something
+ *        to write. A lock is only taken to wake a side that has gone to
+ *        sleep waiting on the other.
+ *        Coordinates are kept as the bits of their doubles, least
+ *        significant byte first, so the text decoded is exactly the text
+ *        the drawing would have printed.
+ *        '-1' evaluates to true, '0' evaluates to false.
+ */
+
+#define _POSIX_C_SOURCE 199506L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "graphicslog.h"
+
+static void putRecord( GraphicsLog* log, unsigned char* record, int length );
+static unsigned long waitForRoom( GraphicsLog* log, unsigned long head, int length );
+static void* writeLog( void* data );
+static void writeRing( GraphicsLog* log, unsigned long from, unsigned long to );
+static int putCoordinate( unsigned char* record, int length, double value );
+static double getCoordinate( unsigned char* bytes );
+
+
+/* NAME: openLog()
+ * PURPOSE: Opens the log for appending, marking the start of a drawing,
+ *          returning NULL if it can't be.
+ * HOW IT WORKS: - Opens the file to append to and sets up the ring buffer,
+ *                 putting in a LOG_RUN record, the magic and the version.
+ *               - Starts the writing thread. Should it not start, the
+ *                 drawing writes out the records itself whenever the ring
+ *                 buffer fills.
+ * RELATIONS:
+ *    beginDraw() - Opens graphics.log for each drawing.
+ * IMPORTS:
+ *    name - Name of the log file.
+ * EXPORTS:
+ *    log - The log on the heap, or NULL if the file can't be opened or
+ *          there is no memory.
+ */
+
+GraphicsLog* openLog( const char* name )
+{
+   GraphicsLog* log = NULL;
+   FILE* file = fopen( name, "ab" );
+   unsigned char record[LOG_MAGIC_LENGTH + 2];
+
+   if ( file != NULL )
+   {
+      log = ( GraphicsLog* )malloc( sizeof( GraphicsLog ) );
+      if ( log == NULL )
+      {
+         fclose( file );
+      }
+   }
+   if ( log != NULL )
+   {
+      log->file = file;
+      log->head = 0;
+      log->tail = 0;
+      log->lastX = 0.0;
+      log->lastY = 0.0;
+      log->isWriterAsleep = 0;
+      log->isDrawingAsleep = 0;
+      log->isClosing = 0;
+      log->isFailed = 0;
+      pthread_mutex_init( &( log->lock ), NULL );
+      pthread_cond_init( &( log->isReady ), NULL );
+      pthread_cond_init( &( log->hasRoom ), NULL );
+
+      record[0] = LOG_RUN;
+      memcpy( record + 1, LOG_MAGIC, LOG_MAGIC_LENGTH );
+      record[LOG_MAGIC_LENGTH + 1] = LOG_VERSION;
+      putRecord( log, record, LOG_MAGIC_LENGTH + 2 );
+
+      log->isThreaded = ( pthread_create( &( log->thread ), NULL, &writeLog, log ) == 0 ) ? -1 : 0;
+   }
+
+   return log;
+}
+
+
+/* NAME: logStep()
+ * PURPOSE: Records a DRAW or MOVE of the turtle from one point to another.
+ * HOW IT WORKS: Every step starts where the one before ended, from 0,0, so
+ *               a record usually holds only the type and end point, 17
+ *               bytes. A step starting anywhere else, to the last bit, is
+ *               recorded as LOG_DRAW_FROM or LOG_MOVE_FROM with its start
+ *               too.
+ * RELATIONS:
+ *    runStep() - Records each draw and move run.
+ * IMPORTS:
+ *    log - The log.
+ *    type - LOG_DRAW or LOG_MOVE.
+ *    startX/startY - Where the turtle started.
+ *    endX/endY - Where the turtle ended.
+ * EXPORTS:
+ *    none
+ */
+
+void logStep( GraphicsLog* log, int type, double startX, double startY, double endX, double endY )
+{
+   unsigned char record[LOG_RECORD_MAX];
+   int length = 1;
+
+   if ( ( memcmp( &startX, &( log->lastX ), sizeof( double ) ) != 0 ) ||
+        ( memcmp( &startY, &( log->lastY ), sizeof( double ) ) != 0 ) )
+   {
+      type = ( type == LOG_DRAW ) ? LOG_DRAW_FROM : LOG_MOVE_FROM;
+      length = putCoordinate( record, length, startX );
+      length = putCoordinate( record, length, startY );
+   }
+   record[0] = ( unsigned char )type;
+   length = putCoordinate( record, length, endX );
+   length = putCoordinate( record, length, endY );
+   log->lastX = endX;
+   log->lastY = endY;
+
+   putRecord( log, record, length );
+}
+
+
+/* NAME: closeLog()
+ * PURPOSE: Writes out every record left and closes the log.
+ * HOW IT WORKS: Tells the writing thread the drawing is done, waking it,
+ *               and waits for it to write out the rest and finish. Without
+ *               a writing thread the rest is written out here. A failure
+ *               to write is reported once the file is closed.
+ * RELATIONS:
+ *    endDraw() - Closes graphics.log once drawn.
+ * IMPORTS:
+ *    log - The log, deallocated.
+ * EXPORTS:
+ *    none
+ */
+
+void closeLog( GraphicsLog* log )
+{
+   if ( log->isThreaded != 0 )
+   {
+      __atomic_store_n( &( log->isClosing ), -1, __ATOMIC_SEQ_CST );
+      pthread_mutex_lock( &( log->lock ) );
+      pthread_cond_signal( &( log->isReady ) );
+      pthread_mutex_unlock( &( log->lock ) );
+      pthread_join( log->thread, NULL );
+   }
+   else
+   {
+      writeRing( log, log->tail, log->head );
+   }
+
+   if ( ( fclose( log->file ) != 0 ) || ( log->isFailed != 0 ) )
+   {
+      printf( "Error: log file can't be updated\n" );
+   }
+   pthread_cond_destroy( &( log->hasRoom ) );
+   pthread_cond_destroy( &( log->isReady ) );
+   pthread_mutex_destroy( &( log->lock ) );
+   free( log );
+}
+
+
+/* NAME: decodeLog()
+ * PURPOSE: Writes a log as the text of older logs, returning whether it was
+ *          read to the end.
+ * HOW IT WORKS: - A LOG_RUN record, checked for the magic and version, is
+ *                 written as "---", and starts the turtle back at 0,0.
+ *               - Each draw and move is written with the same format the
+ *                 drawing used to print, from where the last one ended
+ *                 unless the record gives its start.
+ *               - Any other byte starts a line of an older, text log,
+ *                 copied through as it is, so a log appended to since
+ *                 before it was binary reads back whole.
+ * RELATIONS:
+ *    main() - Decodes the log named on DecodeLog's command line.
+ * IMPORTS:
+ *    in - The log, read from the start.
+ *    out - Where the text is written.
+ * EXPORTS:
+ *    isRead - Boolean evaluating to '-1' (TRUE) if the whole log was
+ *             decoded, or '0' (FALSE) if a record was cut short or not
+ *             understood.
+ */
+
+int decodeLog( FILE* in, FILE* out )
+{
+   int isRead = -1;
+   double lastX = 0.0;
+   double lastY = 0.0;
+   double startX;
+   double startY;
+   unsigned char bytes[LOG_RECORD_MAX];
+   size_t length;
+   int c;
+
+   c = getc( in );
+   while ( ( c != EOF ) && ( isRead != 0 ) )
+   {
+      switch ( c )
+      {
+         case LOG_RUN:
+            if ( ( fread( bytes, 1, LOG_MAGIC_LENGTH + 1, in ) != LOG_MAGIC_LENGTH + 1 ) ||
+                 ( memcmp( bytes, LOG_MAGIC, LOG_MAGIC_LENGTH ) != 0 ) ||
+                 ( bytes[LOG_MAGIC_LENGTH] != LOG_VERSION ) )
+            {
+               isRead = 0;
+            }
+            else
+            {
+               fprintf( out, "---\n" );
+               lastX = 0.0;
+               lastY = 0.0;
+            }
+            break;
+         case LOG_DRAW:
+         case LOG_MOVE:
+         case LOG_DRAW_FROM:
+         case LOG_MOVE_FROM:
+            length = ( ( c == LOG_DRAW_FROM ) || ( c == LOG_MOVE_FROM ) ) ? 32 : 16;
+            if ( fread( bytes, 1, length, in ) != length )
+            {
+               isRead = 0;
+            }
+            else
+            {
+               startX = lastX;
+               startY = lastY;
+               if ( length == 32 )
+               {
+                  startX = getCoordinate( bytes );
+                  startY = getCoordinate( bytes + 8 );
+               }
+               lastX = getCoordinate( bytes + length - 16 );
+               lastY = getCoordinate( bytes + length - 8 );
+               fprintf( out, "%s (%7.3f,%7.3f)-(%7.3f,%7.3f)\n",
+                        ( ( c == LOG_DRAW ) || ( c == LOG_DRAW_FROM ) ) ? "DRAW" : "MOVE",
+                        startX, startY, lastX, lastY );
+            }
+            break;
+         default:
+            while ( ( c != EOF ) && ( c != '\n' ) )
+            {
+               putc( c, out );
+               c = getc( in );
+            }
+            if ( c == '\n' )
+            {
+               putc( c, out );
+            }
+            break;
+      }
+      c = getc( in );
+   }
+
+   return isRead;
+}
+
+
+/* NAME: putRecord()
+ * PURPOSE: Puts a record into the ring buffer.
+ * HOW IT WORKS: - Waits for room with waitForRoom() should the ring buffer
+ *                 be too full.
+ *               - Copies the record in, wrapping round the end, then stores
+ *                 the new count of bytes put in, which hands the record to
+ *                 the writing thread.
+ *               - Wakes the writing thread if it sleeps and a batch of
+ *                 LOG_BATCH bytes is ready.
+ * RELATIONS:
+ *    openLog()/logStep() - Put in each record.
+ * IMPORTS:
+ *    log - The log.
+ *    record - The bytes of the record.
+ *    length - The number of bytes, at most LOG_RECORD_MAX.
+ * EXPORTS:
+ *    none
+ */
+
+static void putRecord( GraphicsLog* log, unsigned char* record, int length )
+{
+   unsigned long head = log->head;
+   unsigned long tail = __atomic_load_n( &( log->tail ), __ATOMIC_ACQUIRE );
+   int ii;
+
+   if ( ( LOG_RING_SIZE - ( head - tail ) ) < ( unsigned long )length )
+   {
+      tail = waitForRoom( log, head, length );
+   }
+   for ( ii = 0; ii < length; ii++ )
+   {
+      log->ring[( head + ii ) & ( LOG_RING_SIZE - 1 )] = record[ii];
+   }
+   head += length;
+   __atomic_store_n( &( log->head ), head, __ATOMIC_SEQ_CST );
+
+   if ( ( ( head - tail ) >= LOG_BATCH ) && ( __atomic_load_n( &( log->isWriterAsleep ), __ATOMIC_SEQ_CST ) != 0 ) )
+   {
+      pthread_mutex_lock( &( log->lock ) );
+      pthread_cond_signal( &( log->isReady ) );
+      pthread_mutex_unlock( &( log->lock ) );
+   }
+}
+
+
+/* NAME: waitForRoom()
+ * PURPOSE: Waits until a record fits in the ring buffer, returning the
+ *          count of bytes taken out by then.
+ * HOW IT WORKS: Sleeps until the writing thread has taken out enough,
+ *               waking it each time in case it sleeps too. The drawing
+ *               says it sleeps before checking for room, and the writing
+ *               thread stores its count before checking for a sleeper, so
+ *               one always sees the other. Without a writing thread the
+ *               records are written out here instead.
+ * RELATIONS:
+ *    putRecord() - Waits when the ring buffer is too full.
+ * IMPORTS:
+ *    log - The log.
+ *    head - The count of bytes put in.
+ *    length - The number of bytes of the record.
+ * EXPORTS:
+ *    tail - The count of bytes taken out.
+ */
+
+static unsigned long waitForRoom( GraphicsLog* log, unsigned long head, int length )
+{
+   unsigned long tail;
+
+   if ( log->isThreaded == 0 )
+   {
+      writeRing( log, log->tail, head );
+      log->tail = head;
+      tail = head;
+   }
+   else
+   {
+      pthread_mutex_lock( &( log->lock ) );
+      __atomic_store_n( &( log->isDrawingAsleep ), -1, __ATOMIC_SEQ_CST );
+      tail = __atomic_load_n( &( log->tail ), __ATOMIC_SEQ_CST );
+      while ( ( LOG_RING_SIZE - ( head - tail ) ) < ( unsigned long )length )
+      {
+         pthread_cond_signal( &( log->isReady ) );
+         pthread_cond_wait( &( log->hasRoom ), &( log->lock ) );
+         tail = __atomic_load_n( &( log->tail ), __ATOMIC_SEQ_CST );
+      }
+      __atomic_store_n( &( log->isDrawingAsleep ), 0, __ATOMIC_SEQ_CST );
+      pthread_mutex_unlock( &( log->lock ) );
+   }
+
+   return tail;
+}
+
+
+/* NAME: writeLog()
+ * PURPOSE: Takes records out of the ring buffer and writes them to the
+ *          file, until the log is closed.
+ * HOW IT WORKS: - Sleeps until a batch of LOG_BATCH bytes is ready or the
+ *                 log is closing. It says it sleeps before checking, and
+ *                 the drawing stores its count before checking for a
+ *                 sleeper, so one always sees the other.
+ *               - Writes out everything put in by then with writeRing(),
+ *                 stores its count of bytes taken out, and wakes the
+ *                 drawing if it sleeps waiting for room.
+ *               - Checks for closing before taking the count put in, so
+ *                 the last pass writes out every record.
+ * RELATIONS:
+ *    openLog() - Starts the thread.
+ *    closeLog() - Waits for the thread to finish.
+ * IMPORTS:
+ *    data - Pointer to the log.
+ * EXPORTS:
+ *    NULL
+ */
+
+static void* writeLog( void* data )
+{
+   GraphicsLog* log = ( GraphicsLog* )data;
+   unsigned long tail = log->tail;
+   unsigned long head;
+   int isDone = 0;
+
+   while ( isDone == 0 )
+   {
+      pthread_mutex_lock( &( log->lock ) );
+      __atomic_store_n( &( log->isWriterAsleep ), -1, __ATOMIC_SEQ_CST );
+      while ( ( ( __atomic_load_n( &( log->head ), __ATOMIC_SEQ_CST ) - tail ) < LOG_BATCH ) &&
+              ( __atomic_load_n( &( log->isClosing ), __ATOMIC_SEQ_CST ) == 0 ) )
+      {
+         pthread_cond_wait( &( log->isReady ), &( log->lock ) );
+      }
+      __atomic_store_n( &( log->isWriterAsleep ), 0, __ATOMIC_SEQ_CST );
+      pthread_mutex_unlock( &( log->lock ) );
+
+      isDone = __atomic_load_n( &( log->isClosing ), __ATOMIC_SEQ_CST );
+      head = __atomic_load_n( &( log->head ), __ATOMIC_ACQUIRE );
+      writeRing( log, tail, head );
+      tail = head;
+      __atomic_store_n( &( log->tail ), tail, __ATOMIC_SEQ_CST );
+
+      if ( __atomic_load_n( &( log->isDrawingAsleep ), __ATOMIC_SEQ_CST ) != 0 )
+      {
+         pthread_mutex_lock( &( log->lock ) );
+         pthread_cond_signal( &( log->hasRoom ) );
+         pthread_mutex_unlock( &( log->lock ) );
+      }
+   }
+
+   return NULL;
+}
+
+
+/* NAME: writeRing()
+ * PURPOSE: Writes the bytes of the ring buffer between two counts to the
+ *          file.
+ * HOW IT WORKS: Writes them with at most two fwrite() calls, one up to the
+ *               end of the ring buffer and one from its start. Once a
+ *               write fails nothing more is written.
+ * RELATIONS:
+ *    writeLog() - Writes each batch.
+ *    waitForRoom()/closeLog() - Write the records without a writing thread.
+ * IMPORTS:
+ *    log - The log.
+ *    from - Count of bytes taken out, the first to write.
+ *    to - Count of bytes put in, after the last to write.
+ * EXPORTS:
+ *    none
+ */
+
+static void writeRing( GraphicsLog* log, unsigned long from, unsigned long to )
+{
+   unsigned long start = from & ( LOG_RING_SIZE - 1 );
+   unsigned long length = to - from;
+   unsigned long first = length;
+
+   if ( ( log->isFailed == 0 ) && ( length > 0 ) )
+   {
+      if ( start + length > LOG_RING_SIZE )
+      {
+         first = LOG_RING_SIZE - start;
+      }
+      if ( ( fwrite( log->ring + start, 1, first, log->file ) != first ) ||
+           ( fwrite( log->ring, 1, length - first, log->file ) != length - first ) )
+      {
+         log->isFailed = -1;
+      }
+   }
+}
+
+
+/* NAME: putCoordinate()
+ * PURPOSE: Adds a coordinate to a record, returning the record's new
+ *          length.
+ * HOW IT WORKS: Copies out the bits of the double and adds them a byte at
+ *               a time, least significant first, whatever order the
+ *               machine keeps them in.
+ * RELATIONS:
+ *    logStep() - Adds the coordinates of each step.
+ * IMPORTS:
+ *    record - The record.
+ *    length - The number of bytes of it so far.
+ *    value - The coordinate.
+ * EXPORTS:
+ *    length - The number of bytes of it now.
+ */
+
+static int putCoordinate( unsigned char* record, int length, double value )
+{
+   unsigned long bits;
+   int ii;
+
+   memcpy( &bits, &value, sizeof( double ) );
+   for ( ii = 0; ii < 8; ii++ )
+   {
+      record[length + ii] = ( unsigned char )( bits & 0xFF );
+      bits >>= 8;
+   }
+
+   return length + 8;
+}
+
+
+/* NAME: getCoordinate()
+ * PURPOSE: Reads a coordinate added by putCoordinate().
+ * HOW IT WORKS: Puts the bits back together, most significant byte first,
+ *               then copies them into a double.
+ * RELATIONS:
+ *    decodeLog() - Reads the coordinates of each record.
+ * IMPORTS:
+ *    bytes - The 8 bytes of the coordinate.
+ * EXPORTS:
+ *    value - The coordinate.
+ */
+
+static double getCoordinate( unsigned char* bytes )
+{
+   unsigned long bits = 0;
+   double value;
+   int ii;
+
+   for ( ii = 7; ii >= 0; ii-- )
+   {
+      bits = ( bits << 8 ) | bytes[ii];
+   }
+   memcpy( &value, &bits, sizeof( double ) );
+
+   return value;
+}
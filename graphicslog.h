@@ -0,0 +1,86 @@
+/* FILE: graphicslog.h
+ * AUTHOR: Kyle Notani | 19149918
+ * UNIT: UCP COMP1000
+ * PURPOSE: Header file associated with graphicslog.c
+ */
+
+#ifndef GRAPHICSLOG_H
+   #define GRAPHICSLOG_H
+
+   #include <stdio.h>
+   #include <pthread.h>
+
+   /* Log appended to by every drawing */
+   #define LOG_NAME "graphics.log"
+
+   /* Bytes of records held between the drawing and the thread writing
+    * them, a power of two */
+   #define LOG_RING_SIZE 262144
+
+   /* Bytes of records gathered before the writing thread is woken, written
+    * to the file in one go */
+   #define LOG_BATCH 65536
+
+   /* First byte of each record. None is a character a text line of an
+    * older log starts with, so both can be read from the one file */
+   #define LOG_RUN 0
+   #define LOG_DRAW 1
+   #define LOG_MOVE 2
+   #define LOG_DRAW_FROM 3
+   #define LOG_MOVE_FROM 4
+
+   /* Bytes following LOG_RUN, marking the start of a drawing */
+   #define LOG_MAGIC "TGLOG"
+   #define LOG_MAGIC_LENGTH 5
+   #define LOG_VERSION 1
+
+   /* Longest record: a type and four coordinates of 8 bytes */
+   #define LOG_RECORD_MAX 33
+
+   /* Stores the graphics.log of a drawing, whose records are written to a
+    * ring buffer by the drawing and taken out to the file on a thread of
+    * its own */
+   typedef struct
+   {
+      FILE* file;
+      unsigned char ring[LOG_RING_SIZE];
+      /* Bytes ever put in by the drawing and taken out by the writing
+       * thread, each only stored by its own side */
+      unsigned long head;
+      unsigned long tail;
+      /* End of the last record put in, which the next usually starts at */
+      double lastX;
+      double lastY;
+      /* Whether the writing thread runs, the drawing having to write the
+       * records itself if not */
+      int isThreaded;
+      pthread_t thread;
+      /* Wakes the writing thread once a batch is ready, and the drawing
+       * once there is room, when either waits */
+      pthread_mutex_t lock;
+      pthread_cond_t isReady;
+      pthread_cond_t hasRoom;
+      int isWriterAsleep;
+      int isDrawingAsleep;
+      int isClosing;
+      /* Whether writing to the file has failed */
+      int isFailed;
+   } GraphicsLog;
+
+   /* Opens the log for appending, marking the start of a drawing, returning
+    * NULL if it can't be.
+    */
+   GraphicsLog* openLog( const char* name );
+
+   /* Records a DRAW or MOVE of the turtle from one point to another. */
+   void logStep( GraphicsLog* log, int type, double startX, double startY, double endX, double endY );
+
+   /* Writes out every record left and closes the log. */
+   void closeLog( GraphicsLog* log );
+
+   /* Writes a log as the text of older logs, returning whether it was
+    * read to the end.
+    */
+   int decodeLog( FILE* in, FILE* out );
+
+#endif
@@ -0,0 +1,436 @@
+/*
+ * FILE: image.c
+ * AUTHOR: Kyle Notani | 19149918
+ * UNIT: UCP COMP1000
+ * PURPOSE: Rasterize drawing commands into a headless image at any
+ *          resolution and write it out as a binary PPM (or PGM) file, for
+ *          running without a terminal.
+ * FILE FORMATS: Binary PPM (P6) holding RGB pixels, or binary PGM (P5)
+ *               holding grey pixels, 8 bits per channel.
+ * OTHER: Each line is drawn the way the terminal shows it: a band one cell
+ *        wide in the background colour, with a thinner line in the
+ *        foreground colour along its middle.
+ *        '-1' evaluates to true, '0' evaluates to false.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "image.h"
+#include "framebuffer.h"
+
+/* Pixel coordinates are kept within this distance of the image, so lines
+ * far off it cannot overflow an int */
+#define PIXEL_LIMIT 1073741824.0
+
+static int toPixel( double offset, double scale, double coordinate );
+static void makeInk( Image* image, int colour, int isForeground, unsigned char* ink );
+static void strokeLine( Image* image, int x1, int y1, int x2, int y2, int size, unsigned char* ink );
+static void fillRect( Image* image, int left, int top, int right, int bottom, unsigned char* ink );
+
+/* RGB of the 16 terminal colour codes, the usual xterm palette */
+static const unsigned char palette[16][3] =
+{
+   { 0, 0, 0 }, { 205, 0, 0 }, { 0, 205, 0 }, { 205, 205, 0 },
+   { 0, 0, 238 }, { 205, 0, 205 }, { 0, 205, 205 }, { 229, 229, 229 },
+   { 127, 127, 127 }, { 255, 0, 0 }, { 0, 255, 0 }, { 255, 255, 0 },
+   { 92, 92, 255 }, { 255, 0, 255 }, { 0, 255, 255 }, { 255, 255, 255 }
+};
+
+
+/* NAME: constructImage()
+ * PURPOSE: Constructs a blank image of width by height pixels showing the
+ *          viewport, scaled to fit and centred.
+ * HOW IT WORKS: - Allocates the pixels zeroed, which is black in either
+ *                 format, the terminal's usual background.
+ *               - Cells are square, so the viewport is scaled by whichever
+ *                 of its sides fits the image first, and centred along the
+ *                 other.
+ *               - Draws in the terminal's default colours until told
+ *                 otherwise.
+ * RELATIONS:
+ *    draw() - Constructs the image to draw every command into when exporting.
+ * IMPORTS:
+ *    width/height - Size of the image in pixels.
+ *    channels - 3 for an RGB image, 1 for a greyscale image.
+ *    view - The rectangle of cells the image shows.
+ * EXPORTS:
+ *    image - a pointer to the allocated Image struct on the heap, or NULL if
+ *            any allocation failed.
+ */
+
+Image* constructImage( int width, int height, int channels, Viewport* view )
+{
+   Image* image = ( Image* )malloc( sizeof( Image ) );
+   double scaleY;
+
+   if ( image != NULL )
+   {
+      image->pixels = ( unsigned char* )calloc( ( size_t )width * height, channels );
+      if ( image->pixels == NULL )
+      {
+         free( image );
+         image = NULL;
+      }
+   }
+
+   if ( image != NULL )
+   {
+      image->width = width;
+      image->height = height;
+      image->channels = channels;
+      image->left = view->left;
+      image->top = view->top;
+
+      image->scale = ( double )width / view->width;
+      scaleY = ( double )height / view->height;
+      if ( scaleY < image->scale )
+      {
+         image->scale = scaleY;
+      }
+      image->offsetX = ( width - view->width * image->scale ) / 2.0;
+      image->offsetY = ( height - view->height * image->scale ) / 2.0;
+
+      image->cellSize = ( int )( image->scale + 0.5 );
+      if ( image->cellSize < 1 )
+      {
+         image->cellSize = 1;
+      }
+      image->coreSize = image->cellSize / 4;
+      if ( image->coreSize < 1 )
+      {
+         image->coreSize = 1;
+      }
+
+      image->fgColour = DEFAULT_COLOUR;
+      image->bgColour = DEFAULT_COLOUR;
+   }
+
+   return image;
+}
+
+
+/* NAME: imageLine()
+ * PURPOSE: Draws the line between two turtle coordinates into the image.
+ * HOW IT WORKS: - Scales both coordinates to the pixel at the centre of
+ *                 their cell, keeping their fractions so a line is as
+ *                 straight as the image's resolution allows.
+ *               - Strokes the line one cell wide in the background colour,
+ *                 then again along its middle in the foreground colour.
+ * RELATIONS:
+ *    drawLine() - Draws each line command into the image when exporting.
+ * IMPORTS:
+ *    image - The image to draw into.
+ *    x1/y1 - Starting coordinates, in cells.
+ *    x2/y2 - Finishing coordinates, in cells.
+ * EXPORTS:
+ *    none
+ */
+
+void imageLine( Image* image, double x1, double y1, double x2, double y2 )
+{
+   unsigned char ink[3];
+   int pixelX1 = toPixel( image->offsetX, image->scale, x1 - image->left + 0.5 );
+   int pixelY1 = toPixel( image->offsetY, image->scale, y1 - image->top + 0.5 );
+   int pixelX2 = toPixel( image->offsetX, image->scale, x2 - image->left + 0.5 );
+   int pixelY2 = toPixel( image->offsetY, image->scale, y2 - image->top + 0.5 );
+
+   makeInk( image, image->bgColour, 0, ink );
+   strokeLine( image, pixelX1, pixelY1, pixelX2, pixelY2, image->cellSize, ink );
+
+   makeInk( image, image->fgColour, -1, ink );
+   strokeLine( image, pixelX1, pixelY1, pixelX2, pixelY2, image->coreSize, ink );
+}
+
+
+/* NAME: writeImage()
+ * PURPOSE: Writes the image to a binary PPM or PGM file, returning whether
+ *          it was written.
+ * HOW IT WORKS: Writes the header, then the packed pixels straight from the
+ *               image with a single fwrite().
+ * RELATIONS:
+ *    draw() - Writes the image once every command has run.
+ * IMPORTS:
+ *    image - The image to write.
+ *    filename - Name of the file to create or replace.
+ * EXPORTS:
+ *    isWritten - Boolean evaluating to '0' (FALSE) if the file could not be
+ *                written, or '-1' (TRUE) otherwise.
+ */
+
+int writeImage( Image* image, char* filename )
+{
+   int isWritten = 0;
+   size_t size = ( size_t )image->width * image->height * image->channels;
+   FILE* file = fopen( filename, "wb" );
+
+   if ( file != NULL )
+   {
+      fprintf( file, "P%d\n%d %d\n255\n", ( image->channels == 1 ) ? 5 : 6, image->width, image->height );
+      if ( ( fwrite( image->pixels, 1, size, file ) == size ) && ( ferror( file ) == 0 ) )
+      {
+         isWritten = -1;
+      }
+      if ( fclose( file ) != 0 )
+      {
+         isWritten = 0;
+      }
+   }
+
+   return isWritten;
+}
+
+
+/* NAME: freeImage()
+ * PURPOSE: Deallocates the image along with its pixels.
+ * HOW IT WORKS: Frees the pixels and then the Image struct itself.
+ * RELATIONS:
+ *    draw() - Frees the image once it is written.
+ * IMPORTS:
+ *    image - The image to free.
+ * EXPORTS:
+ *    none
+ */
+
+void freeImage( Image* image )
+{
+   free( image->pixels );
+   free( image );
+}
+
+
+/* NAME: lookupColour()
+ * PURPOSE: Looks up the RGB of a terminal colour code.
+ * HOW IT WORKS: - The terminal's default colours are taken as light grey
+ *                 text on black.
+ *               - Foreground codes 8-15 are the bright colours, background
+ *                 codes only go up to 7.
+ * RELATIONS:
+ *    makeInk() - Finds the pixels of each line in an image.
+ *    svgLine()/constructSvg() - Find the colours of a vector image.
+ * IMPORTS:
+ *    colour - Terminal colour code, or DEFAULT_COLOUR.
+ *    isForeground - Whether colour is a foreground code.
+ *    rgb - Array of 3 bytes to fill.
+ * EXPORTS:
+ *    none
+ */
+
+void lookupColour( int colour, int isForeground, unsigned char* rgb )
+{
+   const unsigned char* entry;
+
+   if ( colour == DEFAULT_COLOUR )
+   {
+      colour = ( isForeground != 0 ) ? 7 : 0;
+   }
+   entry = palette[( isForeground != 0 ) ? colour % 16 : colour % 8];
+
+   rgb[0] = entry[0];
+   rgb[1] = entry[1];
+   rgb[2] = entry[2];
+}
+
+
+/* NAME: toPixel()
+ * PURPOSE: Scales a coordinate along one axis to a pixel.
+ * HOW IT WORKS: Rounds down to the pixel the scaled coordinate falls in,
+ *               held within PIXEL_LIMIT.
+ * RELATIONS:
+ *    imageLine() - Scales the line's coordinates.
+ * IMPORTS:
+ *    offset - Pixel position of the viewport's edge.
+ *    scale - Pixels per cell.
+ *    coordinate - Distance from the viewport's edge, in cells.
+ * EXPORTS:
+ *    pixel - The pixel the coordinate falls in.
+ */
+
+static int toPixel( double offset, double scale, double coordinate )
+{
+   double pixel = floor( offset + coordinate * scale );
+
+   if ( pixel > PIXEL_LIMIT )
+   {
+      pixel = PIXEL_LIMIT;
+   }
+   else if ( pixel < -PIXEL_LIMIT )
+   {
+      pixel = -PIXEL_LIMIT;
+   }
+
+   return ( int )pixel;
+}
+
+
+/* NAME: makeInk()
+ * PURPOSE: Looks up the bytes of a pixel in a terminal colour.
+ * HOW IT WORKS: Greyscale images weigh the colour's RGB by how bright each
+ *               looks.
+ * RELATIONS:
+ *    imageLine() - Finds the colours of each line.
+ *    lookupColour() - Finds the RGB of the colour.
+ * IMPORTS:
+ *    image - The image the ink is for.
+ *    colour - Terminal colour code, or DEFAULT_COLOUR.
+ *    isForeground - Whether colour is a foreground code.
+ *    ink - Array of 3 bytes to fill, only the first for greyscale.
+ * EXPORTS:
+ *    none
+ */
+
+static void makeInk( Image* image, int colour, int isForeground, unsigned char* ink )
+{
+   unsigned char rgb[3];
+
+   lookupColour( colour, isForeground, rgb );
+   if ( image->channels == 1 )
+   {
+      ink[0] = ( unsigned char )( ( 77 * rgb[0] + 150 * rgb[1] + 29 * rgb[2] ) >> 8 );
+   }
+   else
+   {
+      ink[0] = rgb[0];
+      ink[1] = rgb[1];
+      ink[2] = rgb[2];
+   }
+}
+
+
+/* NAME: strokeLine()
+ * PURPOSE: Draws a line of pixels size pixels wide.
+ * HOW IT WORKS: - Fills a size by size square at each end.
+ *               - Clips the line to the image, widened by size on each side
+ *                 so lines just off it still reach in, and steps along it
+ *                 with Bresenham's line algorithm (as in clipLine()).
+ *               - Each step fills a span size pixels across the major axis,
+ *                 so the line keeps its width at any angle.
+ * RELATIONS:
+ *    imageLine() - Strokes each line's background and foreground.
+ *    clipLine() - Clips the line to around the image.
+ * IMPORTS:
+ *    image - The image to draw into.
+ *    x1/y1 - Starting pixel.
+ *    x2/y2 - Finishing pixel.
+ *    size - Width of the line in pixels.
+ *    ink - Bytes of the pixels to draw.
+ * EXPORTS:
+ *    none
+ */
+
+static void strokeLine( Image* image, int x1, int y1, int x2, int y2, int size, unsigned char* ink )
+{
+   int low = size / 2;
+   int high = size - 1 - low;
+   Viewport bounds;
+   Segment seg;
+   int x, y, decision, ii;
+
+   fillRect( image, x1 - low, y1 - low, x1 + high, y1 + high, ink );
+   fillRect( image, x2 - low, y2 - low, x2 + high, y2 + high, ink );
+
+   bounds.left = -size;
+   bounds.top = -size;
+   bounds.width = image->width + 2 * size;
+   bounds.height = image->height + 2 * size;
+
+   if ( clipLine( &bounds, x1, y1, x2, y2, &seg ) != 0 )
+   {
+      x = seg.x;
+      y = seg.y;
+      decision = seg.decision;
+      for ( ii = 0; ii < seg.count; ii++ )
+      {
+         if ( seg.xIsMajor != 0 )
+         {
+            fillRect( image, x, y - low, x, y + high, ink );
+            x += seg.stepX;
+         }
+         else
+         {
+            fillRect( image, x - low, y, x + high, y, ink );
+            y += seg.stepY;
+         }
+
+         decision += seg.minorDelta;
+         if ( decision >= seg.majorDelta )
+         {
+            decision -= seg.majorDelta;
+            if ( seg.xIsMajor != 0 )
+            {
+               y += seg.stepY;
+            }
+            else
+            {
+               x += seg.stepX;
+            }
+         }
+      }
+   }
+}
+
+
+/* NAME: fillRect()
+ * PURPOSE: Fills a rectangle of pixels, clipped to the image.
+ * HOW IT WORKS: Clips the rectangle, then fills it a row at a time, with
+ *               memset() for greyscale images and by copying the ink into
+ *               each pixel for RGB ones.
+ * RELATIONS:
+ *    strokeLine() - Fills the ends and spans of lines.
+ * IMPORTS:
+ *    image - The image to draw into.
+ *    left/top - Top left pixel of the rectangle.
+ *    right/bottom - Bottom right pixel of the rectangle.
+ *    ink - Bytes of the pixels to draw.
+ * EXPORTS:
+ *    none
+ */
+
+static void fillRect( Image* image, int left, int top, int right, int bottom, unsigned char* ink )
+{
+   unsigned char* pixel;
+   unsigned char* end;
+   int y;
+
+   if ( left < 0 )
+   {
+      left = 0;
+   }
+   if ( top < 0 )
+   {
+      top = 0;
+   }
+   if ( right >= image->width )
+   {
+      right = image->width - 1;
+   }
+   if ( bottom >= image->height )
+   {
+      bottom = image->height - 1;
+   }
+
+   if ( left <= right )
+   {
+      for ( y = top; y <= bottom; y++ )
+      {
+         pixel = image->pixels + ( ( size_t )y * image->width + left ) * image->channels;
+         if ( image->channels == 1 )
+         {
+            memset( pixel, ink[0], ( size_t )( right - left + 1 ) );
+         }
+         else
+         {
+            end = pixel + ( size_t )( right - left + 1 ) * 3;
+            while ( pixel < end )
+            {
+               pixel[0] = ink[0];
+               pixel[1] = ink[1];
+               pixel[2] = ink[2];
+               pixel += 3;
+            }
+         }
+      }
+   }
+}
@@ -0,0 +1,62 @@
+/* FILE: image.h
+ * AUTHOR: Kyle Notani | 19149918
+ * UNIT: UCP COMP1000
+ * PURPOSE: Header file associated with image.c
+ */
+
+#ifndef IMAGE_H
+   #define IMAGE_H
+
+   #include "viewport.h"
+
+   /* Size in pixels of an exported image when none is chosen */
+   #define IMAGE_WIDTH 1920
+   #define IMAGE_HEIGHT 1080
+
+   /* Largest width or height in pixels of an exported image */
+   #define IMAGE_MAX 65536
+
+   /* Stores a headless image the drawing is rasterized into, in place of the
+    * terminal, as packed rows of pixels ready to be written to a file */
+   typedef struct
+   {
+      /* Packed pixels, row by row from the top, channels bytes each */
+      unsigned char* pixels;
+      /* Size of the image in pixels */
+      int width;
+      int height;
+      /* 3 for RGB (PPM), 1 for greyscale (PGM) */
+      int channels;
+      /* Top left cell of the viewport shown in the image */
+      int left;
+      int top;
+      /* Pixels per cell, and pixel position of the viewport's top left */
+      double scale;
+      double offsetX;
+      double offsetY;
+      /* Width in pixels of a line's cells, and of the line drawn within */
+      int cellSize;
+      int coreSize;
+      /* Colours given to every line drawn from now on */
+      int fgColour;
+      int bgColour;
+   } Image;
+
+   /* Constructs a blank image of width by height pixels showing the viewport,
+    * scaled to fit and centred. */
+   Image* constructImage( int width, int height, int channels, Viewport* view );
+
+   /* Draws the line between two turtle coordinates into the image. */
+   void imageLine( Image* image, double x1, double y1, double x2, double y2 );
+
+   /* Writes the image to a binary PPM or PGM file, returning whether it was
+    * written. */
+   int writeImage( Image* image, char* filename );
+
+   /* Deallocates the image along with its pixels. */
+   void freeImage( Image* image );
+
+   /* Looks up the RGB of a terminal colour code. */
+   void lookupColour( int colour, int isForeground, unsigned char* rgb );
+
+#endif
@@ -0,0 +1,641 @@
+/*
+ * FILE: lsystem.c
+ * AUTHOR: Kyle Notani | 19149918
+ * UNIT: UCP COMP1000
+ * PURPOSE: Read an L-system, an axiom rewritten by rules a number of times,
+ *          and draw the commands it expands to as they are expanded, with
+ *          no script of them ever written out or read back in.
+ * FILE FORMATS: A text file starting with the line LSYSTEM, followed by any
+ *               of these lines, in any order:
+ *                  AXIOM symbols     - the symbols expanded (required)
+ *                  RULE s symbols    - rewrites symbol s to the symbols,
+ *                                      to nothing if none are given
+ *                  DEPTH n           - times the rules are applied
+ *                  ANGLE degrees     - turn of + and -
+ *                  DISTANCE cells    - length of F, G, f and g
+ *               Any other line is an ordinary command, run before the
+ *               expansion, such as a MOVE to where it starts or its FG.
+ * OTHER: Only the symbols of the file are kept. The expansion is followed
+ *        depth first with a stack of one production per level, so memory
+ *        grows with the depth, not with what is drawn.
+ *        '-1' evaluates to true, '0' evaluates to false.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "lsystem.h"
+#include "commandarray.h"
+#include "structset.h"
+#include "arrayoperations.h"
+#include "validators.h"
+#include "chunks.h"
+#include "report.h"
+#include "draw.h"
+#include "stringoperations.h"
+
+static int readLine( Span* line, int lineNo, LSystem* lsystem, Report* report, int* used );
+static int readSymbols( Span* rest, Span* symbols );
+static int readValue( Span* rest, int lineNo, CmdDataFunc validateDataType, Operand* value, Report* report );
+static void trimToken( Span* token );
+static void setActions( LSystem* lsystem, double angle, double distance );
+
+
+/* NAME: isLSystem()
+ * PURPOSE: Checks if a file's text starts as an L-system does.
+ * HOW IT WORKS: Compares the first word of the first line with
+ *               LSYSTEM_MAGIC, in any casing, which no command name is.
+ * RELATIONS:
+ *    processFile() - Tells an L-system from a script.
+ * IMPORTS:
+ *    text - The whole text of the file.
+ * EXPORTS:
+ *    isFound - Boolean evaluating to '-1' (TRUE) if the file is an
+ *              L-system, or '0' (FALSE) otherwise.
+ */
+
+int isLSystem( Span* text )
+{
+   Span rest = *text;
+   Span word;
+   const char* newline = ( const char* )memchr( text->start, '\n', text->length );
+
+   /* Only the first line is looked at */
+   if ( newline != NULL )
+   {
+      rest.length = ( size_t )( newline - text->start );
+   }
+   nextToken( &rest, &word );
+   trimToken( &word );
+
+   return spanMatches( &word, LSYSTEM_MAGIC );
+}
+
+
+/* NAME: readLSystem()
+ * PURPOSE: Reads the axiom, rules and settings of an L-system, adding any
+ *          error messages to the report. Returns whether every line was
+ *          valid.
+ * HOW IT WORKS: - Copies the symbols of the axiom and each rule into a
+ *                 single allocation no longer than the text, so the text
+ *                 can be unloaded once read.
+ *               - Goes through each line as validateChunk() does, reading
+ *                 it with readLine(). Every line is read, so every error is
+ *                 reported.
+ *               - Sets the commands each symbol runs from the angle and
+ *                 distance read, once every line is read.
+ * RELATIONS:
+ *    processFile() - Reads a file starting with LSYSTEM.
+ *    readLine() - Reads each line.
+ *    setActions() - Sets up the commands the symbols run.
+ * IMPORTS:
+ *    text - The whole text of the file.
+ *    lsystem - Set to the L-system read, freed with freeLSystem() whether
+ *              valid or not.
+ *    report - Collects the error messages of invalid lines.
+ * EXPORTS:
+ *    isValid - Boolean evaluating to '0' (FALSE) if any line was not valid,
+ *              or '-1' (TRUE) otherwise.
+ */
+
+int readLSystem( Span* text, LSystem* lsystem, Report* report )
+{
+   int isValid = -1;
+
+   /* start of the next line and end of the text */
+   const char* next = text->start;
+   const char* end = text->start + text->length;
+   const char* newline = NULL;
+   Span line;
+   int lineNo = 0;
+
+   /* symbols copied so far */
+   int used = 0;
+
+   int ii;
+
+   lsystem->symbols = ( char* )malloc( text->length + 1 );
+   lsystem->start = constructArray();
+   lsystem->axiom.start = 0;
+   lsystem->axiom.length = -1;
+   lsystem->depth = 0;
+   for ( ii = 0; ii < LSYSTEM_SYMBOLS; ii++ )
+   {
+      lsystem->rules[ii].start = 0;
+      lsystem->rules[ii].length = -1;
+   }
+   setActions( lsystem, LSYSTEM_ANGLE, LSYSTEM_DISTANCE );
+
+   if ( ( lsystem->symbols == NULL ) || ( lsystem->start == NULL ) )
+   {
+      isValid = 0;
+      addMessage( report, "Error: could not allocate the L-system\n\n" );
+   }
+   else
+   {
+      while ( next < end )
+      {
+         lineNo++;
+
+         line.start = next;
+         newline = ( const char* )memchr( next, '\n', ( size_t )( end - next ) );
+         if ( newline == NULL )
+         {
+            next = end;
+         }
+         else
+         {
+            next = newline + 1;
+         }
+         line.length = ( size_t )( next - line.start );
+
+         if ( ( spanIsCtrl( &line ) == 0 ) &&
+              ( readLine( &line, lineNo, lsystem, report, &used ) == 0 ) )
+         {
+            isValid = 0;
+         }
+      }
+
+      if ( lsystem->axiom.length < 0 )
+      {
+         isValid = 0;
+         addMessage( report, "Error: L-system has no AXIOM to expand\n\n" );
+      }
+      setActions( lsystem, lsystem->actions[2].value.real, lsystem->actions[0].value.real );
+   }
+
+   return isValid;
+}
+
+
+/* NAME: readLine()
+ * PURPOSE: Reads a line of an L-system that is not blank, returning whether
+ *          it was valid.
+ * HOW IT WORKS: - Matches the first word, in any casing, against LSYSTEM
+ *                 (only on the first line), AXIOM, RULE, DEPTH, ANGLE and
+ *                 DISTANCE.
+ *               - Symbols are copied to the end of the L-system's symbols.
+ *                 An axiom or symbol given a second time is an error.
+ *               - Values are validated with the same validators.c functions
+ *                 as commands, the distance being as long as a DRAW's can
+ *                 be. The depth is from 0 to MAX_LSYSTEM_DEPTH.
+ *               - The angle and distance are kept in the commands + and F
+ *                 run, until setActions() sets up the rest.
+ *               - Any other line is validated with validateLine() and added
+ *                 to the commands run first. REPEAT, PROC and CALL can't be
+ *                 used, as an L-system has no need for them.
+ * RELATIONS:
+ *    readLSystem() - Reads each line of the file.
+ *    readSymbols()/readValue() - Read what follows the first word.
+ *    validateLine() - Validates any ordinary command.
+ * IMPORTS:
+ *    line - The line, including its new line if it has one.
+ *    lineNo - Number of the line within the file.
+ *    lsystem - The L-system being read.
+ *    report - Collects the error messages of an invalid line.
+ *    used - Symbols copied so far, moved on past any copied.
+ * EXPORTS:
+ *    isValid - Boolean evaluating to '0' (FALSE) if the line is not valid,
+ *              or '-1' (TRUE) otherwise.
+ */
+
+static int readLine( Span* line, int lineNo, LSystem* lsystem, Report* report, int* used )
+{
+   int isValid = 0;
+   Span rest = *line;
+   Span word;
+   Span symbol;
+   Span symbols;
+   Operand value;
+   Production* production = NULL;
+   Command cmd;
+
+   nextToken( &rest, &word );
+   trimToken( &word );
+
+   if ( spanMatches( &word, LSYSTEM_MAGIC ) != 0 )
+   {
+      if ( ( lineNo == 1 ) && ( readSymbols( &rest, &symbols ) != 0 ) && ( symbols.length == 0 ) )
+      {
+         isValid = -1;
+      }
+      else
+      {
+         addMessage( report, "Error: Line %d. LSYSTEM must be alone on the first line\n\n", lineNo );
+      }
+   }
+   else if ( spanMatches( &word, "AXIOM" ) != 0 )
+   {
+      if ( lsystem->axiom.length >= 0 )
+      {
+         addMessage( report, "Error: Line %d. AXIOM is already given\n\n", lineNo );
+      }
+      else if ( ( readSymbols( &rest, &symbols ) == 0 ) || ( symbols.length == 0 ) )
+      {
+         addMessage( report, "Error: Line %d. AXIOM needs one run of printable symbols\n\n", lineNo );
+      }
+      else
+      {
+         isValid = -1;
+         production = &( lsystem->axiom );
+      }
+   }
+   else if ( spanMatches( &word, "RULE" ) != 0 )
+   {
+      nextToken( &rest, &symbol );
+      trimToken( &symbol );
+      if ( ( symbol.length != 1 ) || ( readSymbols( &rest, &symbols ) == 0 ) )
+      {
+         addMessage( report, "Error: Line %d. RULE needs a symbol then one run of printable symbols\n\n", lineNo );
+      }
+      else if ( lsystem->rules[( unsigned char )symbol.start[0]].length >= 0 )
+      {
+         addMessage( report, "Error: Line %d. symbol %c already has a rule\n\n", lineNo, symbol.start[0] );
+      }
+      else
+      {
+         isValid = -1;
+         production = &( lsystem->rules[( unsigned char )symbol.start[0]] );
+      }
+   }
+   else if ( spanMatches( &word, "DEPTH" ) != 0 )
+   {
+      if ( readValue( &rest, lineNo, &validateInt, &value, report ) != 0 )
+      {
+         if ( ( value.integer < 0 ) || ( value.integer > MAX_LSYSTEM_DEPTH ) )
+         {
+            addMessage( report, "Error: depth must be between 0 and %d\n", MAX_LSYSTEM_DEPTH );
+            addMessage( report, "       Line %d. incorrect range for DEPTH\n\n", lineNo );
+         }
+         else
+         {
+            isValid = -1;
+            lsystem->depth = value.integer;
+         }
+      }
+   }
+   else if ( spanMatches( &word, "ANGLE" ) != 0 )
+   {
+      if ( readValue( &rest, lineNo, &validateReal, &value, report ) != 0 )
+      {
+         isValid = -1;
+         lsystem->actions[2].value.real = value.real;
+      }
+   }
+   else if ( spanMatches( &word, "DISTANCE" ) != 0 )
+   {
+      if ( readValue( &rest, lineNo, &validateReal, &value, report ) != 0 )
+      {
+         if ( validateDrawRange( &value, report ) == 0 )
+         {
+            addMessage( report, "       Line %d. incorrect range for DISTANCE\n\n", lineNo );
+         }
+         else
+         {
+            isValid = -1;
+            lsystem->actions[0].value.real = value.real;
+         }
+      }
+   }
+   else if ( validateLine( line, lineNo, &cmd, report ) != 0 )
+   {
+      if ( cmd.opcode >= OP_REPEAT )
+      {
+         addMessage( report, "Error: Line %d. blocks can't be used in an L-system\n\n", lineNo );
+      }
+      else if ( insertLast( lsystem->start, &cmd ) == 0 )
+      {
+         addMessage( report, "Error: Line %d. command could not be stored\n\n", lineNo );
+      }
+      else
+      {
+         isValid = -1;
+      }
+   }
+
+   if ( ( production != NULL ) && ( symbols.length > 0 ) )
+   {
+      memcpy( lsystem->symbols + *used, symbols.start, symbols.length );
+      *used += ( int )symbols.length;
+   }
+   if ( production != NULL )
+   {
+      production->start = *used - ( int )symbols.length;
+      production->length = ( int )symbols.length;
+   }
+
+   return isValid;
+}
+
+
+/* NAME: readSymbols()
+ * PURPOSE: Reads the run of symbols ending a line, returning whether it is
+ *          alone and printable.
+ * HOW IT WORKS: Takes the next token, without the new line ending it, then
+ *               checks nothing but control characters follows and every
+ *               symbol is printable. A line with none gives no symbols.
+ * RELATIONS:
+ *    readLine() - Reads the symbols of an axiom or rule.
+ * IMPORTS:
+ *    rest - The rest of the line, moved on past the symbols.
+ *    symbols - Set to the symbols, 0 long if there are none.
+ * EXPORTS:
+ *    isValid - Boolean evaluating to '0' (FALSE) if anything else follows
+ *              or a symbol is not printable, or '-1' (TRUE) otherwise.
+ */
+
+static int readSymbols( Span* rest, Span* symbols )
+{
+   int isValid = -1;
+   Span other;
+   size_t ii;
+
+   nextToken( rest, symbols );
+   trimToken( symbols );
+   nextToken( rest, &other );
+
+   if ( ( other.start != NULL ) && ( spanIsCtrl( &other ) == 0 ) )
+   {
+      isValid = 0;
+   }
+   for ( ii = 0; ii < symbols->length; ii++ )
+   {
+      if ( isgraph( ( unsigned char )symbols->start[ii] ) == 0 )
+      {
+         isValid = 0;
+      }
+   }
+
+   return isValid;
+}
+
+
+/* NAME: readValue()
+ * PURPOSE: Reads the single value of a DEPTH, ANGLE or DISTANCE line,
+ *          returning whether it was valid.
+ * HOW IT WORKS: Validates the value's datatype, then that it is the only
+ *               parameter, reporting each as validateLine() does.
+ * RELATIONS:
+ *    readLine() - Reads the value of each setting.
+ * IMPORTS:
+ *    rest - The rest of the line, moved on past the value.
+ *    lineNo - Number of the line within the file.
+ *    validateDataType - validateInt() or validateReal().
+ *    value - Set to the value parsed.
+ *    report - Collects the error messages of an invalid value.
+ * EXPORTS:
+ *    isValid - Boolean evaluating to '0' (FALSE) if the value is not valid,
+ *              or '-1' (TRUE) otherwise.
+ */
+
+static int readValue( Span* rest, int lineNo, CmdDataFunc validateDataType, Operand* value, Report* report )
+{
+   int correctDataType = ( *validateDataType )( rest, value, report );
+   int correctParameters = validateParameters( rest, value, report );
+
+   if ( correctParameters == 0 )
+   {
+      addMessage( report, "       Line %d. incorrect number of parameters for setting\n\n", lineNo );
+   }
+   if ( correctDataType == 0 )
+   {
+      addMessage( report, "       Line %d. incorrect data type for setting\n\n", lineNo );
+   }
+
+   return ( ( correctDataType != 0 ) && ( correctParameters != 0 ) ) ? -1 : 0;
+}
+
+
+/* NAME: trimToken()
+ * PURPOSE: Takes the new line, and any other control characters, off the
+ *          end of a token.
+ * HOW IT WORKS: Shortens the token while it ends in a character that is
+ *               not printable.
+ * RELATIONS:
+ *    isLSystem()/readLine()/readSymbols() - Trim the last token of a line.
+ * IMPORTS:
+ *    token - The token, with a NULL start if there is none.
+ * EXPORTS:
+ *    none
+ */
+
+static void trimToken( Span* token )
+{
+   while ( ( token->length > 0 ) && ( iscntrl( ( unsigned char )token->start[token->length - 1] ) != 0 ) )
+   {
+      token->length--;
+   }
+}
+
+
+/* NAME: setActions()
+ * PURPOSE: Sets up the command each symbol runs.
+ * HOW IT WORKS: F and G draw, f and g move, the distance; + turns by the
+ *               angle, - turns back by it and | turns around. Every other
+ *               symbol runs nothing, only being rewritten.
+ * RELATIONS:
+ *    readLSystem() - Sets the defaults, then the angle and distance read.
+ * IMPORTS:
+ *    lsystem - The L-system.
+ *    angle - Turn of + and -.
+ *    distance - Length of F, G, f and g.
+ * EXPORTS:
+ *    none
+ */
+
+static void setActions( LSystem* lsystem, double angle, double distance )
+{
+   int ii;
+
+   for ( ii = 0; ii < LSYSTEM_SYMBOLS; ii++ )
+   {
+      lsystem->symbolActions[ii] = -1;
+   }
+   for ( ii = 0; ii < LSYSTEM_ACTIONS; ii++ )
+   {
+      lsystem->actions[ii].jump = 0;
+   }
+
+   lsystem->actions[0].opcode = OP_DRAW;
+   lsystem->actions[0].value.real = distance;
+   lsystem->actions[1].opcode = OP_MOVE;
+   lsystem->actions[1].value.real = distance;
+   lsystem->actions[2].opcode = OP_ROTATE;
+   lsystem->actions[2].value.real = angle;
+   lsystem->actions[3].opcode = OP_ROTATE;
+   lsystem->actions[3].value.real = -angle;
+   lsystem->actions[4].opcode = OP_ROTATE;
+   lsystem->actions[4].value.real = 180.0;
+
+   lsystem->symbolActions['F'] = 0;
+   lsystem->symbolActions['G'] = 0;
+   lsystem->symbolActions['f'] = 1;
+   lsystem->symbolActions['g'] = 1;
+   lsystem->symbolActions['+'] = 2;
+   lsystem->symbolActions['-'] = 3;
+   lsystem->symbolActions['|'] = 4;
+}
+
+
+/* NAME: freeLSystem()
+ * PURPOSE: Deallocates the symbols and commands of an L-system.
+ * HOW IT WORKS: Frees the symbols, and the array of commands run first if
+ *               it was constructed.
+ * RELATIONS:
+ *    processFile() - Frees the L-system once drawn.
+ * IMPORTS:
+ *    lsystem - The L-system read by readLSystem().
+ * EXPORTS:
+ *    none
+ */
+
+void freeLSystem( LSystem* lsystem )
+{
+   free( lsystem->symbols );
+   lsystem->symbols = NULL;
+   if ( lsystem->start != NULL )
+   {
+      freeArray( lsystem->start );
+      lsystem->start = NULL;
+   }
+}
+
+
+/* NAME: startExpansion()
+ * PURPOSE: Starts expanding an L-system from the first symbol of its axiom.
+ * HOW IT WORKS: Puts the axiom alone on the stack, at level 0.
+ * RELATIONS:
+ *    drawLSystem() - Expands the L-system as it is drawn.
+ * IMPORTS:
+ *    expansion - The expansion to start.
+ *    lsystem - The L-system to expand.
+ * EXPORTS:
+ *    none
+ */
+
+void startExpansion( Expansion* expansion, LSystem* lsystem )
+{
+   expansion->lsystem = lsystem;
+   expansion->depth = 1;
+   expansion->stack[0].next = lsystem->symbols + lsystem->axiom.start;
+   expansion->stack[0].end = expansion->stack[0].next + lsystem->axiom.length;
+}
+
+
+/* NAME: nextExpanded()
+ * PURPOSE: Expands the L-system on to the next symbol that runs a command,
+ *          returning the command, or NULL once the expansion ends.
+ * HOW IT WORKS: - Takes the next symbol of the production on top of the
+ *                 stack, popping any production finished with.
+ *               - A symbol with a rule, above the last level, pushes its
+ *                 production, so its symbols come next, in place of it. A
+ *                 symbol on the last level, or with no rule, runs its
+ *                 command, if it has one.
+ *               - The stack is never deeper than the depth plus one, and the
+ *                 symbols are only ever read, so nothing is allocated
+ *                 however many commands the expansion gives. Each command
+ *                 given is one of the L-system's own, not copied.
+ * RELATIONS:
+ *    drawLSystem() - Runs each command in turn.
+ * IMPORTS:
+ *    expansion - Where the expansion is up to, moved on past the symbol.
+ * EXPORTS:
+ *    command - The next command to run, or NULL at the end.
+ */
+
+Command* nextExpanded( Expansion* expansion )
+{
+   Command* command = NULL;
+   LSystem* lsystem = expansion->lsystem;
+   Rewrite* top = NULL;
+   Production* rule = NULL;
+   unsigned char symbol;
+
+   while ( ( command == NULL ) && ( expansion->depth > 0 ) )
+   {
+      top = &( expansion->stack[expansion->depth - 1] );
+      if ( top->next == top->end )
+      {
+         expansion->depth--;
+      }
+      else
+      {
+         symbol = ( unsigned char )*( top->next );
+         top->next++;
+         rule = &( lsystem->rules[symbol] );
+         if ( ( expansion->depth <= lsystem->depth ) && ( rule->length >= 0 ) )
+         {
+            top = &( expansion->stack[expansion->depth] );
+            top->next = lsystem->symbols + rule->start;
+            top->end = top->next + rule->length;
+            expansion->depth++;
+         }
+         else if ( lsystem->symbolActions[symbol] >= 0 )
+         {
+            command = &( lsystem->actions[( int )lsystem->symbolActions[symbol]] );
+         }
+      }
+   }
+
+   return command;
+}
+
+
+/* NAME: drawLSystem()
+ * PURPOSE: Draws the commands an L-system expands to, as they are expanded.
+ * HOW IT WORKS: - An L-system with no command to run is reported as draw()
+ *                 reports an empty array.
+ *               - Otherwise sets up drawing with beginDraw(), runs the
+ *                 ordinary commands of the file, then each command
+ *                 nextExpanded() gives, with runCommand(), and finishes the
+ *                 drawing with endDraw(), just as draw() runs a script.
+ * RELATIONS:
+ *    processFile() - Draws a valid L-system.
+ *    startExpansion()/nextExpanded() - Expand the L-system.
+ *    beginDraw()/runCommand()/endDraw() - Draw the commands.
+ * IMPORTS:
+ *    lsystem - The valid L-system.
+ *    options - Run settings, choosing between framebuffer, direct and image
+ *              mode.
+ *    shown - Points to the frame shown on the terminal, NULL if unknown.
+ *            Updated to the frame drawn, or NULL if drawn directly.
+ * EXPORTS:
+ *    none
+ */
+
+void drawLSystem( LSystem* lsystem, Options* options, FrameBuffer** shown )
+{
+   GraphicsState* current = NULL;
+   Expansion expansion;
+   Command* cmd = NULL;
+   int ii;
+
+   startExpansion( &expansion, lsystem );
+   cmd = nextExpanded( &expansion );
+
+   if ( ( isEmpty( lsystem->start ) != 0 ) && ( cmd == NULL ) )
+   {
+      forgetShown( shown );
+      printf( "Error: No commands to perform drawing\n" );
+      printf( "       Check if the L-system draws any F, G, f, g, +, - or |\n" );
+   }
+   else
+   {
+      current = beginDraw( options, shown );
+      if ( current != NULL )
+      {
+         for ( ii = 0; ii < lsystem->start->count; ii++ )
+         {
+            runCommand( current, &( lsystem->start->commands[ii] ) );
+         }
+         while ( cmd != NULL )
+         {
+            runCommand( current, cmd );
+            cmd = nextExpanded( &expansion );
+         }
+         endDraw( current, options, shown );
+      }
+   }
+}
@@ -0,0 +1,100 @@
+/* FILE: lsystem.h
+ * AUTHOR: Kyle Notani | 19149918
+ * UNIT: UCP COMP1000
+ * PURPOSE: Header file associated with lsystem.c
+ */
+
+#ifndef LSYSTEM_H
+   #define LSYSTEM_H
+
+   #include "commandarray.h"
+   #include "structset.h"
+   #include "stringoperations.h"
+   #include "report.h"
+   #include "options.h"
+
+   /* First word of every L-system file */
+   #define LSYSTEM_MAGIC "LSYSTEM"
+
+   /* Most times the rules can be applied, each needing one more level of
+    * the expansion's stack */
+   #define MAX_LSYSTEM_DEPTH 32
+
+   /* Number of symbols, one per value of a char */
+   #define LSYSTEM_SYMBOLS 256
+
+   /* Turn of + and -, and length of F, G, f and g, when none is given */
+   #define LSYSTEM_ANGLE 90.0
+   #define LSYSTEM_DISTANCE 1.0
+
+   /* Commands the symbols run: F and G draw, f and g move, + and - turn by
+    * the angle and | turns around */
+   #define LSYSTEM_ACTIONS 5
+
+   /* Stores the symbols a symbol is rewritten to, within the text of the
+    * L-system */
+   typedef struct
+   {
+      /* Index of the first symbol */
+      int start;
+      /* Number of symbols, -1 for a symbol with no rule */
+      int length;
+   } Production;
+
+   /* Stores an L-system read from a file, expanded a symbol at a time as
+    * it is drawn */
+   typedef struct
+   {
+      /* Symbols of the axiom and every rule, one after another */
+      char* symbols;
+      Production axiom;
+      Production rules[LSYSTEM_SYMBOLS];
+      /* Index into actions of the command each symbol runs, -1 for none */
+      signed char symbolActions[LSYSTEM_SYMBOLS];
+      Command actions[LSYSTEM_ACTIONS];
+      /* Times the rules are applied */
+      int depth;
+      /* Ordinary commands run before the expansion */
+      CommandArray* start;
+   } LSystem;
+
+   /* Stores where the expansion of one production is up to */
+   typedef struct
+   {
+      const char* next;
+      const char* end;
+   } Rewrite;
+
+   /* Stores where the expansion of an L-system is up to as it is drawn,
+    * one production being expanded per level */
+   typedef struct
+   {
+      LSystem* lsystem;
+      /* Productions being expanded, the axiom first */
+      int depth;
+      Rewrite stack[MAX_LSYSTEM_DEPTH + 1];
+   } Expansion;
+
+   /* Checks if a file's text starts as an L-system does. */
+   int isLSystem( Span* text );
+
+   /* Reads the axiom, rules and settings of an L-system, adding any error
+    * messages to the report. Returns whether every line was valid.
+    */
+   int readLSystem( Span* text, LSystem* lsystem, Report* report );
+
+   /* Deallocates the symbols and commands of an L-system. */
+   void freeLSystem( LSystem* lsystem );
+
+   /* Starts expanding an L-system from the first symbol of its axiom. */
+   void startExpansion( Expansion* expansion, LSystem* lsystem );
+
+   /* Expands the L-system on to the next symbol that runs a command,
+    * returning the command, or NULL once the expansion ends.
+    */
+   Command* nextExpanded( Expansion* expansion );
+
+   /* Draws the commands an L-system expands to, as they are expanded. */
+   void drawLSystem( LSystem* lsystem, Options* options, FrameBuffer** shown );
+
+#endif
@@ -0,0 +1,480 @@
+/*
+ * FILE: optimise.c
+ * AUTHOR: Kyle Notani | 19149918
+ * UNIT: UCP COMP1000
+ * PURPOSE: Remove the commands of a valid script that make no difference
+ *          to what is drawn, between validating and drawing it.
+ * OTHER: The turtle is moved along with the commands using the same
+ *        conversions.c functions drawing uses, and commands are only folded
+ *        together when that gives exactly the same position and angle, so
+ *        every cell drawn stays the same.
+ *        '-1' evaluates to true, '0' evaluates to false.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "optimise.h"
+#include "commandarray.h"
+#include "structset.h"
+#include "conversions.h"
+#include "bytecode.h"
+
+static void optimiseRotate( Optimiser* turtle, Command* commands, int index, char* isKept );
+static void optimiseMove( Optimiser* turtle, Command* commands, int index, char* isKept );
+static void optimiseDraw( Optimiser* turtle, Command* commands, int index, char* isKept );
+static void optimiseSetting( Optimiser* turtle, Setting* setting, int value, Command* commands, int index, char* isKept );
+static void initSetting( Setting* setting );
+static void simulateDraw( Optimiser* turtle, double fromX, double fromY, double distance, double* x, double* y );
+static int isWholeDistance( double distance );
+
+
+/* NAME: optimiseScript()
+ * PURPOSE: Removes commands that make no difference to what is drawn,
+ *          returning how many commands were removed.
+ * HOW IT WORKS: - Goes through the commands once, keeping track of the
+ *                 turtle, and marks each command kept or not.
+ *               - Rotates in a row fold into one, taken mod 360 by
+ *                 defineAngle(), or vanish if they turn back to the same
+ *                 angle.
+ *               - Moves at the same angle with no draw between them fold
+ *                 into one.
+ *               - FG, BG and PATTERN commands setting what is already set,
+ *                 or set again before anything is drawn, are dead.
+ *               - Draws carrying on along the same line with nothing set
+ *                 between them merge into one, if allowed.
+ *               - Nothing after the last draw shows, so it is removed too,
+ *                 other than the colours left on the terminal.
+ *               - The kept commands are then moved down over the gaps, in
+ *                 order.
+ *               - A script with REPEAT blocks or procedures doesn't run
+ *                 straight through, so is left as it is.
+ * RELATIONS:
+ *    processFile() - Optimises a valid script when chosen in the options.
+ * IMPORTS:
+ *    array - The valid commands, in order, optimised in place.
+ *    canMergeDraws - Boolean, '0' (FALSE) to leave every draw as it is.
+ *                    Merged draws cover the same cells, but a pixel image
+ *                    draws the gap between two lines' cells differently.
+ * EXPORTS:
+ *    removed - Number of commands removed, 0 if there was no memory to
+ *              optimise with or the script has blocks.
+ */
+
+int optimiseScript( CommandArray* array, int canMergeDraws )
+{
+   int removed = 0;
+   int lastDraw = -1;
+   int ii = 0;
+   int kept = 0;
+   char* isKept = NULL;
+   Optimiser turtle;
+
+   Command* commands = array->commands;
+
+   if ( ( array->count > 0 ) && ( hasBlocks( array ) == 0 ) )
+   {
+      isKept = ( char* )malloc( array->count * sizeof( char ) );
+   }
+
+   if ( isKept != NULL )
+   {
+      /* Starts as drawing does, at the origin facing right */
+      turtle.x = 0.0;
+      turtle.y = 0.0;
+      turtle.angle = 0.0;
+      turtle.dirX = 1.0;
+      turtle.dirY = 0.0;
+      turtle.rotateAt = -1;
+      turtle.moveAt = -1;
+      turtle.drawAt = -1;
+      turtle.canMergeDraws = canMergeDraws;
+      initSetting( &( turtle.fg ) );
+      initSetting( &( turtle.bg ) );
+      initSetting( &( turtle.pattern ) );
+
+      for ( ii = 0; ii < array->count; ii++ )
+      {
+         isKept[ii] = -1;
+         switch ( commands[ii].opcode )
+         {
+            case OP_ROTATE:
+               optimiseRotate( &turtle, commands, ii, isKept );
+               break;
+            case OP_MOVE:
+               optimiseMove( &turtle, commands, ii, isKept );
+               break;
+            case OP_DRAW:
+               optimiseDraw( &turtle, commands, ii, isKept );
+               break;
+            case OP_FG:
+               optimiseSetting( &turtle, &( turtle.fg ), commands[ii].value.integer, commands, ii, isKept );
+               break;
+            case OP_BG:
+               optimiseSetting( &turtle, &( turtle.bg ), commands[ii].value.integer, commands, ii, isKept );
+               break;
+            case OP_PATTERN:
+               optimiseSetting( &turtle, &( turtle.pattern ), commands[ii].value.pattern, commands, ii, isKept );
+               break;
+            default:
+               break;
+         }
+         if ( ( commands[ii].opcode == OP_DRAW ) && ( isKept[ii] != 0 ) )
+         {
+            lastDraw = ii;
+         }
+      }
+
+      /* Nothing after the last draw shows, but the colours last set are
+       * left on the terminal. A script that draws nothing is left for
+       * draw() to report */
+      if ( lastDraw >= 0 )
+      {
+         for ( ii = lastDraw + 1; ii < array->count; ii++ )
+         {
+            if ( ( commands[ii].opcode != OP_FG ) && ( commands[ii].opcode != OP_BG ) )
+            {
+               isKept[ii] = 0;
+            }
+         }
+      }
+
+      for ( ii = 0; ii < array->count; ii++ )
+      {
+         if ( isKept[ii] != 0 )
+         {
+            commands[kept] = commands[ii];
+            kept++;
+         }
+      }
+      removed = array->count - kept;
+      array->count = kept;
+      free( isKept );
+   }
+
+   return removed;
+}
+
+
+/* NAME: optimiseRotate()
+ * PURPOSE: Folds a rotate into the last rotate kept, or removes it if it
+ *          leaves the angle as it was.
+ * HOW IT WORKS: Finds the new angle with defineAngle() as rotate() does.
+ *               With a rotate kept since the last draw or move, that rotate
+ *               is changed to turn straight to the new angle, as long as
+ *               defineAngle() gives exactly the same angle from it, or is
+ *               removed if the angle is back to where it started.
+ * RELATIONS:
+ *    optimiseScript() - Optimises each rotate.
+ *    defineDirection() - Keeps the direction in step with the angle.
+ * IMPORTS:
+ *    turtle - The state of the turtle before the command.
+ *    commands - The commands being optimised.
+ *    index - Index of the rotate.
+ *    isKept - Marks whether each command is kept.
+ * EXPORTS:
+ *    none
+ */
+
+static void optimiseRotate( Optimiser* turtle, Command* commands, int index, char* isKept )
+{
+   double angle = defineAngle( turtle->angle + commands[index].value.real );
+   double folded = 0.0;
+
+   if ( turtle->rotateAt >= 0 )
+   {
+      isKept[index] = 0;
+      folded = angle - turtle->rotateFrom;
+      if ( angle == turtle->rotateFrom )
+      {
+         isKept[turtle->rotateAt] = 0;
+         turtle->rotateAt = -1;
+      }
+      else if ( defineAngle( turtle->rotateFrom + folded ) == angle )
+      {
+         commands[turtle->rotateAt].value.real = folded;
+      }
+      else
+      {
+         isKept[index] = -1;
+         turtle->rotateAt = index;
+         turtle->rotateFrom = turtle->angle;
+      }
+   }
+   else if ( angle == turtle->angle )
+   {
+      isKept[index] = 0;
+   }
+   else
+   {
+      turtle->rotateAt = index;
+      turtle->rotateFrom = turtle->angle;
+   }
+
+   turtle->angle = angle;
+   defineDirection( turtle->angle, &( turtle->dirX ), &( turtle->dirY ) );
+}
+
+
+/* NAME: optimiseMove()
+ * PURPOSE: Folds a move into the last move kept, or removes it if it
+ *          doesn't move the turtle.
+ * HOW IT WORKS: Moves the turtle with defineCoordinates() as move() does.
+ *               With a move kept since the last draw, at the same angle,
+ *               that move is lengthened to reach the new position instead,
+ *               as long as it reaches exactly the same position.
+ * RELATIONS:
+ *    optimiseScript() - Optimises each move.
+ * IMPORTS:
+ *    turtle - The state of the turtle before the command.
+ *    commands - The commands being optimised.
+ *    index - Index of the move.
+ *    isKept - Marks whether each command is kept.
+ * EXPORTS:
+ *    none
+ */
+
+static void optimiseMove( Optimiser* turtle, Command* commands, int index, char* isKept )
+{
+   double x = 0.0;
+   double y = 0.0;
+   double foldedX = 0.0;
+   double foldedY = 0.0;
+   double folded = 0.0;
+
+   defineCoordinates( &( turtle->x ), &( turtle->y ), &x, &y, &( turtle->dirX ), &( turtle->dirY ), &( commands[index].value.real ) );
+
+   if ( ( x == turtle->x ) && ( y == turtle->y ) )
+   {
+      isKept[index] = 0;
+   }
+   else
+   {
+      if ( ( turtle->moveAt >= 0 ) && ( turtle->moveAngle == turtle->angle ) )
+      {
+         folded = commands[turtle->moveAt].value.real + commands[index].value.real;
+         defineCoordinates( &( turtle->moveFromX ), &( turtle->moveFromY ), &foldedX, &foldedY, &( turtle->dirX ), &( turtle->dirY ), &folded );
+         if ( ( foldedX == x ) && ( foldedY == y ) )
+         {
+            isKept[index] = 0;
+            commands[turtle->moveAt].value.real = folded;
+         }
+      }
+
+      if ( isKept[index] != 0 )
+      {
+         turtle->moveAt = index;
+         turtle->moveFromX = turtle->x;
+         turtle->moveFromY = turtle->y;
+         turtle->moveAngle = turtle->angle;
+         turtle->rotateAt = -1;
+         turtle->drawAt = -1;
+      }
+   }
+
+   turtle->x = x;
+   turtle->y = y;
+}
+
+
+/* NAME: optimiseDraw()
+ * PURPOSE: Merges a draw into the last draw kept when it carries on along
+ *          the same line.
+ * HOW IT WORKS: - Moves the turtle with simulateDraw() as drawLine() does.
+ *               - A draw of a whole distance from a whole cell straight
+ *                 along an axis covers exactly the cells from its start to
+ *                 the cell before its end. So when the last draw kept was
+ *                 one, at the same angle with nothing set since, and this
+ *                 is one too, the last draw is lengthened to cover both.
+ *               - Any draw kept uses the settings in effect, so they are no
+ *                 longer dead.
+ * RELATIONS:
+ *    optimiseScript() - Optimises each draw.
+ * IMPORTS:
+ *    turtle - The state of the turtle before the command.
+ *    commands - The commands being optimised.
+ *    index - Index of the draw.
+ *    isKept - Marks whether each command is kept.
+ * EXPORTS:
+ *    none
+ */
+
+static void optimiseDraw( Optimiser* turtle, Command* commands, int index, char* isKept )
+{
+   double x = 0.0;
+   double y = 0.0;
+   double mergedX = 0.0;
+   double mergedY = 0.0;
+   double merged = 0.0;
+   int isAxis = ( ( turtle->dirX == 0.0 ) || ( turtle->dirY == 0.0 ) );
+
+   simulateDraw( turtle, turtle->x, turtle->y, commands[index].value.real, &x, &y );
+
+   if ( ( turtle->canMergeDraws != 0 ) && ( turtle->drawAt >= 0 ) && ( isAxis != 0 ) &&
+        ( turtle->drawAngle == turtle->angle ) &&
+        ( turtle->drawFromX == floor( turtle->drawFromX ) ) &&
+        ( turtle->drawFromY == floor( turtle->drawFromY ) ) &&
+        ( isWholeDistance( commands[turtle->drawAt].value.real ) != 0 ) &&
+        ( isWholeDistance( commands[index].value.real ) != 0 ) )
+   {
+      merged = commands[turtle->drawAt].value.real + commands[index].value.real;
+      simulateDraw( turtle, turtle->drawFromX, turtle->drawFromY, merged, &mergedX, &mergedY );
+      if ( ( merged <= MAX_MERGED_DISTANCE ) && ( mergedX == x ) && ( mergedY == y ) )
+      {
+         isKept[index] = 0;
+         commands[turtle->drawAt].value.real = merged;
+      }
+   }
+
+   if ( isKept[index] != 0 )
+   {
+      turtle->drawAt = index;
+      turtle->drawFromX = turtle->x;
+      turtle->drawFromY = turtle->y;
+      turtle->drawAngle = turtle->angle;
+      turtle->rotateAt = -1;
+      turtle->moveAt = -1;
+      turtle->fg.at = -1;
+      turtle->bg.at = -1;
+      turtle->pattern.at = -1;
+   }
+
+   turtle->x = x;
+   turtle->y = y;
+}
+
+
+/* NAME: optimiseSetting()
+ * PURPOSE: Removes an FG, BG or PATTERN command that is dead.
+ * HOW IT WORKS: - With the setting already set since the last draw, nothing
+ *                 has used that value, so that command takes this value
+ *                 instead, or is removed too if this is the value the last
+ *                 draw used.
+ *               - Otherwise a command setting the value already set is
+ *                 removed.
+ *               - Settings are only known once a command sets them, as the
+ *                 terminal may start with other colours.
+ * RELATIONS:
+ *    optimiseScript() - Optimises each FG, BG and PATTERN.
+ * IMPORTS:
+ *    turtle - The state of the turtle before the command.
+ *    setting - The setting the command sets.
+ *    value - The value the command sets.
+ *    commands - The commands being optimised.
+ *    index - Index of the command.
+ *    isKept - Marks whether each command is kept.
+ * EXPORTS:
+ *    none
+ */
+
+static void optimiseSetting( Optimiser* turtle, Setting* setting, int value, Command* commands, int index, char* isKept )
+{
+   if ( setting->at >= 0 )
+   {
+      isKept[index] = 0;
+      if ( ( setting->isBeforeKnown != 0 ) && ( setting->before == value ) )
+      {
+         isKept[setting->at] = 0;
+         setting->at = -1;
+      }
+      else
+      {
+         commands[setting->at].value = commands[index].value;
+      }
+   }
+   else if ( ( setting->isKnown != 0 ) && ( setting->value == value ) )
+   {
+      isKept[index] = 0;
+   }
+   else
+   {
+      setting->at = index;
+      setting->before = setting->value;
+      setting->isBeforeKnown = setting->isKnown;
+      turtle->drawAt = -1;
+   }
+
+   setting->value = value;
+   setting->isKnown = -1;
+}
+
+
+/* NAME: initSetting()
+ * PURPOSE: Starts a setting off unknown, with nothing setting it.
+ * HOW IT WORKS: Clears every field.
+ * RELATIONS:
+ *    optimiseScript() - Starts off FG, BG and PATTERN.
+ * IMPORTS:
+ *    setting - The setting to start off.
+ * EXPORTS:
+ *    none
+ */
+
+static void initSetting( Setting* setting )
+{
+   setting->value = 0;
+   setting->isKnown = 0;
+   setting->at = -1;
+   setting->before = 0;
+   setting->isBeforeKnown = 0;
+}
+
+
+/* NAME: simulateDraw()
+ * PURPOSE: Finds where a draw leaves the turtle, exactly as drawLine()
+ *          does.
+ * HOW IT WORKS: Goes distance-1 along the direction, rounds the end to a
+ *               whole cell, then moves on by one.
+ * RELATIONS:
+ *    optimiseDraw() - Moves the turtle, and checks merged draws end in the
+ *                     same place.
+ * IMPORTS:
+ *    turtle - Gives the direction.
+ *    fromX/fromY - Where the draw starts.
+ *    distance - Distance of the draw.
+ *    x/y - Set to where the draw leaves the turtle.
+ * EXPORTS:
+ *    none
+ */
+
+static void simulateDraw( Optimiser* turtle, double fromX, double fromY, double distance, double* x, double* y )
+{
+   double endX = 0.0;
+   double endY = 0.0;
+   double finalMove = 1.0;
+
+   distance -= 1;
+   defineCoordinates( &fromX, &fromY, &endX, &endY, &( turtle->dirX ), &( turtle->dirY ), &distance );
+   endX = floor( endX + 0.5 );
+   endY = floor( endY + 0.5 );
+   defineCoordinates( &endX, &endY, x, y, &( turtle->dirX ), &( turtle->dirY ), &finalMove );
+}
+
+
+/* NAME: isWholeDistance()
+ * PURPOSE: Checks a draw's distance is a whole number of cells, at least
+ *          one, so it covers exactly the cells up to its end.
+ * HOW IT WORKS: Compares it to its floor.
+ * RELATIONS:
+ *    optimiseDraw() - Checks both draws before merging them.
+ * IMPORTS:
+ *    distance - Distance of a draw.
+ * EXPORTS:
+ *    isWhole - Boolean evaluating to '-1' (TRUE) if the distance is a whole
+ *              number from 1 to MAX_MERGED_DISTANCE, or '0' (FALSE)
+ *              otherwise.
+ */
+
+static int isWholeDistance( double distance )
+{
+   int isWhole = 0;
+
+   if ( ( distance >= 1.0 ) && ( distance <= MAX_MERGED_DISTANCE ) && ( distance == floor( distance ) ) )
+   {
+      isWhole = -1;
+   }
+
+   return isWhole;
+}
@@ -0,0 +1,69 @@
+/* FILE: optimise.h
+ * AUTHOR: Kyle Notani | 19149918
+ * UNIT: UCP COMP1000
+ * PURPOSE: Header file associated with optimise.c
+ */
+
+#ifndef OPTIMISE_H
+   #define OPTIMISE_H
+
+   #include "commandarray.h"
+
+   /* Largest distance two draws are merged up to, small enough that every
+    * whole number along the way is exact */
+   #define MAX_MERGED_DISTANCE 1000000000.0
+
+   /* Tracks an FG, BG or PATTERN setting while optimising */
+   typedef struct
+   {
+      /* Value in effect, valid once a command has set it */
+      int value;
+      int isKnown;
+      /* Index of the command setting it since the last draw, -1 if none */
+      int at;
+      /* Value that command replaced, the one the last draw used */
+      int before;
+      int isBeforeKnown;
+   } Setting;
+
+   /* Tracks the turtle while optimising, moved exactly as drawing moves it,
+    * along with the commands later ones may be folded into */
+   typedef struct
+   {
+      /* Position, angle and direction, as drawing would have them */
+      double x;
+      double y;
+      double angle;
+      double dirX;
+      double dirY;
+      /* Last rotate kept since the last draw or move, -1 if none, and the
+       * angle before it */
+      int rotateAt;
+      double rotateFrom;
+      /* Last move kept since the last draw, -1 if none, and the position
+       * and angle it moved from */
+      int moveAt;
+      double moveFromX;
+      double moveFromY;
+      double moveAngle;
+      /* Last draw kept, -1 if a move or setting was kept since, and the
+       * position and angle it drew from */
+      int drawAt;
+      double drawFromX;
+      double drawFromY;
+      double drawAngle;
+      /* Whether draws may be merged at all */
+      int canMergeDraws;
+      /* FG, BG and PATTERN */
+      Setting fg;
+      Setting bg;
+      Setting pattern;
+   } Optimiser;
+
+   /* Removes commands that make no difference to what is drawn, folding
+    * rotates, moves and collinear draws together, returning how many
+    * commands were removed.
+    */
+   int optimiseScript( CommandArray* array, int canMergeDraws );
+
+#endif
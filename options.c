@@ -0,0 +1,447 @@
+/*
+ * FILE: options.c
+ * AUTHOR: Kyle Notani | 19149918
+ * UNIT: UCP COMP1000
+ * PURPOSE: Read the command line arguments into the settings used for a
+ *          single run of TurtleGraphics.
+ * OTHER: '-1' evaluates to true, '0' evaluates to false.
+ */
+
+#define _POSIX_C_SOURCE 199506L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+
+#include "options.h"
+#include "chunks.h"
+
+static int parseViewport( char* text, Viewport* view );
+static int parseCanvas( char* text, Options* options );
+static int parseSize( char* text, int* width, int* height );
+static int findFormat( char* filename, ImageFormat* format );
+static int parseThreads( char* text, int* threads );
+static void fitTerminal( Viewport* view );
+
+
+/* NAME: parseOptions()
+ * PURPOSE: Reads the command line arguments into an Options struct, returning
+ *          if the arguments were valid.
+ * HOW IT WORKS: - Starts from the default settings.
+ *               - Any argument starting with '-' is matched against the known
+ *                 options. The viewport (-v), canvas (-c), image output (-o),
+ *                 image resolution (-r), thread count (-j) and compiled
+ *                 script (-b) options take the following argument as their
+ *                 value.
+ *               - Fixed-point coordinates (-f) are chosen for drawing,
+ *                 whichever way it is drawn.
+ *               - An image output named *.ppm is written in colour, one
+ *                 named *.pgm in greyscale and one named *.svg as vector
+ *                 graphics. Any other name is not valid.
+ *               - Streaming (-s) draws each line as it is read, so can't be
+ *                 used with the options working on the whole file,
+ *                 compiling (-b) and optimising (-O).
+ *               - Exactly one other argument must be given, which is taken as
+ *                 the filename. '-' names standard input, which can't be
+ *                 watched for changes.
+ *               - A viewport drawn on the terminal is held within it with
+ *                 fitTerminal().
+ * RELATIONS:
+ *    main() - Reads the settings before any file operations.
+ * IMPORTS:
+ *    argc - The number of command-line arguments.
+ *    argv - The argument strings (argument vector).
+ *    options - Options struct to fill with the chosen settings.
+ * EXPORTS:
+ *    isValid - A boolean evaluating to '0' (FALSE) if an option is unknown or
+ *              has an invalid value, or the filename count is wrong, or '-1'
+ *              (TRUE) otherwise.
+ */
+
+int parseOptions( int argc, char* argv[], Options* options )
+{
+   int isValid = -1;
+   int fileCount = 0;
+   int ii;
+
+   /* Default settings */
+   options->filename = NULL;
+   options->direct = 0;
+   options->watch = 0;
+   options->stream = 0;
+   options->view.left = 0;
+   options->view.top = 0;
+   options->view.width = VIEW_WIDTH;
+   options->view.height = VIEW_HEIGHT;
+   options->canvasWidth = CANVAS_WIDTH;
+   options->canvasHeight = CANVAS_HEIGHT;
+   options->maxDistance = MAX_DISTANCE;
+   options->imageName = NULL;
+   options->imageWidth = IMAGE_WIDTH;
+   options->imageHeight = IMAGE_HEIGHT;
+   options->imageFormat = FORMAT_PPM;
+   options->threads = 0;
+   options->binaryName = NULL;
+   options->optimise = 0;
+   options->fixed = 0;
+
+   for ( ii = 1; ( ii < argc ) && ( isValid != 0 ); ii++ )
+   {
+      if ( strcmp( argv[ii], "-d" ) == 0 )
+      {
+         options->direct = -1;
+      }
+      else if ( strcmp( argv[ii], "-w" ) == 0 )
+      {
+         options->watch = -1;
+      }
+      else if ( strcmp( argv[ii], "-s" ) == 0 )
+      {
+         options->stream = -1;
+      }
+      else if ( strcmp( argv[ii], "-O" ) == 0 )
+      {
+         options->optimise = -1;
+      }
+      else if ( strcmp( argv[ii], "-f" ) == 0 )
+      {
+         options->fixed = -1;
+      }
+      else if ( strcmp( argv[ii], "-v" ) == 0 )
+      {
+         ii++;
+         if ( ( ii >= argc ) || ( parseViewport( argv[ii], &( options->view ) ) == 0 ) )
+         {
+            isValid = 0;
+            printf( "Error: option -v needs a viewport left,top,width,height\n" );
+            printf( "       with a width and height of at least 1, ending by %d\n", INT_MAX );
+         }
+      }
+      else if ( strcmp( argv[ii], "-c" ) == 0 )
+      {
+         ii++;
+         if ( ( ii >= argc ) || ( parseCanvas( argv[ii], options ) == 0 ) )
+         {
+            isValid = 0;
+            printf( "Error: option -c needs a canvas width,height\n" );
+            printf( "       with a width and height from 1 to %d\n", CANVAS_MAX );
+         }
+      }
+      else if ( strcmp( argv[ii], "-o" ) == 0 )
+      {
+         ii++;
+         if ( ( ii >= argc ) || ( findFormat( argv[ii], &options->imageFormat ) == 0 ) )
+         {
+            isValid = 0;
+            printf( "Error: option -o needs an image filename\n" );
+            printf( "       ending in .ppm, .pgm or .svg\n" );
+         }
+         else
+         {
+            options->imageName = argv[ii];
+         }
+      }
+      else if ( strcmp( argv[ii], "-r" ) == 0 )
+      {
+         ii++;
+         if ( ( ii >= argc ) ||
+              ( parseSize( argv[ii], &( options->imageWidth ), &( options->imageHeight ) ) == 0 ) ||
+              ( options->imageWidth > IMAGE_MAX ) || ( options->imageHeight > IMAGE_MAX ) )
+         {
+            isValid = 0;
+            printf( "Error: option -r needs an image width,height\n" );
+            printf( "       with a width and height from 1 to %d\n", IMAGE_MAX );
+         }
+      }
+      else if ( strcmp( argv[ii], "-b" ) == 0 )
+      {
+         ii++;
+         if ( ii >= argc )
+         {
+            isValid = 0;
+            printf( "Error: option -b needs a compiled script filename\n" );
+         }
+         else
+         {
+            options->binaryName = argv[ii];
+         }
+      }
+      else if ( strcmp( argv[ii], "-j" ) == 0 )
+      {
+         ii++;
+         if ( ( ii >= argc ) || ( parseThreads( argv[ii], &( options->threads ) ) == 0 ) )
+         {
+            isValid = 0;
+            printf( "Error: option -j needs a thread count from 1 to %d\n", MAX_THREADS );
+         }
+      }
+      else if ( ( argv[ii][0] == '-' ) && ( argv[ii][1] != '\0' ) )
+      {
+         isValid = 0;
+         printf( "Error: option %s is not recognised\n", argv[ii] );
+      }
+      else
+      {
+         options->filename = argv[ii];
+         fileCount++;
+      }
+   }
+
+   if ( ( isValid != 0 ) && ( fileCount != 1 ) )
+   {
+      isValid = 0;
+      printf( "Error: argument count %d is not valid\n", argc );
+      printf( "       enter filename along execution\n" );
+   }
+   else if ( ( isValid != 0 ) && ( options->watch != 0 ) && ( strcmp( options->filename, "-" ) == 0 ) )
+   {
+      isValid = 0;
+      printf( "Error: option -w can't watch standard input\n" );
+   }
+   else if ( ( isValid != 0 ) && ( options->stream != 0 ) && ( options->binaryName != NULL ) )
+   {
+      isValid = 0;
+      printf( "Error: option -b compiles a whole file, so can't be used with -s\n" );
+   }
+   else if ( ( isValid != 0 ) && ( options->stream != 0 ) && ( options->optimise != 0 ) )
+   {
+      isValid = 0;
+      printf( "Error: option -O optimises a whole file, so can't be used with -s\n" );
+   }
+
+   if ( ( isValid != 0 ) && ( options->imageName == NULL ) && ( options->binaryName == NULL ) )
+   {
+      fitTerminal( &options->view );
+   }
+
+   return isValid;
+}
+
+
+/* NAME: parseViewport()
+ * PURPOSE: Reads a viewport written as left,top,width,height.
+ * HOW IT WORKS: Reads the four integers with sscanf(), rejecting anything
+ *               following them, any width or height below 1, and any
+ *               viewport whose right or bottom edge is past INT_MAX.
+ * RELATIONS:
+ *    parseOptions() - Reads the value of the viewport option.
+ * IMPORTS:
+ *    text - The viewport as written on the command line.
+ *    view - Viewport to fill, left unchanged if the text is invalid.
+ * EXPORTS:
+ *    isValid - A boolean evaluating to '0' (FALSE) if the text is not a
+ *              valid viewport, or '-1' (TRUE) otherwise.
+ */
+
+static int parseViewport( char* text, Viewport* view )
+{
+   int isValid = 0;
+   int left, top, width, height;
+   char extra;
+
+   if ( ( sscanf( text, "%d,%d,%d,%d%c", &left, &top, &width, &height, &extra ) == 4 ) &&
+        ( width > 0 ) && ( height > 0 ) &&
+        ( left <= INT_MAX - width ) && ( top <= INT_MAX - height ) )
+   {
+      isValid = -1;
+      view->left = left;
+      view->top = top;
+      view->width = width;
+      view->height = height;
+   }
+
+   return isValid;
+}
+
+
+/* NAME: parseCanvas()
+ * PURPOSE: Reads a canvas size written as width,height.
+ * HOW IT WORKS: - Reads the size with parseSize(), rejecting either side
+ *                 past CANVAS_MAX.
+ *               - Lines may then be as long as the larger side of the
+ *                 canvas, if that is longer than MAX_DISTANCE.
+ * RELATIONS:
+ *    parseOptions() - Reads the value of the canvas option.
+ * IMPORTS:
+ *    text - The canvas size as written on the command line.
+ *    options - Options to fill, left unchanged if the text is invalid.
+ * EXPORTS:
+ *    isValid - A boolean evaluating to '0' (FALSE) if the text is not a
+ *              valid canvas size, or '-1' (TRUE) otherwise.
+ */
+
+static int parseCanvas( char* text, Options* options )
+{
+   int isValid = 0;
+   int width, height;
+
+   if ( ( parseSize( text, &width, &height ) != 0 ) &&
+        ( width <= CANVAS_MAX ) && ( height <= CANVAS_MAX ) )
+   {
+      isValid = -1;
+      options->canvasWidth = width;
+      options->canvasHeight = height;
+      options->maxDistance = MAX_DISTANCE;
+      if ( width > options->maxDistance )
+      {
+         options->maxDistance = width;
+      }
+      if ( height > options->maxDistance )
+      {
+         options->maxDistance = height;
+      }
+   }
+
+   return isValid;
+}
+
+
+/* NAME: parseSize()
+ * PURPOSE: Reads a size written as width,height.
+ * HOW IT WORKS: Reads the two integers with sscanf(), rejecting anything
+ *               following them and any width or height below 1.
+ * RELATIONS:
+ *    parseCanvas() - Reads the size of the canvas.
+ *    parseOptions() - Reads the resolution of the image.
+ * IMPORTS:
+ *    text - The size as written on the command line.
+ *    width/height - Set to the size, left unchanged if the text is invalid.
+ * EXPORTS:
+ *    isValid - A boolean evaluating to '0' (FALSE) if the text is not a
+ *              valid size, or '-1' (TRUE) otherwise.
+ */
+
+static int parseSize( char* text, int* width, int* height )
+{
+   int isValid = 0;
+   int readWidth, readHeight;
+   char extra;
+
+   if ( ( sscanf( text, "%d,%d%c", &readWidth, &readHeight, &extra ) == 2 ) &&
+        ( readWidth > 0 ) && ( readHeight > 0 ) )
+   {
+      isValid = -1;
+      *width = readWidth;
+      *height = readHeight;
+   }
+
+   return isValid;
+}
+
+
+/* NAME: findFormat()
+ * PURPOSE: Chooses the format of an image from its filename.
+ * HOW IT WORKS: Compares the end of the name to the PPM, PGM and SVG
+ *               extensions, rejecting any other name rather than writing a
+ *               format it doesn't name.
+ * RELATIONS:
+ *    parseOptions() - Chooses the format of the exported image.
+ * IMPORTS:
+ *    filename - Name of the image file.
+ *    format - Format to fill, left unchanged if the extension is unknown.
+ * EXPORTS:
+ *    isValid - A boolean evaluating to '0' (FALSE) if the extension is not
+ *              a known image format, or '-1' (TRUE) otherwise.
+ */
+
+static int findFormat( char* filename, ImageFormat* format )
+{
+   int isValid = 0;
+   size_t length = strlen( filename );
+
+   if ( length >= 4 )
+   {
+      isValid = -1;
+      if ( strcmp( filename + length - 4, ".ppm" ) == 0 )
+      {
+         *format = FORMAT_PPM;
+      }
+      else if ( strcmp( filename + length - 4, ".pgm" ) == 0 )
+      {
+         *format = FORMAT_PGM;
+      }
+      else if ( strcmp( filename + length - 4, ".svg" ) == 0 )
+      {
+         *format = FORMAT_SVG;
+      }
+      else
+      {
+         isValid = 0;
+      }
+   }
+
+   return isValid;
+}
+
+
+/* NAME: parseThreads()
+ * PURPOSE: Reads the number of threads to validate the file on.
+ * HOW IT WORKS: Reads the integer with sscanf(), rejecting anything
+ *               following it and any count outside 1 to MAX_THREADS.
+ * RELATIONS:
+ *    parseOptions() - Reads the value of the thread count option.
+ * IMPORTS:
+ *    text - The thread count as written on the command line.
+ *    threads - Thread count to fill, left unchanged if the text is invalid.
+ * EXPORTS:
+ *    isValid - A boolean evaluating to '0' (FALSE) if the text is not a
+ *              valid thread count, or '-1' (TRUE) otherwise.
+ */
+
+static int parseThreads( char* text, int* threads )
+{
+   int isValid = 0;
+   int count;
+   char extra;
+
+   if ( ( sscanf( text, "%d%c", &count, &extra ) == 1 ) && ( count >= 1 ) && ( count <= MAX_THREADS ) )
+   {
+      isValid = -1;
+      *threads = count;
+   }
+
+   return isValid;
+}
+
+
+/* NAME: fitTerminal()
+ * PURPOSE: Holds a viewport drawn on the terminal within the terminal.
+ * HOW IT WORKS: Asks for the size of the terminal on standard output with
+ *               the TIOCGWINSZ ioctl(), taking TERMINAL_WIDTH columns and
+ *               any number of rows when it can't be found. The viewport's
+ *               width and height are cut down to the columns and rows, so
+ *               no cell drawn is past the right margin, where the terminal
+ *               would wrap a run of cells or a relative cursor move onto
+ *               the next row.
+ * RELATIONS:
+ *    parseOptions() - Fits the viewport unless exporting or compiling.
+ * IMPORTS:
+ *    view - The viewport to fit.
+ * EXPORTS:
+ *    none
+ */
+
+static void fitTerminal( Viewport* view )
+{
+   struct winsize size;
+   int columns = TERMINAL_WIDTH;
+   int rows = INT_MAX;
+
+   if ( ( ioctl( STDOUT_FILENO, TIOCGWINSZ, &size ) == 0 ) && ( size.ws_col > 0 ) && ( size.ws_row > 0 ) )
+   {
+      columns = size.ws_col;
+      rows = size.ws_row;
+   }
+
+   if ( view->width > columns )
+   {
+      view->width = columns;
+   }
+   if ( view->height > rows )
+   {
+      view->height = rows;
+   }
+}
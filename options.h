@@ -0,0 +1,85 @@
+/* FILE: options.h
+ * AUTHOR: Kyle Notani | 19149918
+ * UNIT: UCP COMP1000
+ * PURPOSE: Header file associated with options.c
+ */
+
+#ifndef OPTIONS_H
+   #define OPTIONS_H
+
+   #include "viewport.h"
+   #include "image.h"
+
+   /* Size in cells of the canvas when none is chosen */
+   #define CANVAS_WIDTH 1024
+   #define CANVAS_HEIGHT 1024
+
+   /* Longest DRAW or MOVE distance allowed unless a larger canvas is chosen,
+    * the width of a standard terminal */
+   #define MAX_DISTANCE 80
+
+   /* Columns the viewport drawn on the terminal is held within when the
+    * terminal's size can't be found, such as when output is redirected */
+   #define TERMINAL_WIDTH 80
+
+   /* Longest side of a canvas, 2^30 cells, so a line as long as it from
+    * anywhere on it still ends within an int */
+   #define CANVAS_MAX 1073741824
+
+   /* File formats the viewport can be exported in, chosen by the image
+    * filename's extension */
+   typedef enum
+   {
+      FORMAT_PPM,
+      FORMAT_PGM,
+      FORMAT_SVG
+   } ImageFormat;
+
+   /* Stores the run settings chosen on the command line */
+   typedef struct
+   {
+      /* Name of the file containing commands, '-' for standard input */
+      char* filename;
+      /* Print each cell straight to the terminal instead of rendering
+       * into a framebuffer flushed once at the end */
+      int direct;
+      /* Keep redrawing the file whenever it changes, sending only the
+       * cells that differ from the frame on the terminal */
+      int watch;
+      /* Draw each line as soon as it is read, skipping invalid lines, in
+       * place of validating the whole file before drawing */
+      int stream;
+      /* Rectangle of the drawing shown on the terminal */
+      Viewport view;
+      /* Size in cells of the canvas kept by the framebuffer */
+      int canvasWidth;
+      int canvasHeight;
+      /* Longest DRAW or MOVE distance allowed */
+      int maxDistance;
+      /* Name of the image file the viewport is exported to in place of the
+       * terminal, NULL to draw on the terminal */
+      char* imageName;
+      /* Size in pixels of the exported image */
+      int imageWidth;
+      int imageHeight;
+      /* Format of the exported image */
+      ImageFormat imageFormat;
+      /* Most threads the file is validated on, 0 for one per processor */
+      int threads;
+      /* Name of the compiled script written in place of drawing, NULL to
+       * draw */
+      char* binaryName;
+      /* Remove commands that make no difference to what is drawn before
+       * drawing or compiling them */
+      int optimise;
+      /* Move the turtle in 32.32 fixed-point, the same on any machine, in
+       * place of doubles */
+      int fixed;
+   } Options;
+
+   /* Reads the command line arguments into an Options struct, returning if
+    * the arguments were valid.
+    */
+   int parseOptions( int argc, char* argv[], Options* options );
+
+#endif
@@ -0,0 +1,376 @@
+/*
+ * FILE: overdraw.c
+ * AUTHOR: Kyle Notani | 19149918
+ * UNIT: UCP COMP1000
+ * PURPOSE: Find the cells of lines drawn straight to the terminal that a
+ *          later line draws over, so they are never sent at all.
+ * OTHER: The turtle is moved along with the commands exactly as drawLine(),
+ *        move() and rotate() move it, so the lines found are those drawn.
+ *        Only the last line drawn to a cell decides what it shows, whatever
+ *        its pattern and colours.
+ *        '-1' evaluates to true, '0' evaluates to false.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "overdraw.h"
+#include "commandarray.h"
+#include "structset.h"
+#include "viewport.h"
+#include "conversions.h"
+#include "bytecode.h"
+#include "fixed.h"
+
+static int traceLines( CommandArray* array, Viewport* clip, int isFixed, int* ends, long* cells );
+static void coverSegment( Overdraw* overdraw, int index, Segment* seg, Viewport* clip,
+                          unsigned char* covered, long first );
+
+
+/* NAME: findOverdraw()
+ * PURPOSE: Finds which cells of each line drawn are drawn over by a later
+ *          line, returning NULL if every cell is to be drawn.
+ * HOW IT WORKS: - Counts the draws run, following the script's blocks with
+ *                 nextCommand(), up to MAX_OVERDRAW_LINES.
+ *               - Traces the line of every draw with traceLines(), counting
+ *                 the cells within the viewport.
+ *               - Goes back through the lines from the last, with a bit per
+ *                 viewport cell marking those already covered. A cell not
+ *                 yet covered is seen, since no later line draws over it.
+ *               - Lines with no cell seen are then skipped entirely.
+ * RELATIONS:
+ *    draw() - Finds the overdraw before drawing straight to the terminal.
+ *    takeLine() - Gives drawLine() the cells seen of each line.
+ * IMPORTS:
+ *    array - The commands to be drawn.
+ *    clip - The viewport lines are clipped to.
+ *    isFixed - Whether the turtle is moved in fixed-point.
+ * EXPORTS:
+ *    overdraw - The overdraw on the heap, or NULL if the drawing is too big
+ *               to check or there was no memory to check it with.
+ */
+
+Overdraw* findOverdraw( CommandArray* array, Viewport* clip, int isFixed )
+{
+   Overdraw* overdraw = NULL;
+   unsigned char* covered = NULL;
+   long viewCells = ( long )clip->width * ( long )clip->height;
+   long cells = 0;
+   long first = 0;
+   int lines = 0;
+   int ii = 0;
+   Segment seg;
+   Runner runner;
+   Command* cmd = NULL;
+
+   startRunner( &runner );
+   cmd = nextCommand( &runner, array );
+   while ( ( cmd != NULL ) && ( lines <= MAX_OVERDRAW_LINES ) )
+   {
+      if ( cmd->opcode == OP_DRAW )
+      {
+         lines++;
+      }
+      cmd = nextCommand( &runner, array );
+   }
+
+   if ( ( lines > 0 ) && ( lines <= MAX_OVERDRAW_LINES ) &&
+        ( viewCells > 0 ) && ( viewCells <= MAX_COVERAGE_CELLS ) )
+   {
+      overdraw = ( Overdraw* )malloc( sizeof( Overdraw ) );
+   }
+   if ( overdraw != NULL )
+   {
+      overdraw->lines = lines;
+      overdraw->next = 0;
+      overdraw->nextCell = 0;
+      overdraw->seen = NULL;
+      overdraw->isSeen = ( char* )malloc( lines * sizeof( char ) );
+      overdraw->ends = ( int* )malloc( lines * 4 * sizeof( int ) );
+      if ( ( overdraw->isSeen == NULL ) || ( overdraw->ends == NULL ) ||
+           ( traceLines( array, clip, isFixed, overdraw->ends, &cells ) == 0 ) )
+      {
+         freeOverdraw( overdraw );
+         overdraw = NULL;
+      }
+   }
+   if ( overdraw != NULL )
+   {
+      overdraw->seen = ( unsigned char* )calloc( ( cells / 8 ) + 1, sizeof( unsigned char ) );
+      covered = ( unsigned char* )calloc( ( viewCells / 8 ) + 1, sizeof( unsigned char ) );
+      if ( ( overdraw->seen == NULL ) || ( covered == NULL ) )
+      {
+         freeOverdraw( overdraw );
+         overdraw = NULL;
+      }
+   }
+
+   if ( overdraw != NULL )
+   {
+      /* Back to front, each line's cells end where the next line's begin */
+      first = cells;
+      for ( ii = lines - 1; ii >= 0; ii-- )
+      {
+         overdraw->isSeen[ii] = 0;
+         if ( clipLine( clip, overdraw->ends[ii * 4], overdraw->ends[ii * 4 + 1],
+                        overdraw->ends[ii * 4 + 2], overdraw->ends[ii * 4 + 3], &seg ) != 0 )
+         {
+            first -= seg.count;
+            coverSegment( overdraw, ii, &seg, clip, covered, first );
+         }
+      }
+   }
+   free( covered );
+
+   return overdraw;
+}
+
+
+/* NAME: traceLines()
+ * PURPOSE: Finds the rounded ends of every draw's line, as drawLine()
+ *          rounds them, returning whether the lines are small enough to
+ *          check.
+ * HOW IT WORKS: Moves the turtle through the commands in the order
+ *               nextCommand() runs them, with the same conversions.c
+ *               functions drawing uses. Each draw goes distance-1 along
+ *               the direction, rounds the end to a whole cell, then moves
+ *               on by one. The cells of each line within
+ *               the viewport are counted with clipLine(). In fixed-point
+ *               the turtle is moved with the fixed.c functions drawing uses
+ *               instead.
+ * RELATIONS:
+ *    findOverdraw() - Traces the lines before checking them.
+ * IMPORTS:
+ *    array - The commands to be drawn.
+ *    clip - The viewport lines are clipped to.
+ *    isFixed - Whether the turtle is moved in fixed-point.
+ *    ends - Set to the start and end cell of each draw's line, in order.
+ *    cells - Set to the number of cells of every line within the viewport.
+ * EXPORTS:
+ *    isSmall - Boolean evaluating to '-1' (TRUE) if there are at most
+ *              MAX_OVERDRAW_CELLS cells within the viewport, or '0' (FALSE)
+ *              otherwise.
+ */
+
+static int traceLines( CommandArray* array, Viewport* clip, int isFixed, int* ends, long* cells )
+{
+   double x = 0.0;
+   double y = 0.0;
+   double angle = 0.0;
+   double dirX = 1.0;
+   double dirY = 0.0;
+   double endX = 0.0;
+   double endY = 0.0;
+   double distance = 0.0;
+   double finalMove = 1.0;
+   int isSmall = -1;
+   int line = 0;
+   FixedTurtle fixed;
+   Fixed fixedEndX;
+   Fixed fixedEndY;
+   Segment seg;
+   Runner runner;
+   Command* cmd = NULL;
+
+   *cells = 0;
+   startFixed( &fixed );
+   startRunner( &runner );
+   cmd = nextCommand( &runner, array );
+   while ( ( cmd != NULL ) && ( isSmall != 0 ) )
+   {
+      switch ( cmd->opcode )
+      {
+         case OP_DRAW:
+            if ( isFixed != 0 )
+            {
+               ends[line * 4] = fixedToCell( fixed.x );
+               ends[line * 4 + 1] = fixedToCell( fixed.y );
+               fixedDraw( &fixed, cmd->value.real, &fixedEndX, &fixedEndY );
+               ends[line * 4 + 2] = fixedToCell( fixedEndX );
+               ends[line * 4 + 3] = fixedToCell( fixedEndY );
+            }
+            else
+            {
+               distance = cmd->value.real - 1;
+               defineCoordinates( &x, &y, &endX, &endY, &dirX, &dirY, &distance );
+               ends[line * 4] = round( x );
+               ends[line * 4 + 1] = round( y );
+               ends[line * 4 + 2] = round( endX );
+               ends[line * 4 + 3] = round( endY );
+               endX = floor( endX + 0.5 );
+               endY = floor( endY + 0.5 );
+               defineCoordinates( &endX, &endY, &x, &y, &dirX, &dirY, &finalMove );
+            }
+            if ( clipLine( clip, ends[line * 4], ends[line * 4 + 1], ends[line * 4 + 2], ends[line * 4 + 3], &seg ) != 0 )
+            {
+               *cells += seg.count;
+               if ( *cells > MAX_OVERDRAW_CELLS )
+               {
+                  isSmall = 0;
+               }
+            }
+            line++;
+            break;
+         case OP_MOVE:
+            if ( isFixed != 0 )
+            {
+               fixedMove( &fixed, cmd->value.real );
+            }
+            else
+            {
+               endX = x;
+               endY = y;
+               defineCoordinates( &endX, &endY, &x, &y, &dirX, &dirY, &( cmd->value.real ) );
+            }
+            break;
+         case OP_ROTATE:
+            if ( isFixed != 0 )
+            {
+               fixedRotate( &fixed, cmd->value.real );
+            }
+            else
+            {
+               angle = defineAngle( angle + cmd->value.real );
+               defineDirection( angle, &dirX, &dirY );
+            }
+            break;
+         default:
+            break;
+      }
+      cmd = nextCommand( &runner, array );
+   }
+
+   return isSmall;
+}
+
+
+/* NAME: coverSegment()
+ * PURPOSE: Marks the cells of a line not yet covered by a later line as
+ *          seen, then covers every cell of it.
+ * HOW IT WORKS: Steps through the segment with Bresenham's line algorithm,
+ *               as drawSegment() in effects.c does, so the same cells are
+ *               visited in the same order.
+ * RELATIONS:
+ *    findOverdraw() - Covers each line, from the last.
+ * IMPORTS:
+ *    overdraw - The overdraw being found.
+ *    index - Index of the line's draw.
+ *    seg - The part of the line within the viewport.
+ *    clip - The viewport.
+ *    covered - A bit per viewport cell, set once covered.
+ *    first - The bit of the segment's first cell in the seen bits.
+ * EXPORTS:
+ *    none
+ */
+
+static void coverSegment( Overdraw* overdraw, int index, Segment* seg, Viewport* clip,
+                          unsigned char* covered, long first )
+{
+   int x = seg->x - clip->left;
+   int y = seg->y - clip->top;
+   int decision = seg->decision;
+   int ii = 0;
+   long cell = 0;
+   long bit = 0;
+
+   for ( ii = 0; ii < seg->count; ii++ )
+   {
+      cell = ( long )y * clip->width + x;
+      if ( ( covered[cell >> 3] & ( 1 << ( cell & 7 ) ) ) == 0 )
+      {
+         covered[cell >> 3] |= ( unsigned char )( 1 << ( cell & 7 ) );
+         bit = first + ii;
+         overdraw->seen[bit >> 3] |= ( unsigned char )( 1 << ( bit & 7 ) );
+         overdraw->isSeen[index] = -1;
+      }
+
+      /* Move along one cell and (possibly) across one as well */
+      if ( seg->xIsMajor != 0 )
+      {
+         x += seg->stepX;
+      }
+      else
+      {
+         y += seg->stepY;
+      }
+      decision += seg->minorDelta;
+      if ( decision >= seg->majorDelta )
+      {
+         decision -= seg->majorDelta;
+         if ( seg->xIsMajor != 0 )
+         {
+            y += seg->stepY;
+         }
+         else
+         {
+            x += seg->stepX;
+         }
+      }
+   }
+}
+
+
+/* NAME: takeLine()
+ * PURPOSE: Takes the next line drawn, returning where its cells' bits
+ *          start in the seen bits.
+ * HOW IT WORKS: Checks the line is the one traced for the next draw, then
+ *               moves on past it and its cells. Should a line ever not be
+ *               the one expected, it and every line after it are drawn in
+ *               full.
+ * RELATIONS:
+ *    drawLine() - Takes each line drawn straight to the terminal.
+ * IMPORTS:
+ *    overdraw - The overdraw found for the drawing.
+ *    x1/y1/x2/y2 - Rounded ends of the line.
+ *    count - Number of cells of the line within the viewport.
+ * EXPORTS:
+ *    first - The bit of the line's first cell, LINE_HIDDEN if no cell of
+ *            it is seen, or LINE_UNCHECKED if every cell is to be drawn.
+ */
+
+long takeLine( Overdraw* overdraw, int x1, int y1, int x2, int y2, int count )
+{
+   long first = LINE_UNCHECKED;
+   int* ends = overdraw->ends + ( overdraw->next * 4 );
+
+   if ( overdraw->next < overdraw->lines )
+   {
+      if ( ( ends[0] == x1 ) && ( ends[1] == y1 ) && ( ends[2] == x2 ) && ( ends[3] == y2 ) )
+      {
+         first = ( overdraw->isSeen[overdraw->next] != 0 ) ? overdraw->nextCell : LINE_HIDDEN;
+         overdraw->nextCell += count;
+         overdraw->next++;
+      }
+      else
+      {
+         overdraw->next = overdraw->lines;
+      }
+   }
+
+   return first;
+}
+
+
+/* NAME: freeOverdraw()
+ * PURPOSE: Frees the overdraw found for a drawing.
+ * HOW IT WORKS: Frees each array, then the overdraw itself.
+ * RELATIONS:
+ *    draw() - Frees the overdraw once drawn.
+ * IMPORTS:
+ *    overdraw - The overdraw, NULL for none.
+ * EXPORTS:
+ *    none
+ */
+
+void freeOverdraw( Overdraw* overdraw )
+{
+   if ( overdraw != NULL )
+   {
+      free( overdraw->ends );
+      free( overdraw->isSeen );
+      free( overdraw->seen );
+      free( overdraw );
+   }
+}
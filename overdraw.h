@@ -0,0 +1,41 @@
+/* FILE: overdraw.h
+ * AUTHOR: Kyle Notani | 19149918
+ * UNIT: UCP COMP1000
+ * PURPOSE: Header file associated with overdraw.c
+ */
+
+#ifndef OVERDRAW_H
+   #define OVERDRAW_H
+
+   #include "commandarray.h"
+   #include "structset.h"
+   #include "viewport.h"
+
+   /* Most cells, of the viewport or of every line within it, checked for
+    * overdraw. Beyond these every cell is drawn */
+   #define MAX_COVERAGE_CELLS 67108864L
+   #define MAX_OVERDRAW_CELLS 268435456L
+
+   /* Most draws checked for overdraw, a script looping past them being
+    * drawn in full */
+   #define MAX_OVERDRAW_LINES 4194304
+
+   /* Returned by takeLine() for a line with no cell seen, and for a line it
+    * didn't expect, to be drawn in full */
+   #define LINE_HIDDEN -1L
+   #define LINE_UNCHECKED -2L
+
+   /* Finds which cells of each line drawn are drawn over by a later line,
+    * returning NULL if every cell is to be drawn.
+    */
+   Overdraw* findOverdraw( CommandArray* array, Viewport* clip, int isFixed );
+
+   /* Takes the next line drawn, returning the bit of its first cell in the
+    * seen bits, LINE_HIDDEN or LINE_UNCHECKED.
+    */
+   long takeLine( Overdraw* overdraw, int x1, int y1, int x2, int y2, int count );
+
+   /* Frees the overdraw found for a drawing. */
+   void freeOverdraw( Overdraw* overdraw );
+
+#endif
@@ -2,49 +2,67 @@
  * FILE: readinput.c
  * AUTHOR: Kyle Notani | 19149918
  * UNIT: UCP COMP1000
- * PURPOSE: Read formatted commands from file and store into linked list
+ * PURPOSE: Read formatted commands from file and store into command array
  *          while assuring that each command matches the specified format.
  * FILE FORMATS: Any text based file.
- * COMMAND ARGUMENTS: A single filename containing commands to draw.
+ * COMMAND ARGUMENTS: A single filename containing commands to draw, optionally
+ *                    preceded by options (see options.c).
  * OTHER: '-1' evaluates to true, '0' evaluates to false. See readinput.h.
  */
 
+#define _POSIX_C_SOURCE 199506L
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <ctype.h>
+#include <time.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
 
 #include "readinput.h"
 #include "validators.h"
-#include "listoperations.h"
-#include "linkedlist.h"
+#include "arrayoperations.h"
+#include "commandarray.h"
 #include "structset.h"
 #include "draw.h"
 #include "stringoperations.h"
+#include "options.h"
+#include "chunks.h"
+#include "report.h"
+#include "stream.h"
+#include "binaryscript.h"
+#include "optimise.h"
+#include "bytecode.h"
+#include "lsystem.h"
+
+/* Bytes read at a time from a file that can't be mapped */
+#define READ_CHUNK 65536
+
+static int readScript( int fd, Script* script );
+static void runScript( CommandArray* array, Options* options, FrameBuffer** shown );
 
 /* 
  * NAME: main()
- * PURPOSE: Entry point to the program. Reads in a series of commands top to bottom 
- *          from an input file while validating its viability to perform various 
- *          draw operations on the terminal.
- * HOW IT WORKS: - Uses fgets() for each line (excludes blank lines) in the file 
- *                 until the file has ended.
- *               - Each line containing any text will be validated with various 
- *                 validators.c functions depending on the command identified.
- *               - If a single validation function returns false then the file is
- *                 marked as invalid and any errors will be printed out to identify
- *                 what and where the problem occured in the file.
- *               - An invalid file indicates that drawing may not commence
- *                 until all errors are fixed.
- *               - Each validated command operation in the file will be stored
- *                 using storeCommand().
+ * PURPOSE: Entry point to the program. Reads the run settings then reads and
+ *          draws the input file, again each time it changes in watch mode.
+ * HOW IT WORKS: - Reads the options with parseOptions().
+ *               - Reads, validates and draws the file with processFile(), or
+ *                 draws each line as soon as it is read with streamFile() in
+ *                 streaming mode.
+ *               - In watch mode, waits for the file to change and processes
+ *                 it again, keeping the frame on the terminal so only the
+ *                 cells that changed are redrawn. Runs until interrupted.
  * RELATIONS:
- *    constructList() - Allocates an empty linked list.
- *    validateCommandName() - Validates the name of a command giving
- *                            parameters as exports to pointers to other validator 
- *                            functions.
- *    storeCommand() - Stores a command (name and value) into the constructed 
- *                     linked list.
- *    freeList() - Free the list including any list nodes and its associated values.
+ *    parseOptions() - Reads the filename and run settings from the arguments.
+ *    processFile() - Reads, validates and draws the file.
+ *    streamFile() - Validates and draws each line as it is read.
+ *    getFileStamp() - Records which version of the file was read.
+ *    waitForChange() - Waits in watch mode for the file to change.
  *
  * IMPORTS: 
  *    argc  The number of command-line arguments.
@@ -57,156 +75,267 @@
 
 int main( int argc, char* argv[] )
 {
+   /* settings chosen on the command line */
+   Options options;
+
+   /* exit status, 1 if the options are invalid */
+   int status = 0;
+
+   /* frame currently shown on the terminal, NULL if unknown */
+   FrameBuffer* shown = NULL;
 
-   /* pointer to the input file containing commands */
-   FILE* input = NULL;
+   /* version of the file last read */
+   FileStamp stamp;
 
-   /* the number of bytes from the start of file */
-   long fileDistance = 0;
+   /* whether to read the file again */
+   int keepDrawing = FALSE;
+
+   /* If arguments are invalid, do not proceed with file operations */
+   if ( parseOptions( argc, argv, &options ) == FALSE )
+   {
+      printf( "       usage: %s [-d] [-w] [-s] [-O] [-f] [-v left,top,width,height] [-c width,height]\n"
+              "              [-o image.ppm|image.pgm|image.svg] [-r width,height] [-j threads]\n"
+              "              [-b compiled.tgb] filename|-\n", argv[0] );
+      status = 1;
+   }
+   else
+   {
+      getFileStamp( options.filename, &stamp );
+      do
+      {
+         if ( options.stream != FALSE )
+         {
+            streamFile( &options, &shown );
+         }
+         else
+         {
+            processFile( &options, &shown );
+         }
 
-   /* string (array of chars) of length maximum buffer size for each line read */
-   char line[BUFFER_LENGTH];
-   
-   /* a copied alternative for the original line for use in validators.c functions */
-   char* tempLine = NULL;
+         keepDrawing = options.watch;
+         if ( keepDrawing != FALSE )
+         {
+            fflush( stdout );
+            waitForChange( options.filename, &stamp );
+         }
+      } while ( keepDrawing != FALSE );
 
-   /* the command value as a string */
-   char* strValue = NULL;
+      if ( shown != NULL )
+      {
+         freeFrame( shown );
+      }
+   }
+   return status;
+}
 
-   /* error pointer required for strtoX() functions */
-   char* errorString = NULL;
+
+/* 
+ * NAME: processFile()
+ * PURPOSE: Reads in a series of commands top to bottom from an input file
+ *          while validating its viability to perform various draw operations
+ *          on the terminal.
+ * HOW IT WORKS: - Loads the whole file with loadScript(). A compiled script is
+ *                 checked with readBinaryScript() and run straight from the
+ *                 mapped file, with no parsing.
+ *               - A file starting with LSYSTEM is read with readLSystem()
+ *                 and drawn with drawLSystem(), which expands it as it is
+ *                 drawn, so its commands are never stored. It can't be
+ *                 compiled, and is left as it is by optimising.
+ *               - A text file instead has every line validated by
+ *                 validateScript(), which splits the file into chunks and
+ *                 validates them on as many threads as the options allow.
+ *                 Lines are validated in place as spans of the file's text,
+ *                 so nothing is copied but the values converted.
+ *               - If a single line is not valid then the file is marked as
+ *                 invalid and any errors will be printed out, in line order,
+ *                 to identify what and where the problem occured in the file.
+ *               - Once every line is valid, the REPEAT blocks and
+ *                 procedures are linked up with compileBlocks(), which
+ *                 reports any block left open or ] with none to close.
+ *               - An invalid file indicates that drawing may not commence
+ *                 until all errors are fixed.
+ *               - Each validated command operation in the file will be
+ *                 stored in the command array. The text is then unloaded
+ *                 before drawing, as the commands no longer refer to it.
+ *               - When chosen, the commands of a valid file are optimised
+ *                 before drawing, and the number removed is reported.
+ *               - Anything printed disturbs the frame on the terminal, so the
+ *                 shown frame is dropped and the next one drawn in full. The
+ *                 report is therefore left out when a valid file is redrawn
+ *                 over a shown frame.
+ * RELATIONS:
+ *    setMaxDistance() - Sets the longest distance the validators allow.
+ *    loadScript()/unloadScript() - Map in and release the file's text.
+ *    constructArray() - Allocates an empty command array.
+ *    validateScript() - Validates every line, storing each valid command
+ *                       into the constructed command array.
+ *    compileBlocks() - Links each block to where it jumps.
+ *    isBinaryScript()/readBinaryScript() - Run a compiled script in place.
+ *    isLSystem()/readLSystem()/drawLSystem() - Draw an L-system.
+ *    printReport() - Prints the error messages of every line.
+ *    optimiseScript() - Removes commands that make no difference to what is
+ *                       drawn.
+ *    freeArray() - Free the array including every stored command's values.
+ *
+ *    runScript() - Draws or compiles the commands of a valid file.
+ *
+ * IMPORTS: 
+ *    options - Run settings, including the filename.
+ *    shown - Points to the frame shown on the terminal, NULL if unknown. Updated
+ *            to the frame drawn.
+ *
+ * EXPORTS:
+ *    none
+ */
+
+void processFile( Options* options, FrameBuffer** shown )
+{
+   /* the whole text of the input file containing commands */
+   Script script;
+
+   /* whether the file could be loaded */
+   int isLoaded = FALSE;
+
+   /* the whole text as a single span */
+   Span text;
+
+   /* error messages of every line, printed before the summary */
+   Report report;
+
+   /* commands of a compiled script, read in place */
+   CommandArray compiled;
+
+   /* axiom and rules of an L-system */
+   LSystem lsystem;
 
    /* data structure to store commands */
-   LinkedList* list = NULL;
+   CommandArray* array = NULL;
 
-   /* used for easy error identification in file printed to the terminal 
-    * for invalid commands, data types, parameters and ranges */
-   int lineNo = 0;
+   /* number of valid commands stored */
    int cmdsRead = 0;
 
+   /* number of commands removed by optimising */
+   int cmdsRemoved = 0;
+
    /* to identify invalid files */
    int isInvalid = FALSE;
 
-   /* validator values to verify each line */
-   int foundCommand = FALSE;
-   int correctParameters = FALSE;
-   int correctDataType = FALSE;
-   int correctRange = FALSE;
 
-   /* pointers to validators.c functions to validate each command */
-   CmdParamFunc validateParameters;
-   CmdDataFunc validateDataType;
-   CmdRangeFunc validateRange; 
+   initReport( &report );
+   setMaxDistance( options->maxDistance );
+   isLoaded = loadScript( options->filename, &script );
+   array = constructArray();
 
+   /* Output error if input file can't open */
+   if ( isLoaded == FALSE )
+   {
+      forgetShown( shown );
+      perror( "Error: file could not be opened\n" );
+      printf( "       check if file exists\n" );
+      if ( array != NULL )
+      {
+         freeArray( array );
+      }
+   }
 
-   /* If argument count is invalid, do not proceed with file operations */
-   if ( argc != MAX_ARG )
+   /* Output error if array can't be constructed */
+   else if ( array == NULL )
    {
-      printf( "Error: argument count %d is not valid\n", argc );
-      printf( "       enter filename along execution\n" );
+      forgetShown( shown );
+      printf( "Error: could not construct command array data structure\n" );
+      unloadScript( &script );
    }
    else
    {
-      input = fopen( argv[1], "r" );
-      list = constructList();      
-
-      /* Output error if input file can't open */
-      if ( input == NULL )
+      /* Check if input file is empty */
+      if ( script.length <= MIN_FILE_DATA )
       {
-         perror( "Error: file could not be opened\n" );
-         printf( "       check if file exists\n" );
-         freeList(list);
+         forgetShown( shown );
+         printf( "Error: file contains no data\n" );
+         unloadScript( &script );
       }
-
-      /* Output error if list can't be constructed */
-      else if ( list == NULL )
+      else  
       {
-         printf( "Error: could not construct list data structure\n" );
-      }
-      else
-      {
-         /* Check if input file is empty */
-         fseek( input, 0, SEEK_SET );
-         fseek( input, 0, SEEK_END );
-         fileDistance = ftell( input );
+         text.start = script.data;
+         text.length = script.length;
 
-         if ( fileDistance <= MIN_FILE_DATA )
+         /* A compiled script is run in place, with no parsing */
+         if ( isBinaryScript( &text ) != FALSE )
          {
-            printf( "Error: file contains no data\n" );
+            if ( readBinaryScript( &text, &compiled, &report ) == FALSE )
+            {
+               forgetShown( shown );
+               printReport( &report );
+               printf( "Error: compiled file is damaged, invalid or was compiled by another version\n" );
+               printf( "       compile the text file again\n" );
+            }
+            else
+            {
+               runScript( &compiled, options, shown );
+            }
+            unloadScript( &script );
          }
-         else  
+         /* An L-system is expanded as it is drawn, never stored */
+         else if ( isLSystem( &text ) != FALSE )
          {
-            rewind( input );
+            isInvalid = ( readLSystem( &text, &lsystem, &report ) == FALSE );
+            unloadScript( &script );
 
-            /* Grab each line */
-            while ( fgets( line, BUFFER_LENGTH, input ) != NULL )
+            if ( ( isInvalid != FALSE ) || ( *shown == NULL ) )
             {
-               lineNo++;
-
-               /* Make another copy of the line for validation */
-               tempLine = ( char* )malloc( BUFFER_LENGTH * sizeof(char) );
-               strcpy( tempLine, line );
-
-               /* Skip any line just containing control characters (non-printable) */
-               if ( stringIsCtrl( line ) == FALSE )
+               forgetShown( shown );
+               printReport( &report );
+               printf( "---------------------REPORT---------------------\n" );
+               printf( "End of file reached\n" );
+               printf( "L-system rules applied %d time(s)\n", lsystem.depth );
+               if ( isInvalid != FALSE )
                {
-                  /* Identify the validation operations to commence 
-                   * (pointers to functions) if the command name is found */
-                  foundCommand = validateCommandName( tempLine, &validateDataType, &validateParameters, &validateRange );      
-
-                  if ( foundCommand == FALSE )
-                  {
-                     isInvalid = -1;
-                     printf( "Error: Line %d. command unidentified\n", lineNo);
-                     printf( "       check if value exists and/or name is spelt correctly\n");
-                  }
-                  else
-                  {
-                     /* Check datatype of value */
-                     correctDataType = ( *validateDataType )( &errorString, &strValue );
-
-                     /* Check parameter count */
-                     correctParameters = ( *validateParameters )( &strValue, &errorString );
-
-                     if ( correctParameters == FALSE )
-                     {
-                        isInvalid = -1;
-                        printf( "       Line %d. incorrect number of parameters for command\n\n", lineNo);
-                     }
-                     if ( correctDataType == FALSE )
-                     {
-                        isInvalid = -1;
-                        printf( "       Line %d. incorrect data type for command\n\n", lineNo);
-                     }
-                     if ( ( correctParameters != FALSE ) && (correctDataType != FALSE ) )
-                     {
-                        /* Check value range */
-                        correctRange = ( *validateRange )( &strValue );
-                        if ( correctRange == FALSE )
-                        {
-                           isInvalid = -1;
-                           printf( "       Line %d. incorrect range for command\n\n", lineNo );
-                        }
-                        else
-                        {
-                           /* Increment the no of commands read/found */
-                           cmdsRead++;
-                           /* Insert the command into the linked list */
-                           storeCommand( line, list );
-                        }
-                     }
-                  }
+                  printf( "Fix any listed errors to draw\n" );
                }
-               free( tempLine );
-               tempLine = NULL;
+               printf( "------------------------------------------------\n" );
+            }
+
+            if ( ( isInvalid == FALSE ) && ( options->binaryName != NULL ) )
+            {
+               forgetShown( shown );
+               printf( "Error: an L-system can't be compiled, draw it instead\n" );
+            }
+            else if ( isInvalid == FALSE )
+            {
+               drawLSystem( &lsystem, options, shown );
+            }
+            freeLSystem( &lsystem );
+         }
+         else
+         {
+            isInvalid = validateScript( &text, options->threads, array, &report, &cmdsRead );
+            unloadScript( &script );
+
+            if ( ( isInvalid == FALSE ) && ( compileBlocks( array, &report ) == FALSE ) )
+            {
+               isInvalid = -1;
+            }
+
+            /* Merged draws only cover the same cells, which pixel images
+             * and compiled scripts (drawn anywhere later) can't rely on */
+            if ( ( isInvalid == FALSE ) && ( options->optimise != FALSE ) )
+            {
+               cmdsRemoved = optimiseScript( array, ( options->binaryName == NULL ) &&
+                                                    ( ( options->imageName == NULL ) || ( options->imageFormat == FORMAT_SVG ) ) );
             }
-            			
+
             /* Inform that the end of file is reached after each line is read */
-            if ( fgets( line, BUFFER_LENGTH, input ) == NULL )
+            if ( ( isInvalid != FALSE ) || ( *shown == NULL ) )
             {
+               forgetShown( shown );
+               printReport( &report );
                printf( "---------------------REPORT---------------------\n" );
                printf( "End of file reached\n" );
                printf( "%d command(s) valid\n", cmdsRead );
+               if ( options->optimise != FALSE )
+               {
+                  printf( "%d command(s) removed by optimising\n", cmdsRemoved );
+               }
                if ( isInvalid != FALSE )
                {
                   printf( "Fix any listed errors to draw\n" );
@@ -217,66 +346,340 @@ int main( int argc, char* argv[] )
             /* Start drawing if file was valid */
             if ( isInvalid == FALSE )
             {
-               draw( list );
+               runScript( array, options, shown );
             }
-      
-            /* Output an error if an error was identified during reading */
-            if ( ferror( input ) )
+         }
+      }
+
+      freeArray( array );
+      array = NULL;
+   }
+   freeReport( &report );
+}
+
+/*
+ * NAME: loadScript()
+ * PURPOSE: Loads the whole text of a file, returning whether it could be
+ *          read.
+ * HOW IT WORKS: - A regular file is mapped into memory read only with mmap(),
+ *                 so its pages are read straight from the page cache with no
+ *                 copy into a buffer. An empty file needs no mapping.
+ *               - Anything that can't be mapped, such as a pipe, is read into
+ *                 memory instead with readScript(), as is standard input,
+ *                 named '-'.
+ *               - errno is kept from the call that failed, for perror().
+ * RELATIONS:
+ *    processFile() - Loads the file chosen in the options.
+ *    readScript() - Reads a file that can't be mapped.
+ *    unloadScript() - Releases the text once done with.
+ * IMPORTS:
+ *    filename - Name of the file.
+ *    script - The script to load the text into.
+ * EXPORTS:
+ *    isLoaded - Boolean evaluating to '0' (FALSE) if the file could not be
+ *               opened or read, or '-1' (TRUE) otherwise.
+ */
+
+int loadScript( char* filename, Script* script )
+{
+   int isLoaded = FALSE;
+   int fd = -1;
+   int error = 0;
+   struct stat info;
+   void* mapped = NULL;
+
+   script->data = NULL;
+   script->length = 0;
+   script->isMapped = FALSE;
+
+   if ( strcmp( filename, "-" ) == 0 )
+   {
+      isLoaded = readScript( STDIN_FILENO, script );
+   }
+   else
+   {
+      fd = open( filename, O_RDONLY );
+   }
+
+   if ( fd != -1 )
+   {
+      if ( ( fstat( fd, &info ) == 0 ) && ( S_ISREG( info.st_mode ) ) )
+      {
+         isLoaded = -1;
+         script->length = ( size_t )info.st_size;
+         if ( script->length > 0 )
+         {
+            mapped = mmap( NULL, script->length, PROT_READ, MAP_PRIVATE, fd, 0 );
+            if ( mapped != MAP_FAILED )
+            {
+               script->data = ( char* )mapped;
+               script->isMapped = -1;
+            }
+            else
             {
-               perror( "Error occured during reading\n" );
+               isLoaded = readScript( fd, script );
             }
          }
+      }
+      else
+      {
+         isLoaded = readScript( fd, script );
+      }
+
+      error = errno;
+      close( fd );
+      errno = error;
+   }
 
-         freeList( list );
-         list = NULL;
+   return isLoaded;
+}
 
-         fclose( input );
+/*
+ * NAME: readScript()
+ * PURPOSE: Reads the whole text of a file that can't be mapped into memory.
+ * HOW IT WORKS: Reads READ_CHUNK bytes at a time with read() until the end of
+ *               the file, doubling the buffer whenever it fills.
+ * RELATIONS:
+ *    loadScript() - Reads pipes and any file mmap() refused.
+ * IMPORTS:
+ *    fd - The open file, read from its current offset.
+ *    script - The script to read the text into.
+ * EXPORTS:
+ *    isRead - Boolean evaluating to '0' (FALSE) if the file could not be
+ *             read or the buffer grown, or '-1' (TRUE) otherwise.
+ */
+
+static int readScript( int fd, Script* script )
+{
+   int isRead = -1;
+   size_t capacity = READ_CHUNK;
+   char* grown = NULL;
+   ssize_t count = 0;
+
+   script->length = 0;
+   script->isMapped = FALSE;
+   script->data = ( char* )malloc( capacity );
+   if ( script->data == NULL )
+   {
+      isRead = FALSE;
+   }
+
+   do
+   {
+      if ( ( isRead != FALSE ) && ( script->length == capacity ) )
+      {
+         grown = ( char* )realloc( script->data, capacity * 2 );
+         if ( grown == NULL )
+         {
+            isRead = FALSE;
+         }
+         else
+         {
+            script->data = grown;
+            capacity *= 2;
+         }
       }
+      if ( isRead != FALSE )
+      {
+         count = read( fd, script->data + script->length, capacity - script->length );
+         if ( count > 0 )
+         {
+            script->length += ( size_t )count;
+         }
+         else if ( ( count == -1 ) && ( errno != EINTR ) )
+         {
+            isRead = FALSE;
+         }
+      }
+   } while ( ( isRead != FALSE ) && ( count != 0 ) );
+
+   if ( isRead == FALSE )
+   {
+      free( script->data );
+      script->data = NULL;
+      script->length = 0;
    }
-   return 0;
+
+   return isRead;
 }
 
 /*
- * NAME: storeCommand()
- * PURPOSE: Stores a valid command to be grouped into a Command struct 
- *          with its name and value into a linked list in reverse order.
- * HOW IT WORKS: - Allocate memory for a command struct as well as
- *                 the name and value.
- *               - Tokenise the string using strtok() to isolate the
- *                 validated command name and value to be inserted in the
- *                 command struct.
- *               - Insert the struct into a list using insertLast()
+ * NAME: unloadScript()
+ * PURPOSE: Releases the text of a loaded script.
+ * HOW IT WORKS: Unmaps the text with munmap() if it was mapped, or frees it
+ *               otherwise.
  * RELATIONS:
- *    insertLast() - Inserts a new node with the associated value into the 
- *                   end of the list
+ *    processFile() - Releases the text once every line is validated.
  * IMPORTS:
- *    line - String that contains the validated command operation
- *    list - The linked list to insert the command
- *
+ *    script - The script to release.
+ * EXPORTS:
+ *    none
+ */
+
+void unloadScript( Script* script )
+{
+   if ( script->isMapped != FALSE )
+   {
+      munmap( script->data, script->length );
+   }
+   else
+   {
+      free( script->data );
+   }
+   script->data = NULL;
+   script->length = 0;
+   script->isMapped = FALSE;
+}
+
+/*
+ * NAME: runScript()
+ * PURPOSE: Draws the commands of a valid file, or compiles them when a
+ *          compiled script is chosen in the options.
+ * HOW IT WORKS: Writes the commands with writeBinaryScript() in place of
+ *               drawing them with draw() when compiling, so nothing is drawn
+ *               on the terminal.
+ * RELATIONS:
+ *    processFile() - Runs the commands of a valid text or compiled script.
+ * IMPORTS:
+ *    array - The valid commands, in order.
+ *    options - Run settings, naming any compiled script to write.
+ *    shown - Points to the frame shown on the terminal, NULL if unknown.
+ * EXPORTS:
+ *    none
+ */
+
+static void runScript( CommandArray* array, Options* options, FrameBuffer** shown )
+{
+   if ( options->binaryName == NULL )
+   {
+      draw( array, options, shown );
+   }
+   else if ( writeBinaryScript( array, options->binaryName ) == FALSE )
+   {
+      forgetShown( shown );
+      printf( "Error: compiled file %s can't be written\n", options->binaryName );
+   }
+}
+
+/*
+ * NAME: getFileStamp()
+ * PURPOSE: Records the version of a file, to tell later whether it changed.
+ * HOW IT WORKS: Reads the modification time, size and inode of the file with
+ *               stat(). A file that can't be found is recorded as all 0.
+ * RELATIONS:
+ *    main() - Records the version of the file before reading it.
+ *    waitForChange() - Compares the file against the recorded version.
+ * IMPORTS:
+ *    filename - Name of the file.
+ *    stamp - The stamp to record the version into.
+ * EXPORTS:
+ *    none
+ */
+
+void getFileStamp( char* filename, FileStamp* stamp )
+{
+   struct stat info;
+
+   stamp->modified = 0;
+   stamp->size = 0;
+   stamp->inode = 0;
+
+   if ( stat( filename, &info ) == 0 )
+   {
+      stamp->modified = ( long )info.st_mtime;
+      stamp->size = ( long )info.st_size;
+      stamp->inode = ( long )info.st_ino;
+   }
+}
+
+/*
+ * NAME: waitForChange()
+ * PURPOSE: Waits until a file differs from the version recorded.
+ * HOW IT WORKS: Checks the file with getFileStamp() every WATCH_INTERVAL_MS
+ *               milliseconds, sleeping in between with nanosleep(). Editors
+ *               that replace the file rather than rewrite it change its
+ *               inode, so this is compared as well as the time and size.
+ * RELATIONS:
+ *    main() - Waits between redraws in watch mode.
+ * IMPORTS:
+ *    filename - Name of the file.
+ *    stamp - The version last read, updated to the new version.
  * EXPORTS:
  *    none
  */
 
-void storeCommand( char* line, LinkedList* list )
+void waitForChange( char* filename, FileStamp* stamp )
 {
-   Command* cmd = NULL;
+   FileStamp latest;
+   struct timespec interval;
+   int hasChanged = FALSE;
 
-   char* cmdName = NULL;
-   char* cmdValue = NULL;
+   interval.tv_sec = WATCH_INTERVAL_MS / 1000;
+   interval.tv_nsec = ( WATCH_INTERVAL_MS % 1000 ) * 1000000L;
 
-   /* Allocate a command struct in heap memory */
-   cmd = ( Command* )malloc( sizeof( Command ) );
-   cmd->name = ( char* )malloc( MAX_CMD_NAME * sizeof( char ) );
-   cmd->value = ( char* )malloc( MAX_DIGITS * sizeof( char ) );
+   while ( hasChanged == FALSE )
+   {
+      nanosleep( &interval, NULL );
+      getFileStamp( filename, &latest );
 
-   /* Grab each validated command name and corresponding value */
-   cmdName = strtok( line, " " );
-   cmdValue = strtok( NULL, " " );
+      if ( ( latest.modified != stamp->modified ) || ( latest.size != stamp->size ) ||
+           ( latest.inode != stamp->inode ) )
+      {
+         hasChanged = -1;
+      }
+   }
 
-   /* Store file contents into a single command struct */
-   strcpy( cmd->name, cmdName );
-   strcpy( cmd->value, cmdValue );
+   *stamp = latest;
+}
 
-   /* Pass in the command data to the list to be inserted in reverse order */
-   insertLast( list, cmd );
+/*
+ * NAME: parseCommand()
+ * PURPOSE: Makes a valid command into a compact Command struct holding its
+ *          opcode and already parsed value.
+ * HOW IT WORKS: Takes the value already parsed by its validation,
+ *               depending on the opcode, as a real, an integer, the
+ *               pattern character or a procedure name. Names are kept
+ *               upper case and padded with '\0', so they match in any
+ *               casing.
+ * RELATIONS:
+ *    validateLine() - Makes the command of each valid line.
+ * IMPORTS:
+ *    opcode - The operation of the validated command
+ *    value - The validated command value
+ *    cmd - The command to fill
+ *
+ * EXPORTS:
+ *    none
+ */
+
+void parseCommand( Opcode opcode, Operand* value, Command* cmd )
+{
+   size_t ii = 0;
+
+   cmd->opcode = opcode;
+
+   /* Take the value of the type its command operates with */
+   switch ( opcode )
+   {
+      case OP_FG:
+      case OP_BG:
+      case OP_REPEAT:
+         cmd->value.integer = value->integer;
+         break;
+      case OP_PROC:
+      case OP_CALL:
+         memset( cmd->value.name, '\0', PROC_NAME_LENGTH );
+         for ( ii = 0; ( ii < value->text.length ) && ( ii < PROC_NAME_LENGTH ) &&
+                       ( value->text.start[ii] != '\n' ); ii++ )
+         {
+            cmd->value.name[ii] = ( char )toupper( ( unsigned char )value->text.start[ii] );
+         }
+         break;
+      case OP_PATTERN:
+         cmd->value.pattern = value->text.start[0];
+         break;
+      default:
+         cmd->value.real = value->real;
+         break;
+   }
 }
@@ -7,38 +7,63 @@
 #ifndef READINPUT_H
    #define READINPUT_H
    
-   #include "linkedlist.h"
-   
-   /* Maximum number of characters in each line to be stored temporarily */
-   #define BUFFER_LENGTH 101
+   #include "commandarray.h"
+   #include "structset.h"
+   #include "options.h"
+   #include "validators.h"
    
    /* Required minimum size in bytes for file to not be empty */
    #define MIN_FILE_DATA 1
 
-   /* Maximum number of arguments for TurtleGraphics to work
-    * (includes name of executable file) */
-   #define MAX_ARG 2
-
    /* Maxmimum list of possible command errors to be identified in file 
     * reading */
    #define MAX_ERRORS 3
 
-   /* Max number of characters required to allocate for single command name 
-    * string (considers any control characters such as new line + null
-    * terminator) */
-   #define MAX_CMD_NAME 11
+   /* Milliseconds to wait between checks for a change to the file in watch
+    * mode */
+   #define WATCH_INTERVAL_MS 250
 
-   /* Maximum number of significant digits based on size of max numeric data
-    * type on a 64 bit machine (considers any control characters such as
-    * new line + null terminator )
-    */
-   #define MAX_DIGITS 18
+   /* Identifies a version of a file by its modification time, size and
+    * inode, all 0 for a file that can't be found */
+   typedef struct
+   {
+      long modified;
+      long size;
+      long inode;
+   } FileStamp;
+
+   /* Stores the whole text of a script, mapped in from the file or read
+    * into memory when it can't be mapped */
+   typedef struct
+   {
+      char* data;
+      size_t length;
+      /* Whether data is mapped, '-1' (TRUE), or allocated, '0' (FALSE) */
+      int isMapped;
+   } Script;
 
    /* Boolean Definitions */
    #define FALSE 0
    #define TRUE !FALSE
 
-   /* Inserts any valid command read in into the linked list */
-   void storeCommand( char* line, LinkedList* list );
+   /* Reads, validates and draws the commands of the file chosen in the
+    * options, over the frame shown on the terminal if any */
+   void processFile( Options* options, FrameBuffer** shown );
+
+   /* Records the version of a file */
+   void getFileStamp( char* filename, FileStamp* stamp );
+
+   /* Waits until a file differs from the version recorded, then records the
+    * new version */
+   void waitForChange( char* filename, FileStamp* stamp );
+
+   /* Loads the whole text of a file, returning whether it could be read */
+   int loadScript( char* filename, Script* script );
+
+   /* Releases the text of a loaded script */
+   void unloadScript( Script* script );
+
+   /* Makes any valid command read in into a Command struct */
+   void parseCommand( Opcode opcode, Operand* value, Command* cmd );
 
 #endif
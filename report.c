@@ -0,0 +1,191 @@
+/*
+ * FILE: report.c
+ * AUTHOR: Kyle Notani | 19149918
+ * UNIT: UCP COMP1000
+ * PURPOSE: Hold back the messages printed while validating a file, so each
+ *          part of the file can be validated on its own thread and its
+ *          messages still printed in line order.
+ * OTHER: A report belongs to a single thread until it is appended to
+ *        another, so needs no locking.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+
+#include "report.h"
+
+static void addText( Report* report, const char* text, size_t length );
+
+
+/* NAME: initReport()
+ * PURPOSE: Sets up an empty report.
+ * HOW IT WORKS: No room is allocated until the first message is added, as
+ *               most reports stay empty.
+ * RELATIONS:
+ *    processFile()/validateScript() - Set up the reports of a file and of
+ *                                     each of its chunks.
+ * IMPORTS:
+ *    report - The report to set up.
+ * EXPORTS:
+ *    none
+ */
+
+void initReport( Report* report )
+{
+   report->text = NULL;
+   report->length = 0;
+   report->capacity = 0;
+}
+
+
+/* NAME: addMessage()
+ * PURPOSE: Adds a message, formatted as printf() would, to the end of a
+ *          report.
+ * HOW IT WORKS: Formats the message with vsprintf() into a buffer of
+ *               MESSAGE_LENGTH characters, which holds any of the
+ *               validators' messages, then adds it with addText().
+ * RELATIONS:
+ *    validators.c functions - Report why a value is not valid.
+ *    validateChunk() - Reports which line failed validation.
+ * IMPORTS:
+ *    report - The report to add to.
+ *    format - printf() format of the message, followed by its values.
+ * EXPORTS:
+ *    none
+ */
+
+void addMessage( Report* report, const char* format, ... )
+{
+   char message[MESSAGE_LENGTH];
+   va_list values;
+
+   va_start( values, format );
+   vsprintf( message, format, values );
+   va_end( values );
+
+   addText( report, message, strlen( message ) );
+}
+
+
+/* NAME: appendReport()
+ * PURPOSE: Adds every message of another report to the end of a report,
+ *          emptying the other report.
+ * HOW IT WORKS: Takes over the other report's text when the report is still
+ *               empty, and copies it with addText() otherwise. An empty
+ *               other report holds no text, so is left as it is.
+ * RELATIONS:
+ *    validateScript() - Merges the reports of each chunk in line order.
+ * IMPORTS:
+ *    report - The report to add to.
+ *    other - The report whose messages are moved.
+ * EXPORTS:
+ *    none
+ */
+
+void appendReport( Report* report, Report* other )
+{
+   if ( report->length == 0 )
+   {
+      freeReport( report );
+      *report = *other;
+      initReport( other );
+   }
+   else if ( other->length > 0 )
+   {
+      addText( report, other->text, other->length );
+      freeReport( other );
+   }
+}
+
+
+/* NAME: printReport()
+ * PURPOSE: Prints every message of a report, emptying it.
+ * HOW IT WORKS: Writes the text to stdout with a single fwrite().
+ * RELATIONS:
+ *    processFile() - Prints the messages of the whole file before its
+ *                    summary.
+ * IMPORTS:
+ *    report - The report to print.
+ * EXPORTS:
+ *    none
+ */
+
+void printReport( Report* report )
+{
+   if ( report->length > 0 )
+   {
+      fwrite( report->text, 1, report->length, stdout );
+   }
+   report->length = 0;
+}
+
+
+/* NAME: freeReport()
+ * PURPOSE: Deallocates the messages of a report.
+ * HOW IT WORKS: Frees the text, leaving the report empty.
+ * RELATIONS:
+ *    processFile() - Deallocates the report of the file.
+ *    appendReport() - Deallocates the text of a report once copied.
+ * IMPORTS:
+ *    report - The report to deallocate.
+ * EXPORTS:
+ *    none
+ */
+
+void freeReport( Report* report )
+{
+   free( report->text );
+   initReport( report );
+}
+
+
+/* NAME: addText()
+ * PURPOSE: Adds text to the end of a report.
+ * HOW IT WORKS: Doubles the report's capacity whenever the text doesn't
+ *               fit. Should there be no memory for it, the text is printed
+ *               straight away rather than lost.
+ * RELATIONS:
+ *    addMessage()/appendReport() - Add formatted messages and whole reports.
+ * IMPORTS:
+ *    report - The report to add to.
+ *    text - The text to add.
+ *    length - Number of characters to add.
+ * EXPORTS:
+ *    none
+ */
+
+static void addText( Report* report, const char* text, size_t length )
+{
+   size_t capacity = report->capacity;
+   char* grown = NULL;
+
+   if ( capacity == 0 )
+   {
+      capacity = MESSAGE_LENGTH;
+   }
+   while ( capacity < report->length + length )
+   {
+      capacity *= 2;
+   }
+   if ( capacity != report->capacity )
+   {
+      grown = ( char* )realloc( report->text, capacity );
+      if ( grown != NULL )
+      {
+         report->text = grown;
+         report->capacity = capacity;
+      }
+   }
+
+   if ( report->capacity >= report->length + length )
+   {
+      memcpy( report->text + report->length, text, length );
+      report->length += length;
+   }
+   else
+   {
+      fwrite( text, 1, length, stdout );
+   }
+}
@@ -0,0 +1,40 @@
+/* FILE: report.h
+ * AUTHOR: Kyle Notani | 19149918
+ * UNIT: UCP COMP1000
+ * PURPOSE: Header file associated with report.c
+ */
+
+#ifndef REPORT_H
+   #define REPORT_H
+
+   #include <stddef.h>
+
+   /* Longest single message added to a report */
+   #define MESSAGE_LENGTH 256
+
+   /* Stores the messages printed while validating part of a file, held back
+    * so the parts can be printed in line order once all are validated */
+   typedef struct
+   {
+      char* text;
+      size_t length;
+      size_t capacity;
+   } Report;
+
+   /* Sets up an empty report. */
+   void initReport( Report* report );
+
+   /* Adds a message, formatted as printf() would, to the end of a report. */
+   void addMessage( Report* report, const char* format, ... );
+
+   /* Adds every message of another report to the end of a report, emptying
+    * the other report. */
+   void appendReport( Report* report, Report* other );
+
+   /* Prints every message of a report, emptying it. */
+   void printReport( Report* report );
+
+   /* Deallocates the messages of a report. */
+   void freeReport( Report* report );
+
+#endif
@@ -0,0 +1,305 @@
+/*
+ * FILE: stream.c
+ * AUTHOR: Kyle Notani | 19149918
+ * UNIT: UCP COMP1000
+ * PURPOSE: Validate and draw each line of a file as soon as it is read,
+ *          through a buffer of a fixed size, for long or endless machine
+ *          generated input piped straight in.
+ * FILE FORMATS: Any text based file, or standard input named as '-'.
+ * OTHER: Unlike processFile(), an invalid line does not stop the drawing. It
+ *        is skipped, and reported once the input ends.
+ *        Memory used stays the same however long the input is.
+ *        '-1' evaluates to true, '0' evaluates to false.
+ */
+
+#define _POSIX_C_SOURCE 199506L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "stream.h"
+#include "readinput.h"
+#include "validators.h"
+#include "chunks.h"
+#include "report.h"
+#include "draw.h"
+#include "stringoperations.h"
+
+static int nextLine( Span* text, int isEnd, Span* line );
+
+
+/* NAME: streamFile()
+ * PURPOSE: Validates and draws each line of the file chosen in the options
+ *          as soon as it is read, over the frame shown on the terminal if
+ *          any.
+ * HOW IT WORKS: - Reads the file, or standard input if named '-', with
+ *                 read() into a buffer of STREAM_BUFFER bytes.
+ *               - Each whole line in the buffer is validated with
+ *                 validateLine() and, if valid, run straight away with
+ *                 runCommand(). Drawing is set up with beginDraw() at the
+ *                 first valid command.
+ *               - Any partial line left is moved to the start of the buffer
+ *                 to be finished by the next read. A line filling the whole
+ *                 buffer is reported as too long and the rest of it skipped.
+ *               - REPEAT blocks and procedures need the whole script, so
+ *                 can't be streamed. Each is reported at its first line
+ *                 and skipped through to its ], as is any CALL.
+ *               - Errors of invalid lines are held back until the input
+ *                 ends, so they don't disturb the drawing, and only the
+ *                 first MAX_STREAM_ERRORS lines' are kept.
+ *               - Once the input ends, the drawing is finished with
+ *                 endDraw() and the report printed.
+ * RELATIONS:
+ *    main() - Streams the file in streaming mode.
+ *    setMaxDistance() - Sets the longest distance the validators allow.
+ *    validateLine() - Validates each line.
+ *    beginDraw()/runCommand()/endDraw() - Draw each valid command.
+ * IMPORTS:
+ *    options - Run settings, including the filename.
+ *    shown - Points to the frame shown on the terminal, NULL if unknown.
+ *            Updated to the frame drawn.
+ * EXPORTS:
+ *    none
+ */
+
+void streamFile( Options* options, FrameBuffer** shown )
+{
+   /* the file being read, and the lines read from it not yet validated */
+   int fd = 0;
+   char buffer[STREAM_BUFFER];
+   size_t length = 0;
+   long total = 0;
+   ssize_t count = 0;
+   int isEnd = FALSE;
+
+   /* lines of the buffer still to be validated, and each line found */
+   Span text;
+   Span line;
+
+   /* whether the rest of a line too long for the buffer is being skipped */
+   int isSkipping = FALSE;
+
+   /* the command found on each line, and the errors of each line */
+   Command cmd;
+   Report lineReport;
+   Report report;
+
+   /* state of the drawing, NULL until the first valid command */
+   GraphicsState* current = NULL;
+   int isDrawFailed = FALSE;
+
+   /* whether the summary is printed, unless redrawn over a shown frame */
+   int isReported = ( *shown == NULL );
+
+   int lineNo = 0;
+   int cmdsRead = 0;
+   int invalidLines = 0;
+
+   /* blocks open within the block being skipped */
+   int blockDepth = 0;
+
+   setMaxDistance( options->maxDistance );
+   initReport( &report );
+   initReport( &lineReport );
+
+   if ( strcmp( options->filename, "-" ) != 0 )
+   {
+      fd = open( options->filename, O_RDONLY );
+   }
+
+   if ( fd == -1 )
+   {
+      forgetShown( shown );
+      perror( "Error: file could not be opened\n" );
+      printf( "       check if file exists\n" );
+   }
+   else
+   {
+      while ( isEnd == FALSE )
+      {
+         count = read( fd, buffer + length, STREAM_BUFFER - length );
+         if ( count > 0 )
+         {
+            length += ( size_t )count;
+            total += ( long )count;
+         }
+         else if ( ( count == 0 ) || ( errno != EINTR ) )
+         {
+            isEnd = -1;
+            if ( count == -1 )
+            {
+               addMessage( &report, "Error: file could not be read, %s\n", strerror( errno ) );
+            }
+         }
+
+         text.start = buffer;
+         text.length = length;
+         while ( nextLine( &text, isEnd, &line ) != FALSE )
+         {
+            if ( isSkipping != FALSE )
+            {
+               /* The end of a line already reported as too long */
+               isSkipping = FALSE;
+            }
+            else
+            {
+               lineNo++;
+
+               /* Skip any line just containing control characters */
+               if ( spanIsCtrl( &line ) == FALSE )
+               {
+                  if ( validateLine( &line, lineNo, &cmd, &lineReport ) == FALSE )
+                  {
+                     invalidLines++;
+                  }
+                  else if ( ( blockDepth > 0 ) || ( cmd.opcode >= OP_REPEAT ) )
+                  {
+                     invalidLines++;
+                     if ( blockDepth == 0 )
+                     {
+                        addMessage( &lineReport, "Error: Line %d. REPEAT, PROC and CALL can't be streamed\n", lineNo );
+                        addMessage( &lineReport, "       run without -s to draw blocks\n\n" );
+                     }
+                     if ( ( cmd.opcode == OP_REPEAT ) || ( cmd.opcode == OP_PROC ) )
+                     {
+                        blockDepth++;
+                     }
+                     else if ( ( cmd.opcode == OP_END ) && ( blockDepth > 0 ) )
+                     {
+                        blockDepth--;
+                     }
+                  }
+                  else
+                  {
+                     cmdsRead++;
+                     if ( ( current == NULL ) && ( isDrawFailed == FALSE ) )
+                     {
+                        current = beginDraw( options, shown );
+                        if ( current == NULL )
+                        {
+                           isDrawFailed = -1;
+                        }
+                     }
+                     if ( current != NULL )
+                     {
+                        runCommand( current, &cmd );
+                     }
+                  }
+               }
+            }
+
+            /* Keep only the errors of the first invalid lines */
+            if ( invalidLines <= MAX_STREAM_ERRORS )
+            {
+               appendReport( &report, &lineReport );
+            }
+            else
+            {
+               freeReport( &lineReport );
+            }
+         }
+
+         /* Move any partial line to the start of the buffer */
+         memmove( buffer, text.start, text.length );
+         length = text.length;
+         if ( length == STREAM_BUFFER )
+         {
+            lineNo++;
+            invalidLines++;
+            if ( invalidLines <= MAX_STREAM_ERRORS )
+            {
+               addMessage( &report, "Error: Line %d. longer than %d characters\n\n", lineNo, STREAM_BUFFER );
+            }
+            isSkipping = -1;
+            length = 0;
+         }
+      }
+
+      if ( fd != 0 )
+      {
+         close( fd );
+      }
+
+      if ( current != NULL )
+      {
+         endDraw( current, options, shown );
+      }
+
+      if ( total <= MIN_FILE_DATA )
+      {
+         forgetShown( shown );
+         printf( "Error: file contains no data\n" );
+      }
+      else if ( ( invalidLines > 0 ) || ( report.length > 0 ) || ( isReported != FALSE ) )
+      {
+         forgetShown( shown );
+         printReport( &report );
+         if ( invalidLines > MAX_STREAM_ERRORS )
+         {
+            printf( "Errors of a further %d invalid line(s) left out\n\n", invalidLines - MAX_STREAM_ERRORS );
+         }
+         printf( "---------------------REPORT---------------------\n" );
+         printf( "End of file reached\n" );
+         printf( "%d command(s) valid\n", cmdsRead );
+         if ( invalidLines > 0 )
+         {
+            printf( "%d invalid line(s) skipped\n", invalidLines );
+         }
+         printf( "------------------------------------------------\n" );
+         if ( cmdsRead == 0 )
+         {
+            printf( "Error: No commands to perform drawing\n" );
+            printf( "       Check if file contains any commands\n" );
+         }
+      }
+   }
+
+   freeReport( &report );
+}
+
+
+/* NAME: nextLine()
+ * PURPOSE: Takes the next whole line from the start of the text read in,
+ *          returning whether there was one.
+ * HOW IT WORKS: Finds the end of the line with memchr(). A line with no new
+ *               line is only whole once the input has ended.
+ * RELATIONS:
+ *    streamFile() - Takes each line of the buffer.
+ * IMPORTS:
+ *    text - The text still to be validated, moved on past the line.
+ *    isEnd - Whether the input has ended.
+ *    line - Set to the line, including its new line if it has one.
+ * EXPORTS:
+ *    isFound - Boolean evaluating to '0' (FALSE) if no whole line is left,
+ *              or '-1' (TRUE) otherwise.
+ */
+
+static int nextLine( Span* text, int isEnd, Span* line )
+{
+   int isFound = FALSE;
+   const char* newline = ( const char* )memchr( text->start, '\n', text->length );
+
+   line->start = text->start;
+   if ( newline != NULL )
+   {
+      isFound = -1;
+      line->length = ( size_t )( newline + 1 - text->start );
+   }
+   else if ( ( isEnd != FALSE ) && ( text->length > 0 ) )
+   {
+      isFound = -1;
+      line->length = text->length;
+   }
+
+   if ( isFound != FALSE )
+   {
+      text->start += line->length;
+      text->length -= line->length;
+   }
+
+   return isFound;
+}
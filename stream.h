@@ -0,0 +1,25 @@
+/* FILE: stream.h
+ * AUTHOR: Kyle Notani | 19149918
+ * UNIT: UCP COMP1000
+ * PURPOSE: Header file associated with stream.c
+ */
+
+#ifndef STREAM_H
+   #define STREAM_H
+
+   #include "framebuffer.h"
+   #include "options.h"
+
+   /* Bytes of a file held at once while streaming, also the longest line
+    * that can be streamed */
+   #define STREAM_BUFFER 65536
+
+   /* Most invalid lines whose errors are reported while streaming, so
+    * memory stays bounded however many lines are invalid */
+   #define MAX_STREAM_ERRORS 100
+
+   /* Validates and draws each line of the file chosen in the options as soon
+    * as it is read, over the frame shown on the terminal if any */
+   void streamFile( Options* options, FrameBuffer** shown );
+
+#endif
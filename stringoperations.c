@@ -2,7 +2,8 @@
  * FILE: stringoperations.c
  * AUTHOR: Kyle Notani | 19149918
  * UNIT: UCP COMP1000
- * PURPOSE: Perform operation(s) specifically to string modifications.
+ * PURPOSE: Perform operation(s) specifically on spans of strings, read in
+ *          place without modifying or copying them.
  *          Mainly utilised by other larger functions to assist on string 
  *          identification and validity.
  * OTHER: -1 Evaluates to true, 0 Evaluates to false.
@@ -15,94 +16,478 @@
 
 #include "stringoperations.h"
 
+/* Largest power of ten a double holds exactly */
+#define MAX_EXACT_POWER 22
 
-/* NAME: stringUpperCase()
- * PURPOSE:    Converts a string to upper case. Allows for appropriate string 
- *             comparisons which check for validity.
- * HOW IT WORKS:  Checks each character to see if its corresponding numerical value
- *                is within the range of any lower case letters.
- *                Any character representing a lower case value will be converted
- *                to its upper case correspondent.
- * RELATIONS:  
+static const double exactPowers[MAX_EXACT_POWER + 1] =
+{
+   1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+   1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static double parseRealCopy( Span* span, Span* remainder );
+static long parseIntegerCopy( Span* span, Span* remainder );
+static int copySpan( Span* span, char* text );
+
+
+/* NAME: nextToken()
+ * PURPOSE: Finds the next token of a span, the same token strtok() would
+ *          find with a space as the only delimiter, without changing or
+ *          copying the text.
+ * HOW IT WORKS: Skips any spaces at the start of the span. The token then
+ *               runs up to the next space or the end of the span, and the
+ *               span is moved on past it. Other whitespace, such as a line's
+ *               trailing new line, stays part of the token.
+ * RELATIONS:
+ *    validators.c functions - Split each line into its command name, value
+ *                             and any other parameters.
+ * IMPORTS:
+ *    rest - The span still to be tokenised, moved on past the token.
+ *    token - Set to the token, or to a NULL start and 0 length if none.
+ * EXPORTS:
+ *    isFound - Boolean evaluating to '0' (FALSE) if only spaces were left, or
+ *              '-1' (TRUE) if a token was found.
+ */
+
+int nextToken( Span* rest, Span* token )
+{
+   int isFound = 0;
+   const char* text = rest->start;
+   const char* end = rest->start + rest->length;
+
+   while ( ( text < end ) && ( *text == ' ' ) )
+   {
+      text++;
+   }
+
+   token->start = NULL;
+   token->length = 0;
+   if ( text < end )
+   {
+      isFound = -1;
+      token->start = text;
+      while ( ( text < end ) && ( *text != ' ' ) )
+      {
+         text++;
+      }
+      token->length = ( size_t )( text - token->start );
+   }
+
+   rest->start = text;
+   rest->length = ( size_t )( end - text );
+
+   return isFound;
+}
+
+
+
+
+/* NAME: spanMatches()
+ * PURPOSE: Checks if a span holds a given upper case word, ignoring the case
+ *          of the span. Allows command names to be matched in any casing.
+ * HOW IT WORKS: Compares the lengths, then each character of the span with
+ *               any lower case letter taken as its upper case correspondent.
+ * RELATIONS:
  *    validateCommandName() - To identify if a command text within a line read
  *                            in from a file matches a correct command name.
- *    draw() - Identify which TurtleGraphics command operation to commence
- *             during drawing stage.
  * IMPORTS:
- *    string   A string to be converted to all upper case.
+ *    span - The text to check.
+ *    word - The upper case word to compare against.
  * EXPORTS:
- *    none
- *
- * SELF-CITE: The following function stringUpperCase() has been submitted for
- *            Worksheet 4: Arrays and String as practical work on date 19/09/18,
- *            time: 15:52
+ *    isMatch - Boolean evaluating to '-1' (TRUE) if the span holds the word,
+ *              or '0' (FALSE) otherwise.
  */
 
-void stringUpperCase( char* string )
+int spanMatches( Span* span, const char* word )
 {
-   int ii;
-   /* Length of string */
-   int length = strlen( string );
+   int isMatch = 0;
+   size_t ii = 0;
+   char letter;
 
-   /* Loop through each character */
-   for ( ii = 0; ii < length; ii++ )
+   if ( strlen( word ) == span->length )
    {
-      if ( 97 <= string[ii] && string[ii] <= 122 )
+      isMatch = -1;
+      while ( ( isMatch != 0 ) && ( ii < span->length ) )
       {
-         string[ii] -= 32;
+         letter = span->start[ii];
+         if ( 'a' <= letter && letter <= 'z' )
+         {
+            letter -= 32;
+         }
+         if ( letter != word[ii] )
+         {
+            isMatch = 0;
+         }
+         ii++;
       }
    }
+
+   return isMatch;
 }
 
 
 
 
-/* NAME: stringIsCtrl()
- * PURPOSE: Used to check if each character within a string is a control 
- *          character,returning a value to check.
+/* NAME: spanIsCtrl()
+ * PURPOSE: Used to check if each character within a span is a control
+ *          character, returning a value to check.
  *          Mainly used to check for lines in a file that contain blank lines of
  *          non-printable characters and assures command parameters are validated
  *          correctly.
- * HOW IT WORKS: Loops through each character within a string and checks if all
- *               characters are control characters by using iscntrl() and includes
- *               blank whitespace as a check to ignore any whitespace characters.
- *               If all ctrl characters found matches the length of the string
- *               then the string entirely has control characters.
+ * HOW IT WORKS: Loops through each character within the span and checks if all
+ *               characters are control characters by using iscntrl(), with
+ *               blank whitespace also taken as a control character, stopping
+ *               at the first that isn't.
  * RELATIONS:
- *    main() - Used in main to first check if a line contains all control 
- *             characters to indicate blank lines.
+ *    processFile() - Used to first check if a line contains all control
+ *                    characters to indicate blank lines.
  *    validator.c parameter functions - Used to check if a other parameters 
  *                                      after tokenising are just blank lines, 
  *                                      only treating printable characters as 
  *                                      valid parameters checks.
  * IMPORTS:
- *    string   A string to be converted to all upper case.
+ *    span - The text to check.
  * EXPORTS:
- *    none
+ *    isCtrl - Boolean evaluating to '-1' (TRUE) if every character is a
+ *             control character or space, or '0' (FALSE) otherwise.
  */
-         
-int stringIsCtrl( char* string )
+
+int spanIsCtrl( Span* span )
 {
-   int ii;
-   int isCtrl = 0;
-   int ctrlCount = 0;
-   /* Length of string */
-   int length = strlen( string );
+   int isCtrl = -1;
+   size_t ii = 0;
+   unsigned char character;
 
-   /* Loop through each character */
-   for ( ii = 0; ii < length; ii++ )
+   while ( ( isCtrl != 0 ) && ( ii < span->length ) )
    {
-      if ( iscntrl( string[ii] ) || ( string[ii] == ' ') )
+      character = ( unsigned char )span->start[ii];
+      if ( ( iscntrl( character ) == 0 ) && ( character != ' ' ) )
       {
-         ctrlCount++;
+         isCtrl = 0;
       }
+      ii++;
    }
 
-   /* If all control characters exist in the string then evaluate to true */
-   if ( ctrlCount == length )
+   return isCtrl;
+}
+
+
+
+
+/* NAME: parseReal()
+ * PURPOSE: Parses the real at the start of a span, exactly as strtod() would
+ *          in the C locale, in a single pass over its characters.
+ * HOW IT WORKS: - Reads an optional sign, the digits either side of an
+ *                 optional decimal point and an optional exponent, building
+ *                 the significant digits as a whole number in a double and
+ *                 counting the power of ten to scale it by.
+ *               - Up to 15 significant digits are held exactly, as are the
+ *                 powers of ten up to 10^22, so a single multiply or divide
+ *                 gives the correctly rounded result, the same as strtod()'s.
+ *               - Anything else, such as more digits, a larger exponent,
+ *                 leading whitespace, hexadecimal, infinity or NaN, is
+ *                 handed to strtod() on a copy with parseRealCopy(), so the
+ *                 result is always the same as strtod()'s. A span of
+ *                 VALUE_LENGTH or more is never a valid value, so is left
+ *                 unconverted.
+ * RELATIONS:
+ *    validateReal() - Parses the value of real commands once, both checking
+ *                     its syntax and giving the value stored.
+ *    parseRealCopy() - Parses anything off the fast path.
+ * IMPORTS:
+ *    span - The text of the value.
+ *    remainder - Set to the part of the span left unconverted, the whole
+ *                span if nothing was.
+ * EXPORTS:
+ *    value - The real, 0 if nothing was converted.
+ */
+
+double parseReal( Span* span, Span* remainder )
+{
+   double value = 0.0;
+   const char* text = span->start;
+   const char* end = span->start + span->length;
+   const char* exponentText;
+   int isNegative = 0;
+   int isFast = -1;
+   int digits = 0;
+   int significant = 0;
+   int scale = 0;
+   int exponent = 0;
+   int isExponentNegative = 0;
+
+   if ( ( text < end ) && ( ( *text == '+' ) || ( *text == '-' ) ) )
    {
-      isCtrl = -1;
+      isNegative = ( *text == '-' );
+      text++;
    }
-   
-   return isCtrl;
+   if ( ( text + 1 < end ) && ( text[0] == '0' ) && ( ( text[1] == 'x' ) || ( text[1] == 'X' ) ) )
+   {
+      isFast = 0;
+   }
+
+   /* Whole part, skipping leading zeros */
+   while ( ( text < end ) && ( '0' <= *text ) && ( *text <= '9' ) )
+   {
+      if ( ( significant > 0 ) || ( *text != '0' ) )
+      {
+         value = value * 10.0 + ( *text - '0' );
+         significant++;
+      }
+      digits++;
+      text++;
+   }
+
+   /* Fraction, each digit scaling the number down by ten */
+   if ( ( text < end ) && ( *text == '.' ) )
+   {
+      text++;
+      while ( ( text < end ) && ( '0' <= *text ) && ( *text <= '9' ) )
+      {
+         if ( ( significant > 0 ) || ( *text != '0' ) )
+         {
+            value = value * 10.0 + ( *text - '0' );
+            significant++;
+         }
+         scale--;
+         digits++;
+         text++;
+      }
+   }
+
+   /* Exponent, only taken if it has a digit */
+   if ( ( digits > 0 ) && ( text < end ) && ( ( *text == 'e' ) || ( *text == 'E' ) ) )
+   {
+      exponentText = text + 1;
+      if ( ( exponentText < end ) && ( ( *exponentText == '+' ) || ( *exponentText == '-' ) ) )
+      {
+         isExponentNegative = ( *exponentText == '-' );
+         exponentText++;
+      }
+      if ( ( exponentText < end ) && ( '0' <= *exponentText ) && ( *exponentText <= '9' ) )
+      {
+         text = exponentText;
+         while ( ( text < end ) && ( '0' <= *text ) && ( *text <= '9' ) )
+         {
+            if ( exponent < 10000 )
+            {
+               exponent = exponent * 10 + ( *text - '0' );
+            }
+            text++;
+         }
+         if ( isExponentNegative != 0 )
+         {
+            exponent = -exponent;
+         }
+      }
+   }
+   scale += exponent;
+
+   if ( ( digits == 0 ) || ( significant > 15 ) || ( span->length >= VALUE_LENGTH ) )
+   {
+      isFast = 0;
+   }
+   else if ( significant == 0 )
+   {
+      scale = 0;
+   }
+   else if ( ( scale < -MAX_EXACT_POWER ) || ( scale > MAX_EXACT_POWER ) )
+   {
+      isFast = 0;
+   }
+
+   if ( isFast == 0 )
+   {
+      value = parseRealCopy( span, remainder );
+   }
+   else
+   {
+      if ( scale < 0 )
+      {
+         value /= exactPowers[-scale];
+      }
+      else
+      {
+         value *= exactPowers[scale];
+      }
+      if ( isNegative != 0 )
+      {
+         value = -value;
+      }
+      remainder->start = text;
+      remainder->length = ( size_t )( end - text );
+   }
+
+   return value;
+}
+
+
+
+
+/* NAME: parseInteger()
+ * PURPOSE: Parses the integer at the start of a span, exactly as strtol()
+ *          would in base 10, in a single pass over its characters.
+ * HOW IT WORKS: Reads an optional sign and the digits. A number of up to 9
+ *               digits can't overflow, so anything longer, or with leading
+ *               whitespace, is handed to strtol() on a copy with
+ *               parseIntegerCopy() so the result is always the same as
+ *               strtol()'s. A span of VALUE_LENGTH or more is left
+ *               unconverted, the same as parseReal().
+ * RELATIONS:
+ *    validateInt() - Parses the value of integer commands once, both
+ *                    checking its syntax and giving the value stored.
+ *    parseIntegerCopy() - Parses anything off the fast path.
+ * IMPORTS:
+ *    span - The text of the value.
+ *    remainder - Set to the part of the span left unconverted, the whole
+ *                span if nothing was.
+ * EXPORTS:
+ *    value - The integer, 0 if nothing was converted.
+ */
+
+long parseInteger( Span* span, Span* remainder )
+{
+   long value = 0;
+   const char* text = span->start;
+   const char* end = span->start + span->length;
+   int isNegative = 0;
+   int digits = 0;
+
+   if ( ( text < end ) && ( ( *text == '+' ) || ( *text == '-' ) ) )
+   {
+      isNegative = ( *text == '-' );
+      text++;
+   }
+   while ( ( text < end ) && ( '0' <= *text ) && ( *text <= '9' ) )
+   {
+      if ( digits < 9 )
+      {
+         value = value * 10 + ( *text - '0' );
+      }
+      digits++;
+      text++;
+   }
+
+   if ( ( digits > 9 ) || ( span->length >= VALUE_LENGTH ) ||
+        ( ( digits == 0 ) && ( span->length > 0 ) && ( isspace( ( unsigned char )span->start[0] ) != 0 ) ) )
+   {
+      value = parseIntegerCopy( span, remainder );
+   }
+   else if ( digits == 0 )
+   {
+      value = 0;
+      *remainder = *span;
+   }
+   else
+   {
+      if ( isNegative != 0 )
+      {
+         value = -value;
+      }
+      remainder->start = text;
+      remainder->length = ( size_t )( end - text );
+   }
+
+   return value;
+}
+
+
+
+
+/* NAME: parseRealCopy()
+ * PURPOSE: Parses a real off the fast path of parseReal() with strtod().
+ * HOW IT WORKS: Copies the span with copySpan(), as strtod() needs a
+ *               terminated string, and converts the copy. A span too long to
+ *               copy is left unconverted.
+ * RELATIONS:
+ *    parseReal() - Hands over anything it can't parse exactly itself.
+ * IMPORTS:
+ *    span - The text of the value.
+ *    remainder - Set to the part of the span left unconverted.
+ * EXPORTS:
+ *    value - The real, 0 if nothing was converted.
+ */
+
+static double parseRealCopy( Span* span, Span* remainder )
+{
+   double value = 0.0;
+   char text[VALUE_LENGTH];
+   char* end = text;
+
+   if ( copySpan( span, text ) != 0 )
+   {
+      value = strtod( text, &end );
+   }
+   remainder->start = span->start + ( end - text );
+   remainder->length = span->length - ( size_t )( end - text );
+
+   return value;
+}
+
+
+
+
+/* NAME: parseIntegerCopy()
+ * PURPOSE: Parses an integer off the fast path of parseInteger() with
+ *          strtol().
+ * HOW IT WORKS: Copies the span with copySpan(), as strtol() needs a
+ *               terminated string, and converts the copy in base 10. A span
+ *               too long to copy is left unconverted.
+ * RELATIONS:
+ *    parseInteger() - Hands over anything that could overflow.
+ * IMPORTS:
+ *    span - The text of the value.
+ *    remainder - Set to the part of the span left unconverted.
+ * EXPORTS:
+ *    value - The integer, 0 if nothing was converted.
+ */
+
+static long parseIntegerCopy( Span* span, Span* remainder )
+{
+   long value = 0;
+   char text[VALUE_LENGTH];
+   char* end = text;
+
+   if ( copySpan( span, text ) != 0 )
+   {
+      value = strtol( text, &end, 10 );
+   }
+   remainder->start = span->start + ( end - text );
+   remainder->length = span->length - ( size_t )( end - text );
+
+   return value;
+}
+
+
+
+
+/* NAME: copySpan()
+ * PURPOSE: Copies a short span into a string, for the C library functions
+ *          that need one, returning whether it fit.
+ * HOW IT WORKS: Copies the characters and terminates them, if the span is
+ *               shorter than VALUE_LENGTH. Only ever used on single values,
+ *               so the copy is a few bytes on the stack.
+ * RELATIONS:
+ *    parseRealCopy()/parseIntegerCopy() - Convert values through copies.
+ * IMPORTS:
+ *    span - The text to copy.
+ *    text - A buffer of VALUE_LENGTH characters.
+ * EXPORTS:
+ *    isCopied - Boolean evaluating to '0' (FALSE) if the span is too long,
+ *               leaving text empty, or '-1' (TRUE) otherwise.
+ */
+
+static int copySpan( Span* span, char* text )
+{
+   int isCopied = 0;
+
+   text[0] = '\0';
+   if ( span->length < VALUE_LENGTH )
+   {
+      isCopied = -1;
+      memcpy( text, span->start, span->length );
+      text[span->length] = '\0';
+   }
+
+   return isCopied;
 }
@@ -7,15 +7,40 @@
 #ifndef STRINGOPERATIONS_H
    #define STRINGOPERATIONS_H
 
-   /* Converts a given string to all upper case. Allows for appropriate string
-    * comparisons which check for validity 
-    * */
-   void stringUpperCase( char* string );
+   #include <stddef.h>
+
+   /* Longest value, with its new line, that is copied out for conversion
+    * when it can't be parsed in place */
+   #define VALUE_LENGTH 101
+
+   /* Stores a run of characters within a larger string, such as a line of a
+    * mapped file, read in place so it is not NUL terminated */
+   typedef struct
+   {
+      const char* start;
+      size_t length;
+   } Span;
+
+   /* Finds the next space separated token of a span, moving the span on
+    * past it */
+   int nextToken( Span* rest, Span* token );
+
+   /* Checks if a span holds a given upper case word, ignoring the case of
+    * the span. Allows for command names to be matched in any casing */
+   int spanMatches( Span* span, const char* word );
    
-   /* Checks if a given string has only control characters.
+   /* Checks if a given span has only control characters.
     * Mainly used to check for lines in a file that contain blank lines of
     * non-printable characters and assures command parameters are validated
     * correctly */
-   int stringIsCtrl( char* string );
+   int spanIsCtrl( Span* span );
+
+   /* Parses the real at the start of a span as strtod() would, in a single
+    * pass, giving the part of the span left unconverted */
+   double parseReal( Span* span, Span* remainder );
+
+   /* Parses the integer at the start of a span as strtol() would in base
+    * 10, in a single pass, giving the part of the span left unconverted */
+   long parseInteger( Span* span, Span* remainder );
 
 #endif
@@ -7,6 +7,45 @@
 
 #ifndef STRUCTSET_H
    #define STRUCTSET_H
+
+   #include <stdio.h>
+
+   #include "framebuffer.h"
+   #include "image.h"
+   #include "svg.h"
+   #include "fixed.h"
+   #include "graphicslog.h"
+
+   /* Stores which cells of the lines drawn straight to the terminal are
+    * seen, found by findOverdraw() before drawing. Cells drawn over by a
+    * later line are left out */
+   typedef struct
+   {
+      /* Rounded ends of each draw's line, 4 per draw, in order */
+      int* ends;
+      /* Whether each draw has any cell seen */
+      char* isSeen;
+      /* A bit per cell of each line within the viewport, in order, set if
+       * the cell is seen */
+      unsigned char* seen;
+      /* Number of draws */
+      int lines;
+      /* Draw drawn next, and the bit of its first cell */
+      int next;
+      long nextCell;
+   } Overdraw;
+   
+   /* Stores where a DRAW or MOVE takes the turtle, traced ahead of drawing
+    * by traceSteps() */
+   typedef struct
+   {
+      /* Position after the command */
+      double x;
+      double y;
+      /* Unrounded end of a draw's line */
+      double endX;
+      double endY;
+   } Step;
    
    /* Stores crucial data to maintain current state of graphics during drawing */
    typedef struct
@@ -16,21 +55,79 @@
       double y;
       /* Current Angle */
       double angle;
+      /* Unit direction of the current angle, its cosine and sine, found
+       * only when the angle changes */
+      double dirX;
+      double dirY;
+      /* Whether the turtle is moved in fixed-point, and where it is. The
+       * coordinates and angle above are then converted from it */
+      int isFixed;
+      FixedTurtle fixed;
       /* Current Foreground Colour */
       int fgColour;
       /* Current Background Colour */
       int bgColour;
       /* Current Pattern */
       char pattern;
+      /* Framebuffer drawn into, NULL when drawing straight to the terminal */
+      FrameBuffer* frame;
+      /* Image exported in place of the terminal, NULL when drawing on the
+       * terminal */
+      Image* image;
+      /* Vector image streamed to in place of the terminal, NULL unless
+       * exporting one */
+      Svg* svg;
+      /* Rectangle of the drawing lines are clipped to, the viewport (within
+       * the canvas when drawing into a framebuffer) */
+      Viewport clip;
+      /* Cells seen of each line drawn straight to the terminal, NULL to
+       * draw every cell */
+      Overdraw* overdraw;
+      /* graphics.log, appended each draw and move, NULL if it can't be */
+      GraphicsLog* log;
    } GraphicsState;
 
-   /* Stores data of commands from command file input */
+   /* Identifies the operation of a validated command. REPEAT, PROC, CALL
+    * and the ] closing a block control which commands run, see bytecode.c */
+   typedef enum
+   {
+      OP_DRAW,
+      OP_MOVE,
+      OP_ROTATE,
+      OP_FG,
+      OP_BG,
+      OP_PATTERN,
+      OP_REPEAT,
+      OP_PROC,
+      OP_CALL,
+      OP_END
+   } Opcode;
+
+   /* Longest procedure name, kept within the command itself */
+   #define PROC_NAME_LENGTH 8
+
+   /* Stores a validated command from command file input as an opcode with
+    * its value already parsed (16 bytes on a 64 bit machine) */
    typedef struct
    {
-      /* Command Name */
-      char* name;
       /* Associated Value */
-      char* value;
+      union
+      {
+         /* DRAW, MOVE and ROTATE */
+         double real;
+         /* FG, BG and REPEAT */
+         int integer;
+         /* PATTERN */
+         char pattern;
+         /* PROC and CALL, upper case and padded with '\0' */
+         char name[PROC_NAME_LENGTH];
+      } value;
+      /* Command Operation */
+      Opcode opcode;
+      /* Number of the command's line until compileBlocks() links it. Then
+       * the index of the command after the ] of a REPEAT or PROC, or of the
+       * first command of the procedure a CALL runs */
+      int jump;
    } Command;
 
 #endif
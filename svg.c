@@ -0,0 +1,363 @@
+/*
+ * FILE: svg.c
+ * AUTHOR: Kyle Notani | 19149918
+ * UNIT: UCP COMP1000
+ * PURPOSE: Stream drawing commands straight to an SVG file as vector
+ *          graphics, with no rasterizing at all.
+ * FILE FORMATS: SVG 1.1, one path per run of lines of a colour, each line
+ *               joining the last one's end or starting a new subpath.
+ * OTHER: Lines are stroked in their foreground colour along the centres of
+ *        their cells. Patterns and background colours only apply to
+ *        terminal cells, so are left out.
+ *        Each line costs a constant amount of work and memory, the open
+ *        path's last points being the only state kept.
+ *        '-1' evaluates to true, '0' evaluates to false.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "svg.h"
+#include "image.h"
+#include "framebuffer.h"
+
+/* Largest difference in direction, relative to the lengths of two lines,
+ * for them to be taken as collinear */
+#define COLLINEAR_EPSILON 1e-9
+
+/* Width of the lines in cells, as in the middle of a line in image.c */
+#define STROKE_WIDTH "0.25"
+
+static void openPath( Svg* svg );
+static void closePath( Svg* svg );
+static void moveTo( Svg* svg, double x, double y );
+static void writeEnd( Svg* svg );
+static int isCollinear( Svg* svg, double x, double y );
+static void formatNumber( double value, char* text );
+
+
+/* NAME: constructSvg()
+ * PURPOSE: Creates an SVG file of width by height pixels showing the
+ *          viewport on a background colour, returning NULL if it can't be
+ *          created.
+ * HOW IT WORKS: - Writes the header with the viewport as the viewBox, moved
+ *                 back by half a cell so each cell's centre is on its
+ *                 coordinates. The viewport keeps its shape, scaled to fit
+ *                 and centred.
+ *               - Fills the viewport with the background colour and opens a
+ *                 group giving every line its width and ends.
+ * RELATIONS:
+ *    draw() - Creates the file when exporting a vector image.
+ *    lookupColour() - Finds the RGB of the background.
+ * IMPORTS:
+ *    filename - Name of the file to create or replace.
+ *    width/height - Size of the image in pixels.
+ *    view - The rectangle of cells the image shows.
+ *    bgColour - Terminal colour code of the background.
+ * EXPORTS:
+ *    svg - a pointer to the allocated Svg struct on the heap, or NULL if the
+ *          file could not be created.
+ */
+
+Svg* constructSvg( char* filename, int width, int height, Viewport* view, int bgColour )
+{
+   Svg* svg = ( Svg* )malloc( sizeof( Svg ) );
+   unsigned char rgb[3];
+   double left = view->left - 0.5;
+   double top = view->top - 0.5;
+
+   if ( svg != NULL )
+   {
+      svg->file = fopen( filename, "w" );
+      if ( svg->file == NULL )
+      {
+         free( svg );
+         svg = NULL;
+      }
+   }
+
+   if ( svg != NULL )
+   {
+      svg->isOpen = 0;
+      svg->fgColour = DEFAULT_COLOUR;
+
+      lookupColour( bgColour, 0, rgb );
+      fprintf( svg->file, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n" );
+      fprintf( svg->file, "<svg xmlns=\"http://www.w3.org/2000/svg\" version=\"1.1\" width=\"%d\" height=\"%d\" viewBox=\"%.1f %.1f %d %d\">\n",
+               width, height, left, top, view->width, view->height );
+      fprintf( svg->file, "<rect x=\"%.1f\" y=\"%.1f\" width=\"%d\" height=\"%d\" fill=\"#%02x%02x%02x\"/>\n",
+               left, top, view->width, view->height, rgb[0], rgb[1], rgb[2] );
+      fprintf( svg->file, "<g fill=\"none\" stroke-width=\"" STROKE_WIDTH "\" stroke-linecap=\"square\" stroke-linejoin=\"round\">\n" );
+   }
+
+   return svg;
+}
+
+
+/* NAME: svgLine()
+ * PURPOSE: Adds the line between two turtle coordinates to the vector image.
+ * HOW IT WORKS: - A line in a new colour closes the open path and opens
+ *                 another.
+ *               - A line starting where the open path ends joins it. If it
+ *                 also carries on in the same direction, the path's end is
+ *                 simply moved to the end of the line, otherwise the end is
+ *                 written and the line's end becomes the new one.
+ *               - Any other line writes the path's end and starts a new
+ *                 subpath.
+ * RELATIONS:
+ *    drawLine() - Adds each line command to the vector image when exporting.
+ * IMPORTS:
+ *    svg - The vector image to add to.
+ *    x1/y1 - Starting coordinates, in cells.
+ *    x2/y2 - Finishing coordinates, in cells.
+ * EXPORTS:
+ *    none
+ */
+
+void svgLine( Svg* svg, double x1, double y1, double x2, double y2 )
+{
+   if ( ( svg->isOpen == 0 ) || ( svg->colour != svg->fgColour ) )
+   {
+      closePath( svg );
+      openPath( svg );
+      moveTo( svg, x1, y1 );
+   }
+   else if ( ( x1 != svg->endX ) || ( y1 != svg->endY ) )
+   {
+      writeEnd( svg );
+      moveTo( svg, x1, y1 );
+   }
+   else if ( isCollinear( svg, x2, y2 ) == 0 )
+   {
+      writeEnd( svg );
+      svg->lastX = svg->endX;
+      svg->lastY = svg->endY;
+   }
+
+   svg->endX = x2;
+   svg->endY = y2;
+}
+
+
+/* NAME: finishSvg()
+ * PURPOSE: Finishes and closes the SVG file, deallocating the Svg struct,
+ *          returning whether the whole file was written.
+ * HOW IT WORKS: Closes the open path, the group and the document, then
+ *               checks the file for any error writing it.
+ * RELATIONS:
+ *    draw() - Finishes the file once every command has run.
+ * IMPORTS:
+ *    svg - The vector image to finish.
+ * EXPORTS:
+ *    isWritten - Boolean evaluating to '0' (FALSE) if the file could not be
+ *                written, or '-1' (TRUE) otherwise.
+ */
+
+int finishSvg( Svg* svg )
+{
+   int isWritten = 0;
+
+   closePath( svg );
+   fprintf( svg->file, "</g>\n</svg>\n" );
+
+   if ( ferror( svg->file ) == 0 )
+   {
+      isWritten = -1;
+   }
+   if ( fclose( svg->file ) != 0 )
+   {
+      isWritten = 0;
+   }
+   free( svg );
+
+   return isWritten;
+}
+
+
+/* NAME: openPath()
+ * PURPOSE: Starts a path element in the current colour.
+ * HOW IT WORKS: Writes the start of the element up to its path data.
+ * RELATIONS:
+ *    svgLine() - Starts a path for a line in a new colour.
+ * IMPORTS:
+ *    svg - The vector image to add to.
+ * EXPORTS:
+ *    none
+ */
+
+static void openPath( Svg* svg )
+{
+   unsigned char rgb[3];
+
+   lookupColour( svg->fgColour, -1, rgb );
+   fprintf( svg->file, "<path stroke=\"#%02x%02x%02x\" d=\"", rgb[0], rgb[1], rgb[2] );
+
+   svg->isOpen = -1;
+   svg->colour = svg->fgColour;
+}
+
+
+/* NAME: closePath()
+ * PURPOSE: Ends the open path element, if any.
+ * HOW IT WORKS: Writes the path's end point and the end of the element.
+ * RELATIONS:
+ *    svgLine() - Ends a path when the colour changes.
+ *    finishSvg() - Ends the last path.
+ * IMPORTS:
+ *    svg - The vector image to add to.
+ * EXPORTS:
+ *    none
+ */
+
+static void closePath( Svg* svg )
+{
+   if ( svg->isOpen != 0 )
+   {
+      writeEnd( svg );
+      fprintf( svg->file, "\"/>\n" );
+      svg->isOpen = 0;
+   }
+}
+
+
+/* NAME: moveTo()
+ * PURPOSE: Starts a new subpath of the open path at a point.
+ * HOW IT WORKS: Writes a moveto command to the point.
+ * RELATIONS:
+ *    svgLine() - Starts a subpath for a line not joining the last one.
+ * IMPORTS:
+ *    svg - The vector image with the open path.
+ *    x/y - First point of the subpath.
+ * EXPORTS:
+ *    none
+ */
+
+static void moveTo( Svg* svg, double x, double y )
+{
+   /* Room for any double written to 3 decimal places */
+   char textX[400];
+   char textY[400];
+
+   formatNumber( x, textX );
+   formatNumber( y, textY );
+   fprintf( svg->file, "M%s %s", textX, textY );
+
+   svg->lastX = x;
+   svg->lastY = y;
+}
+
+
+/* NAME: writeEnd()
+ * PURPOSE: Writes the line from the last point of the open path to its end.
+ * HOW IT WORKS: Writes a horizontal or vertical lineto when the line is
+ *               along an axis once written to 3 decimal places, as they only
+ *               need one coordinate, or a lineto otherwise.
+ * RELATIONS:
+ *    svgLine() - Writes the end of a path before it turns or a new subpath.
+ *    closePath() - Writes the end of the last subpath.
+ * IMPORTS:
+ *    svg - The vector image with the open path.
+ * EXPORTS:
+ *    none
+ */
+
+static void writeEnd( Svg* svg )
+{
+   /* Room for any double written to 3 decimal places */
+   char textX[400];
+   char textY[400];
+   char lastX[400];
+   char lastY[400];
+
+   formatNumber( svg->endX, textX );
+   formatNumber( svg->endY, textY );
+   formatNumber( svg->lastX, lastX );
+   formatNumber( svg->lastY, lastY );
+
+   if ( strcmp( textY, lastY ) == 0 )
+   {
+      fprintf( svg->file, "H%s", textX );
+   }
+   else if ( strcmp( textX, lastX ) == 0 )
+   {
+      fprintf( svg->file, "V%s", textY );
+   }
+   else
+   {
+      fprintf( svg->file, "L%s %s", textX, textY );
+   }
+}
+
+
+/* NAME: isCollinear()
+ * PURPOSE: Checks if carrying the open path on to a point keeps it in the
+ *          same direction as its last line.
+ * HOW IT WORKS: The two directions are collinear when their cross product is
+ *               next to nothing compared to their lengths, and point the same
+ *               way when their dot product is positive.
+ * RELATIONS:
+ *    svgLine() - Merges a line carrying straight on from the last one.
+ * IMPORTS:
+ *    svg - The vector image with the open path.
+ *    x/y - The point the path would be carried on to.
+ * EXPORTS:
+ *    isStraight - Boolean evaluating to '-1' (TRUE) if the last line can
+ *                  simply be extended to the point, or '0' (FALSE).
+ */
+
+static int isCollinear( Svg* svg, double x, double y )
+{
+   int isStraight = 0;
+   double lastDX = svg->endX - svg->lastX;
+   double lastDY = svg->endY - svg->lastY;
+   double nextDX = x - svg->endX;
+   double nextDY = y - svg->endY;
+   double cross = lastDX * nextDY - lastDY * nextDX;
+   double dot = lastDX * nextDX + lastDY * nextDY;
+   double lengths = ( fabs( lastDX ) + fabs( lastDY ) ) * ( fabs( nextDX ) + fabs( nextDY ) );
+
+   if ( ( dot > 0.0 ) && ( fabs( cross ) <= COLLINEAR_EPSILON * lengths ) )
+   {
+      isStraight = -1;
+   }
+
+   return isStraight;
+}
+
+
+/* NAME: formatNumber()
+ * PURPOSE: Writes a coordinate in as few characters as it needs.
+ * HOW IT WORKS: Writes it to 3 decimal places, the same as graphics.log,
+ *               then drops any trailing zeros and decimal point, and the sign
+ *               of a zero.
+ * RELATIONS:
+ *    moveTo()/writeEnd() - Write each coordinate.
+ * IMPORTS:
+ *    value - The coordinate.
+ *    text - Buffer to write into, large enough for any double.
+ * EXPORTS:
+ *    none
+ */
+
+static void formatNumber( double value, char* text )
+{
+   char* end;
+
+   sprintf( text, "%.3f", value );
+   end = text + strlen( text ) - 1;
+   while ( *end == '0' )
+   {
+      *end = '\0';
+      end--;
+   }
+   if ( *end == '.' )
+   {
+      *end = '\0';
+   }
+   if ( strcmp( text, "-0" ) == 0 )
+   {
+      strcpy( text, "0" );
+   }
+}
@@ -0,0 +1,45 @@
+/* FILE: svg.h
+ * AUTHOR: Kyle Notani | 19149918
+ * UNIT: UCP COMP1000
+ * PURPOSE: Header file associated with svg.c
+ */
+
+#ifndef SVG_H
+   #define SVG_H
+
+   #include <stdio.h>
+
+   #include "viewport.h"
+
+   /* Stores a vector image being streamed to a file, with the path
+    * currently being extended */
+   typedef struct
+   {
+      FILE* file;
+      /* Whether a path element is open, '-1' (TRUE) or '0' (FALSE) */
+      int isOpen;
+      /* Colour of the open path */
+      int colour;
+      /* Last point of the open path written to the file */
+      double lastX;
+      double lastY;
+      /* Point ending the open path, not yet written as it may still be
+       * moved further along a collinear line */
+      double endX;
+      double endY;
+      /* Colour given to every line drawn from now on */
+      int fgColour;
+   } Svg;
+
+   /* Creates an SVG file of width by height pixels showing the viewport on
+    * a background colour, returning NULL if it can't be created. */
+   Svg* constructSvg( char* filename, int width, int height, Viewport* view, int bgColour );
+
+   /* Adds the line between two turtle coordinates to the vector image. */
+   void svgLine( Svg* svg, double x1, double y1, double x2, double y2 );
+
+   /* Finishes and closes the SVG file, deallocating the Svg struct, returning
+    * whether the whole file was written. */
+   int finishSvg( Svg* svg );
+
+#endif
@@ -0,0 +1,314 @@
+/*
+ * FILE: testparse.c
+ * AUTHOR: Kyle Notani | 19149918
+ * UNIT: UCP COMP1000
+ * PURPOSE: Check parseReal() and parseInteger() against strtod() and
+ *          strtol() over every short string of characters a number is made
+ *          of, tokens at the edges of the fast paths, and random strings and
+ *          decimals.
+ * COMMAND ARGUMENTS: Optionally the number of random cases of each kind,
+ *                    1000000 if none.
+ * OTHER: Run by 'make test'. Values are compared to the bit and remainders
+ *        exactly. Each span is followed in memory by a digit that isn't part
+ *        of it, so reading past its end shows up as a mismatch.
+ *        '-1' evaluates to true, '0' evaluates to false.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "stringoperations.h"
+
+/* Characters the exhaustive strings are made of, and the longest of them */
+#define ALPHABET "0159.+-eExinfa "
+#define EXHAUSTIVE_LENGTH 5
+
+/* Random cases of each kind unless given on the command line */
+#define RANDOM_CASES 1000000
+
+/* Longest random string, and most digits of a random decimal */
+#define RANDOM_LENGTH 24
+#define RANDOM_DIGITS 17
+
+/* Tokens at the edges of the fast paths and the copies handed to strtod()
+ * and strtol() */
+static const char* EDGE_TOKENS[] =
+{
+   "", "0", "-0", "+0", "-0.0", "0.", ".0", ".", "-", "+", "+-1", "5.", ".5",
+   "1e22", "1e23", "1e-22", "1e-23", "9e22", "0.000000000000000000000001",
+   "123456789012345", "1234567890123456", "0.123456789012345",
+   "12345678901234.5", "999999999999999e7", "4.9e-324", "1.7976931348623157e308",
+   "1e309", "-1e309", "1e-400", "1e", "1e+", "1e-", "1e+5x", "1E5", "1.5e2.5",
+   "0x1p3", "0X1A", "inf", "-INF", "infinity", "nan", "-nan(1)", " 12", "\t3",
+   "\n4", " -5e2", "000000000000000000012", "0.0000000000000000000001e22",
+   "999999999", "1000000000", "2147483647", "2147483648", "-2147483649",
+   "9223372036854775807", "9223372036854775808", "-9223372036854775809",
+   "12abc", "1 2", "--1", "1e99999", "1e-99999", "00000000000000000000000000000"
+};
+
+static unsigned long seed = 12345;
+
+static int checkToken( const char* token, size_t length );
+static unsigned long nextRandom( void );
+static void randomString( char* text, size_t* length );
+static void randomDecimal( char* text, size_t* length );
+
+
+/*
+ * NAME: main()
+ * PURPOSE: Entry point to the parse test. Reports any mismatch against
+ *          strtod() and strtol() and how many cases were checked.
+ * HOW IT WORKS: - Checks every edge token, and spans of VALUE_LENGTH - 1 to
+ *                 VALUE_LENGTH + 1 digits, just short of and past the
+ *                 longest value copied.
+ *               - Checks every string of up to EXHAUSTIVE_LENGTH characters
+ *                 of ALPHABET, counting through them as digits of a number.
+ *               - Checks random strings of number characters and random
+ *                 decimals, with a fixed seed so every run is the same.
+ * RELATIONS:
+ *    checkToken() - Checks each case.
+ *
+ * IMPORTS:
+ *    argc  The number of command-line arguments.
+ *    argv  An array of pointers to chars where each represents the argument
+ *          string (argument vector).
+ *
+ * EXPORTS:
+ *          Exit status condition provided to the OS, 1 if any case failed.
+ */
+
+int main( int argc, char* argv[] )
+{
+   long randomCases = RANDOM_CASES;
+   long cases = 0;
+   long failures = 0;
+   size_t alphabet = strlen( ALPHABET );
+   size_t counter[EXHAUSTIVE_LENGTH];
+   char text[VALUE_LENGTH + 2];
+   size_t length;
+   size_t ii;
+   long jj;
+
+   if ( argc == 2 )
+   {
+      randomCases = atol( argv[1] );
+   }
+
+   /* Edge tokens */
+   for ( ii = 0; ii < sizeof( EDGE_TOKENS ) / sizeof( EDGE_TOKENS[0] ); ii++ )
+   {
+      failures += ( checkToken( EDGE_TOKENS[ii], strlen( EDGE_TOKENS[ii] ) ) == 0 );
+      cases++;
+   }
+   for ( length = VALUE_LENGTH - 1; length <= VALUE_LENGTH + 1; length++ )
+   {
+      memset( text, '7', length );
+      failures += ( checkToken( text, length ) == 0 );
+      text[length / 2] = '.';
+      failures += ( checkToken( text, length ) == 0 );
+      cases += 2;
+   }
+
+   /* Every string of up to EXHAUSTIVE_LENGTH characters */
+   for ( length = 1; length <= EXHAUSTIVE_LENGTH; length++ )
+   {
+      memset( counter, 0, sizeof( counter ) );
+      do
+      {
+         for ( ii = 0; ii < length; ii++ )
+         {
+            text[ii] = ALPHABET[counter[ii]];
+         }
+         failures += ( checkToken( text, length ) == 0 );
+         cases++;
+
+         ii = 0;
+         while ( ( ii < length ) && ( ++counter[ii] == alphabet ) )
+         {
+            counter[ii] = 0;
+            ii++;
+         }
+      } while ( ii < length );
+   }
+
+   /* Random strings and decimals */
+   for ( jj = 0; jj < randomCases; jj++ )
+   {
+      randomString( text, &length );
+      failures += ( checkToken( text, length ) == 0 );
+      randomDecimal( text, &length );
+      failures += ( checkToken( text, length ) == 0 );
+      cases += 2;
+   }
+
+   printf( "parse: %ld cases, %ld failures\n", cases, failures );
+
+   return ( failures == 0 ) ? 0 : 1;
+}
+
+
+/* NAME: checkToken()
+ * PURPOSE: Checks parseReal() and parseInteger() on one span against
+ *          strtod() and strtol(), returning whether both agree.
+ * HOW IT WORKS: - Copies the span into a buffer followed by a stray digit,
+ *                 which a parser reading past the span would take in.
+ *               - Converts a terminated copy with strtod() and strtol(). A
+ *                 span of VALUE_LENGTH or more is never a valid value, so
+ *                 is expected to be left unconverted, giving 0.
+ *               - Compares the values' bits and where each conversion
+ *                 stopped, printing the span of any mismatch.
+ * RELATIONS:
+ *    main() - Checks each case.
+ * IMPORTS:
+ *    token - The characters of the span, not needing a terminator.
+ *    length - The number of characters.
+ * EXPORTS:
+ *    isSame - Boolean evaluating to '-1' (TRUE) if both parsers agree with
+ *             the standard library, or '0' (FALSE) otherwise.
+ */
+
+static int checkToken( const char* token, size_t length )
+{
+   int isSame = -1;
+   char spanText[VALUE_LENGTH + 3];
+   char copy[VALUE_LENGTH + 3];
+   char* end;
+   Span span;
+   Span remainder;
+   double real;
+   double expectedReal;
+   long integer;
+   long expectedInteger;
+   size_t realUsed = 0;
+   size_t integerUsed = 0;
+
+   memcpy( spanText, token, length );
+   spanText[length] = '7';
+   span.start = spanText;
+   span.length = length;
+
+   memcpy( copy, token, length );
+   copy[length] = '\0';
+   expectedReal = 0.0;
+   expectedInteger = 0;
+   if ( length < VALUE_LENGTH )
+   {
+      expectedReal = strtod( copy, &end );
+      realUsed = ( size_t )( end - copy );
+      expectedInteger = strtol( copy, &end, 10 );
+      integerUsed = ( size_t )( end - copy );
+   }
+
+   real = parseReal( &span, &remainder );
+   if ( ( memcmp( &real, &expectedReal, sizeof( double ) ) != 0 ) ||
+        ( remainder.start != spanText + realUsed ) || ( remainder.length != length - realUsed ) )
+   {
+      isSame = 0;
+      printf( "parseReal(\"%.*s\") gave %.17g using %ld, strtod() %.17g using %ld\n",
+              ( int )length, token, real, ( long )( remainder.start - spanText ),
+              expectedReal, ( long )realUsed );
+   }
+
+   integer = parseInteger( &span, &remainder );
+   if ( ( integer != expectedInteger ) ||
+        ( remainder.start != spanText + integerUsed ) || ( remainder.length != length - integerUsed ) )
+   {
+      isSame = 0;
+      printf( "parseInteger(\"%.*s\") gave %ld using %ld, strtol() %ld using %ld\n",
+              ( int )length, token, integer, ( long )( remainder.start - spanText ),
+              expectedInteger, ( long )integerUsed );
+   }
+
+   return isSame;
+}
+
+
+/* NAME: nextRandom()
+ * PURPOSE: Gives the next number of a fixed random sequence.
+ * HOW IT WORKS: Steps a 64-bit linear congruential generator, taking its
+ *               top 31 bits, the same on every machine unlike rand().
+ * RELATIONS:
+ *    randomString()/randomDecimal() - Choose each character.
+ * IMPORTS:
+ *    none
+ * EXPORTS:
+ *    number - A number from 0 to 2^31 - 1.
+ */
+
+static unsigned long nextRandom( void )
+{
+   seed = ( seed * 6364136223846793005UL + 1442695040888963407UL ) & 0xFFFFFFFFFFFFFFFFUL;
+
+   return ( seed >> 33 ) & 0x7FFFFFFFUL;
+}
+
+
+/* NAME: randomString()
+ * PURPOSE: Makes a random string of the characters numbers are made of.
+ * HOW IT WORKS: Picks a length up to RANDOM_LENGTH, then each character,
+ *               digits being the most likely.
+ * RELATIONS:
+ *    main() - Makes each random string checked.
+ * IMPORTS:
+ *    text - Set to the string, not terminated.
+ *    length - Set to its length.
+ * EXPORTS:
+ *    none
+ */
+
+static void randomString( char* text, size_t* length )
+{
+   static const char CHARACTERS[] = "0123456789012345678901234567890123456789..+-eExXpPinfaty \t";
+   size_t ii;
+
+   *length = nextRandom() % ( RANDOM_LENGTH + 1 );
+   for ( ii = 0; ii < *length; ii++ )
+   {
+      text[ii] = CHARACTERS[nextRandom() % ( sizeof( CHARACTERS ) - 1 )];
+   }
+}
+
+
+/* NAME: randomDecimal()
+ * PURPOSE: Makes a random decimal as found in scripts, with an optional
+ *          sign, point and exponent.
+ * HOW IT WORKS: Writes up to RANDOM_DIGITS digits with a point somewhere
+ *               among them, or none, then an exponent one time in four.
+ *               Digit counts either side of 15 and exponents either side
+ *               of 22 take both the fast path and the copy.
+ * RELATIONS:
+ *    main() - Makes each random decimal checked.
+ * IMPORTS:
+ *    text - Set to the decimal, not terminated.
+ *    length - Set to its length.
+ * EXPORTS:
+ *    none
+ */
+
+static void randomDecimal( char* text, size_t* length )
+{
+   size_t digits = 1 + nextRandom() % RANDOM_DIGITS;
+   size_t point = nextRandom() % ( digits + 2 );
+   size_t ii;
+   int written;
+
+   *length = 0;
+   if ( nextRandom() % 2 != 0 )
+   {
+      text[( *length )++] = ( nextRandom() % 4 != 0 ) ? '-' : '+';
+   }
+   for ( ii = 0; ii < digits; ii++ )
+   {
+      if ( ii == point )
+      {
+         text[( *length )++] = '.';
+      }
+      text[( *length )++] = ( char )( '0' + nextRandom() % 10 );
+   }
+   if ( nextRandom() % 4 == 0 )
+   {
+      written = sprintf( text + *length, "e%ld", ( long )( nextRandom() % 61 ) - 30 );
+      *length += ( size_t )written;
+   }
+}
@@ -0,0 +1,566 @@
+/*
+ * FILE: trace.c
+ * AUTHOR: Kyle Notani | 19149918
+ * UNIT: UCP COMP1000
+ * PURPOSE: Trace where each DRAW and MOVE of a long script takes the turtle
+ *          on several threads, ahead of the commands being drawn in order.
+ * OTHER: Each command's step is worked out with the same conversions.c
+ *        functions, in the same order, as drawLine(), move() and rotate(),
+ *        so a step traced from the right start is exactly the step drawing
+ *        takes, to the last bit. A run traced from a start that turns out
+ *        wrong is traced again, so the steps never differ from drawing the
+ *        commands one by one, whatever their values.
+ *        '-1' evaluates to true, '0' evaluates to false.
+ */
+
+#define _POSIX_C_SOURCE 199506L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "trace.h"
+#include "commandarray.h"
+#include "structset.h"
+#include "conversions.h"
+#include "chunks.h"
+#include "batch.h"
+
+static int splitTrace( Command* commands, int count, int threads, TraceChunk* chunks );
+static void runTrace( TraceChunk* chunks, int count, void* ( *work )( void* ) );
+static void* turnChunk( void* data );
+static double turnFrom( TraceChunk* chunk, double angle );
+static void* predictChunk( void* data );
+static void* traceChunk( void* data );
+static void runChunk( TraceChunk* chunk );
+static void stepTurtle( Turtle* turtle, Command* cmd, Step* step );
+static void startAfterLine( Turtle* turtle, double angle, double lineX, double lineY );
+static int isSameTurtle( Turtle* turtle, Turtle* other );
+
+
+/* NAME: traceSteps()
+ * PURPOSE: Traces where a window of commands takes the turtle, on up to the
+ *          number of threads given, moving the turtle on to the end of it.
+ * HOW IT WORKS: Each run of commands moves the turtle by a turn and a shift,
+ *               which add up from one run to the next, so where every run
+ *               starts is found by a scan of the runs' totals:
+ *               - The window is split into one run per thread with
+ *                 splitTrace(). Every run but the first starts straight
+ *                 after a draw, at a whole cell plus one step along its
+ *                 heading, so its start is known once its angle and that
+ *                 cell are.
+ *               - Every run adds up its turns at once, from an angle of 0.
+ *                 Scanning them gives each run's starting angle. Turns of
+ *                 fractions of a degree round differently added in another
+ *                 order, so with any of those the runs are instead turned
+ *                 through in order, which only looks at their rotates.
+ *               - Every run is then traced at once: the first from the
+ *                 turtle, writing its steps, and the others from the cell
+ *                 0,0 at their angle. The cell each ends its last line on
+ *                 is a whole number of cells on from where it started, so
+ *                 scanning them gives each run's starting cell, exactly.
+ *               - Every run but the first is traced again at once, from its
+ *                 start, writing its steps.
+ *               - Each run's start is checked against where the run before
+ *                 it really ended. Rounding can land a run traced from 0,0
+ *                 on a different cell than from its real start, so a run
+ *                 whose start was wrong is traced again from the right one,
+ *                 on the calling thread.
+ *               - A window too small to split is traced on the calling
+ *                 thread alone.
+ * RELATIONS:
+ *    draw() - Traces each window of a long script before drawing it.
+ *    splitTrace() - Splits the window into runs.
+ *    runTrace() - Runs a step on every run at once.
+ *    turnChunk()/predictChunk()/traceChunk() - The steps of each run.
+ * IMPORTS:
+ *    commands - The first command of the window, none of which are blocks.
+ *    count - The number of commands in the window.
+ *    turtle - Where the window starts, moved on to where it ends.
+ *    steps - Set to where each DRAW and MOVE takes the turtle, one per
+ *            command.
+ *    threads - Most threads to trace on, 0 for one per processor.
+ * EXPORTS:
+ *    none
+ */
+
+void traceSteps( Command* commands, int count, Turtle* turtle, Step* steps, int threads )
+{
+   TraceChunk chunks[MAX_THREADS];
+   int runs;
+   int isWhole;
+   double angle;
+   double lineX;
+   double lineY;
+   int ii;
+
+   if ( threads <= 0 )
+   {
+      threads = ( int )sysconf( _SC_NPROCESSORS_ONLN );
+   }
+   runs = splitTrace( commands, count, threads, chunks );
+   for ( ii = 0; ii < runs; ii++ )
+   {
+      chunks[ii].steps = NULL;
+   }
+   chunks[0].start = *turtle;
+   chunks[0].steps = steps;
+
+   if ( runs > 1 )
+   {
+      /* Scan the turns for the angle each run starts at, or turn through
+       * each run in order when they don't add up exactly */
+      runTrace( chunks, runs, &turnChunk );
+      isWhole = -1;
+      for ( ii = 0; ii < runs; ii++ )
+      {
+         if ( chunks[ii].isWhole == 0 )
+         {
+            isWhole = 0;
+         }
+      }
+      angle = turtle->angle;
+      for ( ii = 1; ii < runs; ii++ )
+      {
+         if ( isWhole != 0 )
+         {
+            angle = defineAngle( angle + chunks[ii - 1].turn );
+         }
+         else
+         {
+            angle = turnFrom( &( chunks[ii - 1] ), angle );
+         }
+         startAfterLine( &( chunks[ii].start ), angle, 0.0, 0.0 );
+      }
+
+      /* Scan the cells each run moves on by for the cell each starts at */
+      runTrace( chunks, runs, &predictChunk );
+      lineX = chunks[0].end.lineX;
+      lineY = chunks[0].end.lineY;
+      for ( ii = 1; ii < runs; ii++ )
+      {
+         startAfterLine( &( chunks[ii].start ), chunks[ii].start.angle, lineX, lineY );
+         lineX += chunks[ii].end.lineX;
+         lineY += chunks[ii].end.lineY;
+         chunks[ii].steps = steps + ( chunks[ii].commands - commands );
+      }
+   }
+   runTrace( chunks, runs, &traceChunk );
+
+   /* Trace again any run that didn't start where the one before ended */
+   for ( ii = 1; ii < runs; ii++ )
+   {
+      if ( isSameTurtle( &( chunks[ii].start ), &( chunks[ii - 1].end ) ) == 0 )
+      {
+         chunks[ii].start = chunks[ii - 1].end;
+         runChunk( &( chunks[ii] ) );
+      }
+   }
+
+   *turtle = chunks[runs - 1].end;
+}
+
+
+/* NAME: splitTrace()
+ * PURPOSE: Splits a window of commands into runs, one per thread.
+ * HOW IT WORKS: - Takes one run per MIN_TRACE_CHUNK commands, up to the
+ *                 number of threads and MAX_THREADS, and at least one.
+ *               - Each run ends at the first DRAW at or after its share of
+ *                 the window, so the run after it starts straight after a
+ *                 draw. A share with no DRAW is joined to the next.
+ * RELATIONS:
+ *    traceSteps() - Splits the window before tracing it.
+ * IMPORTS:
+ *    commands - The first command of the window.
+ *    count - The number of commands in the window.
+ *    threads - Most runs to split into.
+ *    chunks - Array of MAX_THREADS runs to set up.
+ * EXPORTS:
+ *    runs - The number of runs set up, at least 1.
+ */
+
+static int splitTrace( Command* commands, int count, int threads, TraceChunk* chunks )
+{
+   int shares = count / MIN_TRACE_CHUNK;
+   int runs = 0;
+   int start = 0;
+   int end;
+   int ii;
+
+   if ( shares > threads )
+   {
+      shares = threads;
+   }
+   if ( shares > MAX_THREADS )
+   {
+      shares = MAX_THREADS;
+   }
+   if ( shares < 1 )
+   {
+      shares = 1;
+   }
+
+   for ( ii = 1; ii <= shares; ii++ )
+   {
+      end = count;
+      if ( ii < shares )
+      {
+         end = ( count / shares ) * ii;
+         while ( ( end > start ) && ( end < count ) && ( commands[end - 1].opcode != OP_DRAW ) )
+         {
+            end++;
+         }
+      }
+      if ( ( end > start ) || ( runs == 0 ) )
+      {
+         chunks[runs].commands = commands + start;
+         chunks[runs].count = end - start;
+         chunks[runs].isTraced = 0;
+         runs++;
+         start = end;
+      }
+   }
+
+   return runs;
+}
+
+
+/* NAME: runTrace()
+ * PURPOSE: Runs a step on every run at once, returning once all are done.
+ * HOW IT WORKS: Starts a thread for every run but the first, which is run
+ *               on the calling thread, then joins them, as runChunks() in
+ *               chunks.c does. A run whose thread can't be started is run
+ *               on the calling thread instead.
+ * RELATIONS:
+ *    traceSteps() - Runs each step of tracing a window.
+ * IMPORTS:
+ *    chunks - The runs to run the step on.
+ *    count - The number of runs.
+ *    work - The step, given a pointer to its run.
+ * EXPORTS:
+ *    none
+ */
+
+static void runTrace( TraceChunk* chunks, int count, void* ( *work )( void* ) )
+{
+   pthread_t threads[MAX_THREADS];
+   int isStarted[MAX_THREADS];
+   int ii;
+
+   for ( ii = 1; ii < count; ii++ )
+   {
+      isStarted[ii] = 0;
+      if ( pthread_create( &threads[ii], NULL, work, &chunks[ii] ) == 0 )
+      {
+         isStarted[ii] = -1;
+      }
+   }
+
+   ( *work )( &chunks[0] );
+
+   for ( ii = 1; ii < count; ii++ )
+   {
+      if ( isStarted[ii] != 0 )
+      {
+         pthread_join( threads[ii], NULL );
+      }
+      else
+      {
+         ( *work )( &chunks[ii] );
+      }
+   }
+}
+
+
+/* NAME: turnChunk()
+ * PURPOSE: Adds up the turns of a run, from an angle of 0, checking if
+ *          they are all whole.
+ * HOW IT WORKS: Turns through the run with turnFrom(). Whole turns are
+ *               added and kept within 360 degrees with no rounding at all,
+ *               so add up to exactly the same angle in any order.
+ * RELATIONS:
+ *    traceSteps() - Turns every run at once with runTrace().
+ * IMPORTS:
+ *    data - Pointer to the run.
+ * EXPORTS:
+ *    NULL
+ */
+
+static void* turnChunk( void* data )
+{
+   TraceChunk* chunk = ( TraceChunk* )data;
+   double value;
+   int ii;
+
+   chunk->isWhole = -1;
+   for ( ii = 0; ( ii < chunk->count ) && ( chunk->isWhole != 0 ); ii++ )
+   {
+      if ( chunk->commands[ii].opcode == OP_ROTATE )
+      {
+         value = chunk->commands[ii].value.real;
+         if ( ( value != floor( value ) ) || ( fabs( value ) > MAX_WHOLE_TURN ) )
+         {
+            chunk->isWhole = 0;
+         }
+      }
+   }
+   chunk->turn = turnFrom( chunk, 0.0 );
+
+   return NULL;
+}
+
+
+/* NAME: turnFrom()
+ * PURPOSE: Turns through a run from an angle, returning the angle it ends
+ *          at.
+ * HOW IT WORKS: Turns by each ROTATE as rotate() does, keeping the angle
+ *               within 360 degrees.
+ * RELATIONS:
+ *    turnChunk() - Adds up the turns of a run from 0.
+ *    traceSteps() - Finds each run's angle in order when the turns aren't
+ *                   all whole.
+ * IMPORTS:
+ *    chunk - The run.
+ *    angle - The angle the run starts at.
+ * EXPORTS:
+ *    angle - The angle the run ends at.
+ */
+
+static double turnFrom( TraceChunk* chunk, double angle )
+{
+   int ii;
+
+   for ( ii = 0; ii < chunk->count; ii++ )
+   {
+      if ( chunk->commands[ii].opcode == OP_ROTATE )
+      {
+         angle = defineAngle( angle + chunk->commands[ii].value.real );
+      }
+   }
+
+   return angle;
+}
+
+
+/* NAME: predictChunk()
+ * PURPOSE: Traces a run from its predicted start, writing its steps only if
+ *          it has somewhere to write them.
+ * HOW IT WORKS: Runs the run with runChunk(). The first run starts where the
+ *               turtle is, so its steps are written now and it isn't traced
+ *               again.
+ * RELATIONS:
+ *    traceSteps() - Predicts every run at once with runTrace().
+ * IMPORTS:
+ *    data - Pointer to the run.
+ * EXPORTS:
+ *    NULL
+ */
+
+static void* predictChunk( void* data )
+{
+   TraceChunk* chunk = ( TraceChunk* )data;
+
+   runChunk( chunk );
+   chunk->isTraced = ( chunk->steps != NULL ) ? -1 : 0;
+
+   return NULL;
+}
+
+
+/* NAME: traceChunk()
+ * PURPOSE: Traces a run not yet traced from its start, writing its steps.
+ * HOW IT WORKS: Runs the run with runChunk(), unless already traced.
+ * RELATIONS:
+ *    traceSteps() - Traces every run at once with runTrace().
+ * IMPORTS:
+ *    data - Pointer to the run.
+ * EXPORTS:
+ *    NULL
+ */
+
+static void* traceChunk( void* data )
+{
+   TraceChunk* chunk = ( TraceChunk* )data;
+
+   if ( chunk->isTraced == 0 )
+   {
+      runChunk( chunk );
+      chunk->isTraced = -1;
+   }
+
+   return NULL;
+}
+
+
+/* NAME: runChunk()
+ * PURPOSE: Moves the turtle through a run from its start, finding where
+ *          it ends.
+ * HOW IT WORKS: Goes through the run TRACE_BLOCK commands at a time:
+ *               - Turns through the block's rotates, noting the angle after
+ *                 each, then finds all their directions at once with
+ *                 defineDirections(), the same directions rotate() finds.
+ *               - Steps the turtle through each command, a rotate taking
+ *                 its angle and direction from those found, and a DRAW or
+ *                 MOVE stepped with stepTurtle(), writing each step if the
+ *                 run has steps to write.
+ * RELATIONS:
+ *    predictChunk()/traceChunk() - Trace each run on its own thread.
+ *    traceSteps() - Traces again a run that started in the wrong place.
+ * IMPORTS:
+ *    chunk - The run, its end set to where the turtle ends.
+ * EXPORTS:
+ *    none
+ */
+
+static void runChunk( TraceChunk* chunk )
+{
+   Turtle turtle = chunk->start;
+   Step scratch;
+   double angles[TRACE_BLOCK];
+   double dirX[TRACE_BLOCK];
+   double dirY[TRACE_BLOCK];
+   double angle;
+   int start;
+   int end;
+   int turns;
+   int ii;
+
+   for ( start = 0; start < chunk->count; start = end )
+   {
+      end = ( ( chunk->count - start ) < TRACE_BLOCK ) ? chunk->count : ( start + TRACE_BLOCK );
+
+      angle = turtle.angle;
+      turns = 0;
+      for ( ii = start; ii < end; ii++ )
+      {
+         if ( chunk->commands[ii].opcode == OP_ROTATE )
+         {
+            angle = defineAngle( angle + chunk->commands[ii].value.real );
+            angles[turns] = angle;
+            turns++;
+         }
+      }
+      defineDirections( angles, dirX, dirY, turns );
+
+      turns = 0;
+      for ( ii = start; ii < end; ii++ )
+      {
+         if ( chunk->commands[ii].opcode == OP_ROTATE )
+         {
+            turtle.angle = angles[turns];
+            turtle.dirX = dirX[turns];
+            turtle.dirY = dirY[turns];
+            turns++;
+         }
+         else
+         {
+            stepTurtle( &turtle, &( chunk->commands[ii] ), ( chunk->steps != NULL ) ? &( chunk->steps[ii] ) : &scratch );
+         }
+      }
+   }
+   chunk->end = turtle;
+}
+
+
+/* NAME: stepTurtle()
+ * PURPOSE: Moves the turtle by a single command other than a rotate.
+ * HOW IT WORKS: A draw goes distance-1 along the direction, rounds the end
+ *               to a whole cell, then moves on by one, as drawLine() does.
+ *               A move is as move(). Other commands leave the turtle where
+ *               it is.
+ * RELATIONS:
+ *    runChunk() - Steps through each command of a run.
+ * IMPORTS:
+ *    turtle - Where the turtle is, moved on by the command.
+ *    cmd - The command.
+ *    step - Set to where a DRAW or MOVE takes the turtle.
+ * EXPORTS:
+ *    none
+ */
+
+static void stepTurtle( Turtle* turtle, Command* cmd, Step* step )
+{
+   double distance = 0.0;
+   double finalMove = 1.0;
+   double startX = turtle->x;
+   double startY = turtle->y;
+
+   switch ( cmd->opcode )
+   {
+      case OP_DRAW:
+         distance = cmd->value.real - 1;
+         defineCoordinates( &startX, &startY, &( step->endX ), &( step->endY ), &( turtle->dirX ), &( turtle->dirY ), &distance );
+         turtle->lineX = floor( step->endX + 0.5 );
+         turtle->lineY = floor( step->endY + 0.5 );
+         defineCoordinates( &( turtle->lineX ), &( turtle->lineY ), &( turtle->x ), &( turtle->y ),
+                            &( turtle->dirX ), &( turtle->dirY ), &finalMove );
+         step->x = turtle->x;
+         step->y = turtle->y;
+         break;
+      case OP_MOVE:
+         distance = cmd->value.real;
+         defineCoordinates( &startX, &startY, &( turtle->x ), &( turtle->y ), &( turtle->dirX ), &( turtle->dirY ), &distance );
+         step->x = turtle->x;
+         step->y = turtle->y;
+         break;
+      default:
+         break;
+   }
+}
+
+
+/* NAME: startAfterLine()
+ * PURPOSE: Places the turtle where a draw ending on a cell leaves it.
+ * HOW IT WORKS: Finds the direction of the angle, then moves on by one from
+ *               the cell, with the same arithmetic as drawLine().
+ * RELATIONS:
+ *    traceSteps() - Sets where each run but the first starts.
+ * IMPORTS:
+ *    turtle - Set to where the turtle is left.
+ *    angle - Angle the line was drawn at.
+ *    lineX/lineY - The cell the line ended on.
+ * EXPORTS:
+ *    none
+ */
+
+static void startAfterLine( Turtle* turtle, double angle, double lineX, double lineY )
+{
+   double finalMove = 1.0;
+
+   turtle->angle = angle;
+   defineDirection( angle, &( turtle->dirX ), &( turtle->dirY ) );
+   turtle->lineX = lineX;
+   turtle->lineY = lineY;
+   defineCoordinates( &( turtle->lineX ), &( turtle->lineY ), &( turtle->x ), &( turtle->y ),
+                      &( turtle->dirX ), &( turtle->dirY ), &finalMove );
+}
+
+
+/* NAME: isSameTurtle()
+ * PURPOSE: Checks if two turtles are in exactly the same place.
+ * HOW IT WORKS: Compares the position, angle and direction, which must be
+ *               equal to the last bit.
+ * RELATIONS:
+ *    traceSteps() - Checks each run started where the one before ended.
+ * IMPORTS:
+ *    turtle/other - The turtles to compare.
+ * EXPORTS:
+ *    isSame - Boolean evaluating to '-1' (TRUE) if they are the same, or
+ *             '0' (FALSE) otherwise.
+ */
+
+static int isSameTurtle( Turtle* turtle, Turtle* other )
+{
+   int isSame = 0;
+
+   if ( ( turtle->x == other->x ) && ( turtle->y == other->y ) && ( turtle->angle == other->angle ) &&
+        ( turtle->dirX == other->dirX ) && ( turtle->dirY == other->dirY ) )
+   {
+      isSame = -1;
+   }
+
+   return isSame;
+}
@@ -0,0 +1,69 @@
+/* FILE: trace.h
+ * AUTHOR: Kyle Notani | 19149918
+ * UNIT: UCP COMP1000
+ * PURPOSE: Header file associated with trace.c
+ */
+
+#ifndef TRACE_H
+   #define TRACE_H
+
+   #include "commandarray.h"
+   #include "structset.h"
+
+   /* Fewest commands of a script traced on several threads, smaller ones
+    * being run straight through */
+   #define MIN_TRACE_COMMANDS 65536
+
+   /* Commands traced at a time, ahead of being drawn */
+   #define TRACE_WINDOW 262144
+
+   /* Commands of a run whose rotates' directions are found at a time */
+   #define TRACE_BLOCK 1024
+
+   /* Fewest commands given to each thread */
+   #define MIN_TRACE_CHUNK 4096
+
+   /* Largest whole ROTATE added up exactly in any order, well within a
+    * double's whole numbers even added over a whole window */
+   #define MAX_WHOLE_TURN 1.0e9
+
+   /* Stores where the turtle is, as drawLine(), move() and rotate() move
+    * it */
+   typedef struct
+   {
+      double x;
+      double y;
+      double angle;
+      double dirX;
+      double dirY;
+      /* Rounded end of the last line drawn */
+      double lineX;
+      double lineY;
+   } Turtle;
+
+   /* Stores a run of commands traced on its own thread. Every run but the
+    * first starts straight after a draw, so at a whole cell plus one step
+    * along its heading */
+   typedef struct
+   {
+      Command* commands;
+      int count;
+      /* Where each command takes the turtle, NULL while only predicting */
+      Step* steps;
+      /* Where the run is predicted to start, and where it ends */
+      Turtle start;
+      Turtle end;
+      /* Turn of the run's rotates, from an angle of 0, and whether every
+       * one is whole */
+      double turn;
+      int isWhole;
+      /* Whether the steps are written from the start */
+      int isTraced;
+   } TraceChunk;
+
+   /* Traces where a window of commands takes the turtle, on up to the
+    * number of threads given, moving the turtle on to the end of it.
+    */
+   void traceSteps( Command* commands, int count, Turtle* turtle, Step* steps, int threads );
+
+#endif
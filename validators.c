@@ -7,17 +7,68 @@
  *          count, data type and value range.
  * OTHER: This file contains functions that assist readinput.c to achieve it's 
  *        purpose.
+ *        Every validator works only on the spans and report it is given, so
+ *        separate parts of a file can be validated on separate threads.
  *        '-1' evaluates to true, '0' evaluates to false.
  */
 
+#define _POSIX_C_SOURCE 199506L
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
 #include <errno.h>
+#include <assert.h>
+#include <pthread.h>
 
 #include "validators.h"
 #include "stringoperations.h"
+#include "report.h"
+
+/* Longest DRAW or MOVE distance allowed, set once before any validation and
+ * only read while validating */
+static int maxDistance = 80;
+
+/* Number of slots commands are hashed into by hashCommandName(), a power
+ * of two at least four times the number of commands, so a seed hashing no
+ * two commands to the same slot is soon found */
+#define COMMAND_SLOTS 64
+
+/* Most seeds buildCommandSlots() tries before giving up */
+#define MAX_SEEDS 65536
+
+/* Every command, with its opcode and the validators of its value */
+static const CommandDescriptor commands[] =
+{
+   { "DRAW", OP_DRAW, &validateReal, &validateParameters, &validateDrawRange },
+   { "MOVE", OP_MOVE, &validateReal, &validateParameters, &validateMoveRange },
+   { "ROTATE", OP_ROTATE, &validateReal, &validateParameters, &validateRotateRange },
+   { "FG", OP_FG, &validateInt, &validateParameters, &validateFgRange },
+   { "BG", OP_BG, &validateInt, &validateParameters, &validateBgRange },
+   { "PATTERN", OP_PATTERN, &validateChar, &validatePatternParameters, &validatePatternRange },
+   { "REPEAT", OP_REPEAT, &validateInt, &validateBlockParameters, &validateRepeatRange },
+   { "PROC", OP_PROC, &validateName, &validateBlockParameters, &validateNameRange },
+   { "CALL", OP_CALL, &validateName, &validateParameters, &validateNameRange }
+};
+
+/* Number of commands, checked at compile time to fit COMMAND_SLOTS */
+#define COMMAND_COUNT ( sizeof( commands ) / sizeof( commands[0] ) )
+typedef char CommandSlotsFit[( COMMAND_COUNT * 4 <= COMMAND_SLOTS ) ? 1 : -1];
+
+/* Index into commands of the command each hash belongs to, -1 for none.
+ * Built from commands by buildCommandSlots() the first time a name is
+ * looked up, with the seed it found hashing every command to a slot of its
+ * own, so a new command only needs adding to commands */
+static signed char commandSlots[COMMAND_SLOTS];
+static unsigned long slotSeed = 0;
+static pthread_once_t isBuilt = PTHREAD_ONCE_INIT;
+
+static void buildCommandSlots( void );
+static int hashCommandName( const char* name, size_t length, unsigned long seed );
+static int isEndOfValue( Span* remainder );
+static int isOpenBlock( Span* token );
+static size_t nameLength( Span* name );
 
 
 /*
@@ -26,84 +77,56 @@
  *          is found or not found. Provides the main function assistance
  *          to continue validating other command fields. 
  *          
- * HOW IT WORKS: - Uses strtok() to tokenise the command contained in the line
- *                 string to grab the command name.
- *               - Modify the string to uppercase to check if it matches each of
- *                 the valid commands viable for use.
- *               - Each identified command points all function pointers to another
- *                 validation function to further test if the command is viable.
+ * HOW IT WORKS: - Uses nextToken() to tokenise the command contained in the line
+ *                 span to grab the command name, in place.
+ *               - Hashes the name with hashCommandName(), which ignores case,
+ *                 to find the only command it could be in commandSlots,
+ *                 built by buildCommandSlots() on the first lookup.
+ *               - Compares it ignoring case to that command's name to check
+ *                 it matches, so any name is looked up with a single
+ *                 comparison however many commands there are.
+ *               - The descriptor of an identified command holds its opcode,
+ *                 so the command can be stored without keeping its name,
+ *                 and points to the validation functions to further test if
+ *                 the command is viable.
  * RELATIONS:
  *    main() - Calling function for command validation.
- *    stringUpperCase() - Used to treat each command name to be case
- *                        insensitive and provide comparison with expected
- *                        uppercase command names. A command name with mixed casing
- *                        is allowed.
+ *    buildCommandSlots()/hashCommandName() - Find the command a name could
+ *                                            be.
+ *    spanMatches() - Used to treat each command name to be case
+ *                    insensitive and provide comparison with expected
+ *                    uppercase command names. A command name with mixed casing
+ *                    is allowed.
  * IMPORTS:
- *    tempLine - The line string to check if a command name is valid.
- *    validateDataType - Function pointer to point to a matched command's data type
- *                       validation.
- *    validateParam - Function pointer to point to a matched command's parameters
- *                    validation.
- *    validateRange - Function pointer to point to a matched command's value range
- *                    validation.
+ *    rest - The line span to check if a command name is valid, moved on
+ *           past the name.
+ *    command - Points to the descriptor of a matched command.
  * EXPORTS:
  *    isValid - A boolean evaluating to '0' (FALSE) if a command name is invalid 
  *              or '-1' (TRUE) if command name is valid.
  *
  */
 
-int validateCommandName( char* tempLine, CmdDataFunc* validateDataType, CmdParamFunc* validateParam, CmdRangeFunc* validateRange )
+int validateCommandName( Span* rest, const CommandDescriptor** command )
 {
    int isValid = 0;
+   int slot;
 
-   char* command = NULL;
+   Span name;
 
    /* Get expected command name */
-   command = strtok( tempLine, " " );
-   stringUpperCase( command );
+   nextToken( rest, &name );
 
-   /* Check if a command name matches */
-   if ( strcmp( command, "DRAW" ) == 0 )
-   {
-      isValid = -1;
-      *validateDataType = &validateReal;
-      *validateParam = &validateParameters;
-      *validateRange = &validateDrawRange;
-   }
-   else if ( strcmp( command, "MOVE" ) == 0 )
-   {
-      isValid = -1;
-      *validateDataType = &validateReal;
-      *validateParam = &validateParameters;
-      *validateRange = &validateMoveRange;
-   }
-   else if ( strcmp( command, "ROTATE" ) == 0 )
-   {
-      isValid = -1;
-      *validateDataType = &validateReal;
-      *validateParam = &validateParameters;
-      *validateRange = &validateRotateRange;
-   }
-   else if ( strcmp( command, "FG" ) == 0 )
-   {
-      isValid = -1;
-      *validateDataType = &validateInt;
-      *validateParam = &validateParameters;
-      *validateRange = &validateFgRange;
-   }
-   else if ( strcmp ( command, "BG" ) == 0 )
-   {
-      isValid = -1;
-      *validateDataType = &validateInt;
-      *validateParam = &validateParameters;
-      *validateRange = &validateBgRange;
-   }
-   else if ( strcmp ( command, "PATTERN" ) == 0 )
+   /* Check if the one command the name hashes to matches */
+   pthread_once( &isBuilt, &buildCommandSlots );
+   if ( name.start != NULL )
    {
-      isValid = -1;
-      *validateDataType = &validateChar;
-      *validateParam = &validatePatternParameters;
-      *validateRange = &validatePatternRange;
+      slot = commandSlots[hashCommandName( name.start, name.length, slotSeed )];
+      if ( ( slot >= 0 ) && ( spanMatches( &name, commands[slot].name ) != 0 ) )
+      {
+         isValid = -1;
+         *command = &commands[slot];
+      }
    }
 
    return isValid;
@@ -115,51 +138,54 @@ int validateCommandName( char* tempLine, CmdDataFunc* validateDataType, CmdParam
 /*
  * NAME: validateReal()
  * PURPOSE: Validates if a command value is of a real data type.
- * HOW IT WORKS: - Tokenises the line string containing the command operation 
- *                 to grab the value as a string.
- *               - Convert the string value to a real by using strtod() as well
- *                 as passing a string to identify errors during conversion.
- *               - If error string contains a new line character or a null
- *                 terminator the datatype is correct.
- *               - Compare errorString to strValue to assure that strtod() that 
- *                 conversion went correctly. strtod() stores the original 
- *                 string in errorPtr if conversion was not successful.
+ * HOW IT WORKS: - Tokenises the line span containing the command operation
+ *                 to grab the value.
+ *               - Convert the value in place to a real by using
+ *                 parseReal(), which parses it as strtod() would in a single
+ *                 pass, giving the remainder of the value left unconverted
+ *                 and the real kept for the range check and the command.
+ *               - If the remainder is empty or starts with a new line
+ *                 character the datatype is correct.
+ *               - Compare the remainder to the value to assure that
+ *                 conversion went correctly. Nothing is converted if the
+ *                 remainder is the whole value.
  * RELATIONS: 
  *    main() - To evaluate the datatype validation condition for a command in a line.
- *           - Has the 'errorString' and 'strValue' passed by reference to also be utilised
- *             with other validation functions.
+ *           - Has the value passed by reference to also be utilised with
+ *             other validation functions.
  *    validateCommandName() - Points to this function depending on command operation.
  * IMPORTS:
- *    errorString - A pointer to a string passed by reference from main() containing
- *                  the errorString from strtod().
- *    strValue - A pointer to a string passed by reference from main() to be used
- *               in other validation functions dealing with the command value only.
+ *    rest - The rest of the line span, moved on past the value.
+ *    value - Set to the value's text, the part of it parseReal() did not
+ *            convert and the real, to be used in other validation functions
+ *            dealing with the command value only.
+ *    report - Collects the error message of an invalid value.
  * EXPORTS:
  *    isValid - A boolean evaluating to '0' (FALSE) if a command name is invalid
  *              or '-1' (TRUE) if command name is valid.
  *
  */
 
-int validateReal( char** errorString, char** strValue )
+int validateReal( Span* rest, Operand* value, Report* report )
 {
    int isValid = 0;
-   double realValue = 0.0;   
 
-   /* Set the strValue to expected value within same line string */
-   *strValue = strtok( NULL, " " );
+   /* Set the value to expected value within same line span */
+   nextToken( rest, &value->text );
+   value->remainder = value->text;
 
-   if ( *strValue != NULL )
+   if ( value->text.start != NULL )
    {
-      realValue = strtod( *strValue, errorString );
+      value->real = parseReal( &value->text, &value->remainder );
 
-      /* Evaluate errorString thorougly testing all conversion cases */
-      if ( ( (**errorString == '\n') || (**errorString == '\0') ) && ( ( strlen(*strValue) != strlen(*errorString) ) && ( strcmp( *strValue, *errorString ) != 0 ) ) )
+      /* Evaluate the remainder thorougly testing all conversion cases */
+      if ( ( isEndOfValue( &value->remainder ) != 0 ) && ( value->remainder.length != value->text.length ) )
       {
          isValid = -1;
       }
       else
       {
-         printf( "Error: real data type expected\n" );
+         addMessage( report, "Error: real data type expected\n" );
       }
    }
    
@@ -171,52 +197,56 @@ int validateReal( char** errorString, char** strValue )
 
 /* NAME: validateInt()
  * PURPOSE: Validates if a command value is of an integer data type.
- * HOW IT WORKS: - Tokenises the line string containing the command operation
- *                 to grab the value as a string.
- *               - Convert the string value to an integer by using strtol() as
- *                 well as passing a string to identify errors during conversion.
- *               - If error string contains a new line character or a null
- *                 terminator, the datatype is correct.
- *               - Compare errorString to strValue to assure that strtol()
- *                 conversion went correctly. strtol() stores the original
- *                 string in errorPtr if conversion was not successful.
+ * HOW IT WORKS: - Tokenises the line span containing the command operation
+ *                 to grab the value.
+ *               - Convert the value in place to an integer by using
+ *                 parseInteger(), which parses it as strtol() would in a
+ *                 single pass, giving the remainder of the value left
+ *                 unconverted and the integer kept for the range check and
+ *                 the command.
+ *               - If the remainder is empty or starts with a new line
+ *                 character, the datatype is correct.
+ *               - Compare the remainder to the value to assure that
+ *                 conversion went correctly. Nothing is converted if the
+ *                 remainder is the whole value.
  * RELATIONS:
  *    main() - To evaluate the datatype validation condition for a command in a
  *             line.
- *           - Has the errorString and strValue passed by reference to also be
- *             utilised with other validation functions.
+ *           - Has the value passed by reference to also be utilised with
+ *             other validation functions.
  *    validateCommandName() - Points to this function depending on command operation.
  * IMPORTS:
- *    errorString - A pointer to a string passed by reference from main()
- *                  containing the errorString from strtol().
- *    strValue - A pointer to a string passed by reference from main() to be used
- *               in other validation functions dealing with the command value only.
+ *    rest - The rest of the line span, moved on past the value.
+ *    value - Set to the value's text, the part of it parseInteger() did not
+ *            convert and the integer, to be used in other validation
+ *            functions dealing with the command value only.
+ *    report - Collects the error message of an invalid value.
  * EXPORTS:
  *    isValid - A boolean evaluating to '0' (FALSE) if a command name is invalid
  *              or '-1' (TRUE) if command name is valid.
  *
  */
 
-int validateInt( char** errorString, char** strValue )
+int validateInt( Span* rest, Operand* value, Report* report )
 {
    int isValid = 0;
-   int intValue = 0;
 
-   /* Set the strValue to the expected value after command name on same line */
-   *strValue = strtok( NULL, " " );
+   /* Set the value to the expected value after command name on same line */
+   nextToken( rest, &value->text );
+   value->remainder = value->text;
 
-   if ( *strValue != NULL ) 
+   if ( value->text.start != NULL ) 
    {
-      intValue = strtol( *strValue, errorString, 10 );
+      value->integer = ( int )parseInteger( &value->text, &value->remainder );
 
-      /* Evaluate errorString after conversion */
-      if( ( (**errorString == '\n') || (**errorString == '\0') ) && ( (strlen(*strValue) != strlen(*errorString) ) && ( strcmp( *strValue, *errorString ) != 0 ) ) )
+      /* Evaluate the remainder after conversion */
+      if( ( isEndOfValue( &value->remainder ) != 0 ) && ( value->remainder.length != value->text.length ) )
       {
          isValid = -1;
       }
       else
       {
-         printf( "Error: integer data type expected\n" );
+         addMessage( report, "Error: integer data type expected\n" );
       }
    }
 
@@ -227,43 +257,41 @@ int validateInt( char** errorString, char** strValue )
 
 /* NAME: validateChar()
  * PURPOSE: Validates if a command value is of a printable char type.
- * HOW IT WORKS: - Grabs the character of from strValue and uses
+ * HOW IT WORKS: - Grabs the first character of the value and uses
  *                 isprint() to test if it's a printable character.
  * RELATIONS:
  *    main() - To evaluate the datatype validation condition for a command in a line.
  *    validateCommandName() - A pattern command specifically points to this function 
  *                            to evaluate datatype.
  * IMPORTS:
- *    errorString - A pointer to a string passed by reference from main() containing
- *                  the errorString. *Included as a parameter to match the CmdDataFunc
- *                  function pointer typedef signature.
- *    strValue - A pointer to a string passed by reference from main() to be used
- *               in other validation functions dealing with the command value only.
+ *    rest - The rest of the line span, moved on past the value.
+ *    value - Set to the value's text, to be used in other validation
+ *            functions dealing with the command value only. Its remainder
+ *            is set to nothing.
+ *    report - Collects the error message of an invalid value.
  * EXPORTS:
  *    isValid - A boolean evaluating to '0' (FALSE) if a command name is invalid
  *              or '-1' (TRUE) if command name is valid.
  *
  */
 
-int validateChar( char** errorString, char** strValue )
+int validateChar( Span* rest, Operand* value, Report* report )
 {
    int isValid = 0;
-   
-   char pattern;
  
-   /* Set the strValue to the expected value after command name on the same line */
-   *strValue = strtok( NULL, " " );
-
-   pattern = **strValue;
+   /* Set the value to the expected value after command name on the same line */
+   nextToken( rest, &value->text );
+   value->remainder.start = NULL;
+   value->remainder.length = 0;
 
    /* Check if pattern is a printable character */
-   if( isprint( pattern ) != 0 )
+   if( ( value->text.start != NULL ) && ( isprint( ( unsigned char )value->text.start[0] ) != 0 ) )
    {
       isValid = -1;
    }
    else
    {
-      printf( "Error: character data type expected\n" );
+      addMessage( report, "Error: character data type expected\n" );
    }
    
    return isValid;
@@ -273,59 +301,63 @@ int validateChar( char** errorString, char** strValue )
 
 /* NAME: validateParameters()
  * PURPOSE: Validates if the number of command parameters is only of a single value.
- * HOW IT WORKS: - Tokenises the original line string to check if any string
+ * HOW IT WORKS: - Tokenises the rest of the line span to check if any token
  *                 is passed to otherParameters.
- *               - if errorString contains either a new line character or null
- *                 terminator then strtoX() functions previously done would have
- *                 only converted the value and nothing else.
- *               - Further checks if no string is pointed by otherParameters then the parameters
+ *               - A value that is missing altogether is not valid.
+ *               - if the remainder is empty or starts with a new line
+ *                 character then the datatype validation previously done
+ *                 would have only converted the value and nothing else.
+ *               - Further checks if no token is found for otherParameters then the parameters
  *                 are valid.
- *               - If the otherParameters contains a string then further check
- *                 if the string contains entirely control characters in
- *                 stringIsCtrl() which can evaluate the parameter count to be valid.
+ *               - If the otherParameters contains a token then further check
+ *                 if the token contains entirely control characters in
+ *                 spanIsCtrl() which can evaluate the parameter count to be valid.
  *               - Otherwise the parameters cound are not valid.
  * RELATIONS:
  *   main() - To evaluate the parameter count validation condition for a command in
  *            a line.
- *          - Uses the strValue to point to the string of the value.
  *
  *   validateCommandName() - Points to this function depending on command operation. 
  * IMPORTS:
- *    strValue - A pointer to a string passed by reference from main() to be used in
- *               other validation functions dealing with the command value only.
- *    errorString - A pointer to a string passed by reference from main() containing
- *                  the errorString from stroX() functions.
+ *    rest - The rest of the line span after the value.
+ *    value - The value found by the datatype validation, with the part of
+ *            it left unconverted.
+ *    report - Collects the error message of an invalid value.
  * EXPORTS:
  *    isValid - A boolean evaluating to '0' (FALSE) if a command name is invalid or
  *              '-1' (TRUE) if command name is valid.
  */
 
-int validateParameters( char** strValue, char** errorString )
+int validateParameters( Span* rest, Operand* value, Report* report )
 {
    int isValid = 0;
 
-   char* otherParameters = NULL;
+   Span otherParameters;
 
    /* Check if any values exist after previously tokenised data value */
-   otherParameters = strtok( NULL, " " );
+   nextToken( rest, &otherParameters );
    
-   /* Check if errorString converted the numeric datatype correctly */
-   if( ( **errorString == '\n' ) || ( **errorString == '\0' ) )
+   if ( value->text.start == NULL )
+   {
+      addMessage( report, "Error: expected one parameter value\n" );
+   }
+   /* Check if the numeric datatype was converted correctly */
+   else if( isEndOfValue( &value->remainder ) != 0 )
    {
       /* If otherParameters don't exist then evaluate to true */
-      if ( otherParameters == NULL )
+      if ( otherParameters.start == NULL )
       {
          isValid = -1;
       }
       /* If otherParameters consist of non printable characters then parameters
        * are valid */
-      else if ( stringIsCtrl( otherParameters ) == -1 )
+      else if ( spanIsCtrl( &otherParameters ) == -1 )
       {
          isValid = -1;
       }
       else
       {
-         printf( "Error: expected one parameter value\n" );
+         addMessage( report, "Error: expected one parameter value\n" );
       }
    }
    
@@ -338,38 +370,40 @@ int validateParameters( char** strValue, char** errorString )
 /* NAME: validatePatternParameters()
  * PURPOSE: Validates if the number of command parameters is of a single character
  *          for a pattern command.
- * HOW IT WORKS: - Tokenises the original line string value to check if any string
+ * HOW IT WORKS: - Tokenises the rest of the line span to check if any token
  *                 is passed to otherParameters.
  *               - Also checks if the value of the pattern command is only
- *                 of a single character value by using strlen()
+ *                 of a single character value followed by its new line
  * RELATIONS:
  *    main() - To evaluate the parameter cound validation condition for a command in
  *             a line.
  *    validateCommandName() - Points to this function for pattern commands.
  * IMPORTS:
- *    strValue - A pointer to a string passed by 
+ *    rest - The rest of the line span after the value.
+ *    value - The value found by the datatype validation.
+ *    report - Collects the error message of an invalid value.
  * EXPORTS:
  *    isValid - A boolean evaluating to '0' (FALSE) if a command name is invalid
  *              or '-1' (TRUE) if command name is valid.
  */
 
-int validatePatternParameters( char** strValue, char** errorString )
+int validatePatternParameters( Span* rest, Operand* value, Report* report )
 {
    int isValid = 0;
 
-   char* otherParameters = NULL;
+   Span otherParameters;
 
-   otherParameters = strtok( NULL, " " );
+   nextToken( rest, &otherParameters );
    
-   /* Checks if the length of the string is two (character + new line) */
+   /* Checks if the length of the value is two (character + new line) */
    /* Checks if there are any tokenised values after a space */
-   if ( ( strlen( *strValue ) == 2) && ( otherParameters == NULL ) )
+   if ( ( value->text.length == 2 ) && ( otherParameters.start == NULL ) )
    {
       isValid = -1;
    }
    else
    {
-      printf( "Error: expected one parameter value\n" );
+      addMessage( report, "Error: expected one parameter value\n" );
    }
 
    return isValid;
@@ -379,39 +413,213 @@ int validatePatternParameters( char** strValue, char** errorString )
 
 
 
+/* NAME: validateName()
+ * PURPOSE: Validates if a command value is a procedure name.
+ * HOW IT WORKS: - Tokenises the line span containing the command operation
+ *                 to grab the name, leaving out any new line ending it.
+ *               - The name must start with a letter, followed by only
+ *                 letters, digits and underscores. Its length is left to
+ *                 the range validation.
+ * RELATIONS:
+ *    validateCommandName() - Points to this function on PROC and CALL
+ *                            commands.
+ * IMPORTS:
+ *    rest - The rest of the line span, moved on past the name.
+ *    value - Set to the name's text, to be used in other validation
+ *            functions dealing with the command value only. Its remainder
+ *            is set to nothing.
+ *    report - Collects the error message of an invalid name.
+ * EXPORTS:
+ *    isValid - A boolean evaluating to '0' (FALSE) if the name is invalid
+ *              or '-1' (TRUE) if the name is valid.
+ */
+
+int validateName( Span* rest, Operand* value, Report* report )
+{
+   int isValid = 0;
+   size_t length = 0;
+   size_t ii = 0;
+   unsigned char character;
+
+   nextToken( rest, &value->text );
+   value->remainder.start = NULL;
+   value->remainder.length = 0;
+
+   if ( value->text.start != NULL )
+   {
+      length = nameLength( &value->text );
+      if ( ( length > 0 ) && ( isalpha( ( unsigned char )value->text.start[0] ) != 0 ) )
+      {
+         isValid = -1;
+      }
+      for ( ii = 1; ( ii < length ) && ( isValid != 0 ); ii++ )
+      {
+         character = ( unsigned char )value->text.start[ii];
+         if ( ( isalnum( character ) == 0 ) && ( character != '_' ) )
+         {
+            isValid = 0;
+         }
+      }
+   }
+
+   if ( isValid == 0 )
+   {
+      addMessage( report, "Error: procedure name expected\n" );
+   }
+
+   return isValid;
+}
+
+
+
+/* NAME: validateBlockParameters()
+ * PURPOSE: Validates if a REPEAT or PROC command has a single value
+ *          followed by the [ opening its block.
+ * HOW IT WORKS: - Tokenises the rest of the line span for the [ and for
+ *                 any token after it.
+ *               - A value that is missing altogether is not valid, nor is
+ *                 one the datatype validation didn't convert entirely.
+ *               - The [ must be a token of its own, followed by nothing
+ *                 but control characters.
+ * RELATIONS:
+ *    validateCommandName() - Points to this function on REPEAT and PROC
+ *                            commands.
+ *    isOpenBlock() - Checks the token is a [.
+ * IMPORTS:
+ *    rest - The rest of the line span after the value.
+ *    value - The value found by the datatype validation, with the part of
+ *            it left unconverted.
+ *    report - Collects the error message of invalid parameters.
+ * EXPORTS:
+ *    isValid - A boolean evaluating to '0' (FALSE) if the parameters are
+ *              invalid or '-1' (TRUE) if they are valid.
+ */
+
+int validateBlockParameters( Span* rest, Operand* value, Report* report )
+{
+   int isValid = 0;
+
+   Span open;
+   Span otherParameters;
+
+   nextToken( rest, &open );
+   nextToken( rest, &otherParameters );
+
+   if ( value->text.start == NULL )
+   {
+      addMessage( report, "Error: expected one parameter value\n" );
+   }
+   else if ( isEndOfValue( &value->remainder ) != 0 )
+   {
+      if ( ( isOpenBlock( &open ) != 0 ) &&
+           ( ( otherParameters.start == NULL ) || ( spanIsCtrl( &otherParameters ) == -1 ) ) )
+      {
+         isValid = -1;
+      }
+      else
+      {
+         addMessage( report, "Error: expected one parameter value followed by [\n" );
+      }
+   }
+
+   return isValid;
+}
+
+
+
+/* NAME: validateBlockEnd()
+ * PURPOSE: Checks if a line holds only the ] closing a block.
+ * HOW IT WORKS: Tokenises the line, checking its first token is a ] on its
+ *               own, followed by nothing but control characters. Nothing
+ *               is reported, since any other line is simply not a ].
+ * RELATIONS:
+ *    validateLine() - Checks each line for a ] before its command name.
+ * IMPORTS:
+ *    line - The line span.
+ * EXPORTS:
+ *    isEnd - A boolean evaluating to '0' (FALSE) if the line is not a ] or
+ *            '-1' (TRUE) if it is.
+ */
+
+int validateBlockEnd( Span* line )
+{
+   int isEnd = 0;
+
+   Span rest = *line;
+   Span close;
+   Span otherParameters;
+
+   nextToken( &rest, &close );
+   nextToken( &rest, &otherParameters );
+
+   if ( ( close.start != NULL ) && ( close.start[0] == ']' ) &&
+        ( ( close.length == 1 ) || ( ( close.length == 2 ) && ( close.start[1] == '\n' ) ) ) &&
+        ( ( otherParameters.start == NULL ) || ( spanIsCtrl( &otherParameters ) == -1 ) ) )
+   {
+      isEnd = -1;
+   }
+
+   return isEnd;
+}
+
+
+
+
+/* NAME: setMaxDistance()
+ * PURPOSE: Sets the longest DRAW or MOVE distance allowed.
+ * HOW IT WORKS: Stores the distance for validateDrawRange() and
+ *               validateMoveRange() to check against.
+ * RELATIONS:
+ *    processFile() - Sets the distance chosen on the command line before
+ *                    validating a file.
+ * IMPORTS:
+ *    distance - The longest distance allowed.
+ * EXPORTS:
+ *    none
+ */
+
+void setMaxDistance( int distance )
+{
+   maxDistance = distance;
+}
+
+
+
+
 /* NAME: validateDrawRange()
  * PURPOSE: To validate the range of a distance to be no bigger than terminal
  *          maximum width.
  * HOW IT WORKS:
- *          - Converts the already validated datatype value to a real using
- *            atof().
- *          - Checks if distance is between 0 and 80 inclusive.
+ *          - Takes the real already converted by the datatype validation.
+ *          - Checks if distance is between 0 and the longest distance
+ *            allowed (80 unless set by setMaxDistance()) inclusive.
  * RELATIONS:
  *    main() - To evaluate the range of an already validated datatype for a command.
  *    validateCommandName() - Points to this function on draw commands.
  * IMPORTS:
- *    strValue - A pointer to a string passed by reference from main() to be used in
- *               other validation functions dealing with the command value only.
+ *    value - The value found by the datatype validation, to be used in
+ *            other validation functions dealing with the command value only.
+ *    report - Collects the error message of an invalid value.
  * EXPORTS:
  *    isValid - A boolean evaluating to '0' (FALSE) if a command name is invalid
  *              or '-1' (TRUE) if command name is valid.
  */
 
-int validateDrawRange( char** strValue )
+int validateDrawRange( Operand* value, Report* report )
 {
    int isValid = 0;
    
    double distance;
    
-   distance = atof( *strValue );
+   distance = value->real;
    
-   if ( ( 0 <= distance ) && ( distance <= 80 ) )
+   if ( ( 0 <= distance ) && ( distance <= maxDistance ) )
    {
       isValid = -1;
    }
    else
    {
-      printf( "Error: draw distance must be between 0 and 80\n" );
+      addMessage( report, "Error: draw distance must be between 0 and %d\n", maxDistance );
    }
 
    return isValid;
@@ -424,35 +632,36 @@ int validateDrawRange( char** strValue )
  * PURPOSE: To validate the range of a distance to be no bigger than terminal
  *          maximum width.
  * HOW IT WORKS:
- *          - Converts the already validated datatype value to a real using
- *            atof().
- *          - Checks if distance is between 0 and 80 inclusive.
+ *          - Takes the real already converted by the datatype validation.
+ *          - Checks if distance is between 0 and the longest distance
+ *            allowed (80 unless set by setMaxDistance()) inclusive.
  * RELATIONS:
  *    main() - To evaluate the range of an already validated datatype for a command.
  *    validateCommandName() - Points to this function on move commands.
  * IMPORTS:
- *    strValue - A pointer to a string passed by reference from main() to be used in
- *               other validation functions dealing with the command value only.
+ *    value - The value found by the datatype validation, to be used in
+ *            other validation functions dealing with the command value only.
+ *    report - Collects the error message of an invalid value.
  * EXPORTS:
  *    isValid - A boolean evaluating to '0' (FALSE) if a command name is invalid
  *              or '-1' (TRUE) if command name is valid.
  */   
 
-int validateMoveRange( char** strValue )
+int validateMoveRange( Operand* value, Report* report )
 {
    int isValid = 0;
 
    double distance;
 
-   distance = atof( *strValue );
+   distance = value->real;
 
-   if ( ( 0 <= distance ) && ( distance <= 80 ) )
+   if ( ( 0 <= distance ) && ( distance <= maxDistance ) )
    {
       isValid = -1;
    }
    else
    {
-      printf( "Error: move distance must be between 0 and 80\n" );
+      addMessage( report, "Error: move distance must be between 0 and %d\n", maxDistance );
    }
 
    return isValid;
@@ -472,14 +681,16 @@ int validateMoveRange( char** strValue )
  *    main() - To evaluate the range of an already validated datatype for a command.
  *    validateCommandName() - Points to this function on rotate commands.
  * IMPORTS:
- *    strValue - A pointer to a string passed by reference from main() to be used in
- *               other validation functions dealing with the command value only.
+ *    value - The value found by the datatype validation, to be used in
+ *            other validation functions dealing with the command value only.
+ *    report - Unused. *Included as a parameter to match the CmdRangeFunc
+ *             function pointer typedef signature.
  * EXPORTS:
  *    isValid - A boolean evaluating to '0' (FALSE) if a command name is invalid
  *              or '-1' (TRUE) if command name is valid.
  */
 
-int validateRotateRange( char** strValue )
+int validateRotateRange( Operand* value, Report* report )
 {
    int isValid = -1;
 
@@ -489,31 +700,106 @@ int validateRotateRange( char** strValue )
 
 
 
+/* NAME: validateRepeatRange()
+ * PURPOSE: To validate the range of a repeat count to be between 0 and
+ *          MAX_REPEATS.
+ * HOW IT WORKS:
+ *          - Takes the integer already converted by the datatype validation.
+ *          - Checks if the count is between 0 and MAX_REPEATS inclusive. A
+ *            count of 0 skips the block.
+ * RELATIONS:
+ *    validateCommandName() - Points to this function on repeat commands.
+ * IMPORTS:
+ *    value - The value found by the datatype validation, to be used in
+ *            other validation functions dealing with the command value only.
+ *    report - Collects the error message of an invalid value.
+ * EXPORTS:
+ *    isValid - A boolean evaluating to '0' (FALSE) if the count is invalid
+ *              or '-1' (TRUE) if the count is valid.
+ */
+
+int validateRepeatRange( Operand* value, Report* report )
+{
+   int isValid = 0;
+
+   if ( ( 0 <= value->integer ) && ( value->integer <= MAX_REPEATS ) )
+   {
+      isValid = -1;
+   }
+   else
+   {
+      addMessage( report, "Error: repeat count must be between 0 and %d\n", MAX_REPEATS );
+   }
+
+   return isValid;
+}
+
+
+
+
+/* NAME: validateNameRange()
+ * PURPOSE: To validate the length of a procedure name to be at most
+ *          PROC_NAME_LENGTH characters.
+ * HOW IT WORKS:
+ *          - Takes the name already checked by the datatype validation.
+ *          - Checks its length, leaving out any new line ending it, so the
+ *            name fits within its command.
+ * RELATIONS:
+ *    validateCommandName() - Points to this function on PROC and CALL
+ *                            commands.
+ * IMPORTS:
+ *    value - The value found by the datatype validation, to be used in
+ *            other validation functions dealing with the command value only.
+ *    report - Collects the error message of an invalid value.
+ * EXPORTS:
+ *    isValid - A boolean evaluating to '0' (FALSE) if the name is too long
+ *              or '-1' (TRUE) otherwise.
+ */
+
+int validateNameRange( Operand* value, Report* report )
+{
+   int isValid = 0;
+
+   if ( nameLength( &value->text ) <= PROC_NAME_LENGTH )
+   {
+      isValid = -1;
+   }
+   else
+   {
+      addMessage( report, "Error: procedure name must be at most %d characters\n", PROC_NAME_LENGTH );
+   }
+
+   return isValid;
+}
+
+
+
+
 /* NAME: validateFgRange()
  * PURPOSE: To validate the range of foreground colour to be between 0 to 15
  *          colours.
  * HOW IT WORKS:
- *       - Converts the already validated datatype value to an integer using
- *         atoi().
+ *       - Takes the integer already converted by the datatype validation.
  *       - Checks if fgColour is between 0 and 15 inclusive.
  * RELATIONS:
  *    main() - To evaluate the range of an already validated datatype for a command.
  *    validateCommandName() - Points to this function on fg commands.
  * IMPORTS:
- *    strValue - A pointer to a string passed by reference from main() to be used in
- *               other validation functions dealing with the command value only.
+ *    value - The value found by the datatype validation, to be used in
+ *            other validation functions dealing with the command value only.
+ *    report - Collects the error message of an invalid value.
  * EXPORTS:
  *    isValid - A boolean evaluating to '0' (FALSE) if a command name is invalid
  *              or '-1' (TRUE) if command name is valid.
  */
 
-int validateFgRange( char** strValue )
+int validateFgRange( Operand* value, Report* report )
 {
    int isValid = 0;
 
    int fgColour;
 
-   fgColour = atoi( *strValue );  
+   fgColour = value->integer;
 
    if ( ( 0 <= fgColour ) && ( fgColour <= 15 ) )
    {
@@ -521,7 +807,7 @@ int validateFgRange( char** strValue )
    }
    else
    {
-      printf( "Error: foreground colour must be between 0 and 15\n" );
+      addMessage( report, "Error: foreground colour must be between 0 and 15\n" );
    }
 
    return isValid;
@@ -534,27 +820,28 @@ int validateFgRange( char** strValue )
  * PURPOSE: To validate the range of background colour to be between 0 to 7
  *          colours.
  * HOW IT WORKS:
- *          - Converts the already validated datatype value to an integer using
- *            atoi().
+ *          - Takes the integer already converted by the datatype
+ *            validation.
  *          - Checks if bgColour is between 0 and 7 inclusive.
  * RELATIONS:
  *    main() - To evaluate the range of an already validated datatype for a command.
  *    validateCommandName() - Points to this function on bg commands.
  * IMPORTS:
- *    strValue - A pointer to a string passed by reference from main() to be used in
- *               other validation functions dealing with the command value only.
+ *    value - The value found by the datatype validation, to be used in
+ *            other validation functions dealing with the command value only.
+ *    report - Collects the error message of an invalid value.
  * EXPORTS:
  *    isValid - A boolean evaluating to '0' (FALSE) if a command name is invalid
  *              or '-1' (TRUE) if command name is valid.
  */
 
-int validateBgRange( char** strValue )
+int validateBgRange( Operand* value, Report* report )
 {
    int isValid = 0;
 
    int bgColour;
 
-   bgColour = atoi( *strValue );
+   bgColour = value->integer;
 
    if ( ( 0 <= bgColour ) && ( bgColour <= 7 ) )
    {
@@ -562,7 +849,7 @@ int validateBgRange( char** strValue )
    }
    else
    {
-      printf( "Error: background colour must be between 0 and 7\n" );
+      addMessage( report, "Error: background colour must be between 0 and 7\n" );
    }
 
    return isValid;
@@ -583,14 +870,16 @@ int validateBgRange( char** strValue )
  *    main() - To evaluate the range of an already validated datatype for a command.
  *    validateCommandName() - Points to this function on pattern commands.
  * IMPORTS:
- *    strValue - A pointer to a string passed by reference from main() to be used in
- *               other validation functions dealing with the command value only.
+ *    value - The value found by the datatype validation, to be used in
+ *            other validation functions dealing with the command value only.
+ *    report - Unused. *Included as a parameter to match the CmdRangeFunc
+ *             function pointer typedef signature.
  * EXPORTS:
  *    isValid - A boolean evaluating to '0' (FALSE) if a command name is invalid
  *              or '-1' (TRUE) if command name is valid.
  */
 
-int validatePatternRange( char** strValue )
+int validatePatternRange( Operand* value, Report* report )
 {
    int isValid = -1;
    
@@ -598,3 +887,165 @@ int validatePatternRange( char** strValue )
 }
 
 
+
+
+
+
+/* NAME: isEndOfValue()
+ * PURPOSE: Checks if the part of a value left unconverted ends the value.
+ * HOW IT WORKS: The remainder ends the value if it is empty, or is the new
+ *               line ending the line.
+ * RELATIONS:
+ *    validateReal()/validateInt() - Check a value converted entirely.
+ *    validateParameters() - Checks the value held nothing else.
+ * IMPORTS:
+ *    remainder - The part of the value left unconverted.
+ * EXPORTS:
+ *    isEnd - Boolean evaluating to '-1' (TRUE) if nothing but a new line is
+ *            left, or '0' (FALSE) otherwise.
+ */
+
+static int isEndOfValue( Span* remainder )
+{
+   int isEnd = 0;
+
+   if ( ( remainder->length == 0 ) || ( remainder->start[0] == '\n' ) )
+   {
+      isEnd = -1;
+   }
+
+   return isEnd;
+}
+
+
+/* NAME: isOpenBlock()
+ * PURPOSE: Checks if a token is the [ opening a block.
+ * HOW IT WORKS: The token is a [ on its own, or with the new line ending
+ *               the line.
+ * RELATIONS:
+ *    validateBlockParameters() - Checks the token after a REPEAT or PROC
+ *                                value.
+ * IMPORTS:
+ *    token - The token, with a NULL start if there is none.
+ * EXPORTS:
+ *    isOpen - Boolean evaluating to '-1' (TRUE) if the token is a [, or '0'
+ *             (FALSE) otherwise.
+ */
+
+static int isOpenBlock( Span* token )
+{
+   int isOpen = 0;
+
+   if ( ( token->start != NULL ) && ( token->start[0] == '[' ) &&
+        ( ( token->length == 1 ) || ( ( token->length == 2 ) && ( token->start[1] == '\n' ) ) ) )
+   {
+      isOpen = -1;
+   }
+
+   return isOpen;
+}
+
+
+/* NAME: nameLength()
+ * PURPOSE: Finds the length of a procedure name token.
+ * HOW IT WORKS: Leaves out the new line ending the token, if it is the last
+ *               on its line.
+ * RELATIONS:
+ *    validateName()/validateNameRange() - Check the name itself.
+ * IMPORTS:
+ *    name - The name token.
+ * EXPORTS:
+ *    length - The number of characters of the name.
+ */
+
+static size_t nameLength( Span* name )
+{
+   size_t length = name->length;
+
+   if ( ( length > 0 ) && ( name->start[length - 1] == '\n' ) )
+   {
+      length--;
+   }
+
+   return length;
+}
+
+
+/* NAME: buildCommandSlots()
+ * PURPOSE: Fills commandSlots from commands, so each command is found with
+ *          a single comparison.
+ * HOW IT WORKS: Tries seeds from 0 until one hashes every command to a
+ *               slot of its own, keeping that seed for the lookups. With
+ *               four slots or more for each command a seed is found within
+ *               a few tries; none being found in MAX_SEEDS is a fault in
+ *               commands, such as a name given twice, and fails the assert.
+ * RELATIONS:
+ *    validateCommandName() - Builds the slots once, with pthread_once(),
+ *                            before the first lookup on any thread.
+ *    hashCommandName() - Hashes each command's name.
+ * IMPORTS:
+ *    none
+ * EXPORTS:
+ *    none
+ */
+
+static void buildCommandSlots( void )
+{
+   int isFound = 0;
+   unsigned long seed;
+   size_t ii;
+   int slot;
+
+   for ( seed = 0; ( seed < MAX_SEEDS ) && ( isFound == 0 ); seed++ )
+   {
+      isFound = -1;
+      memset( commandSlots, -1, sizeof( commandSlots ) );
+      for ( ii = 0; ( ii < COMMAND_COUNT ) && ( isFound != 0 ); ii++ )
+      {
+         slot = hashCommandName( commands[ii].name, strlen( commands[ii].name ), seed );
+         if ( commandSlots[slot] >= 0 )
+         {
+            isFound = 0;
+         }
+         else
+         {
+            commandSlots[slot] = ( signed char )ii;
+         }
+      }
+      slotSeed = seed;
+   }
+
+   assert( isFound != 0 );
+}
+
+
+/* NAME: hashCommandName()
+ * PURPOSE: Finds the slot of commandSlots a command name belongs in.
+ * HOW IT WORKS: 32 bit FNV-1a over every character of the name, starting
+ *               from the offset basis mixed with the seed, keeping the top
+ *               bits. Each character has bit 0x20 set first, which makes
+ *               upper case letters lower case, so a name hashes the same in
+ *               any casing.
+ * RELATIONS:
+ *    buildCommandSlots() - Places each command.
+ *    validateCommandName() - Looks up each command name read.
+ * IMPORTS:
+ *    name - The characters of the name, not needing a terminator.
+ *    length - The number of characters.
+ *    seed - The seed chosen by buildCommandSlots().
+ * EXPORTS:
+ *    hash - The slot, below COMMAND_SLOTS.
+ */
+
+static int hashCommandName( const char* name, size_t length, unsigned long seed )
+{
+   unsigned long hash = ( 2166136261UL ^ ( seed * 2654435761UL ) ) & 0xFFFFFFFFUL;
+   size_t ii;
+
+   for ( ii = 0; ii < length; ii++ )
+   {
+      hash = ( ( hash ^ ( ( unsigned char )name[ii] | 0x20 ) ) * 16777619UL ) & 0xFFFFFFFFUL;
+   }
+
+   return ( int )( ( hash >> 26 ) & ( COMMAND_SLOTS - 1 ) );
+}
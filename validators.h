@@ -7,66 +7,124 @@
 #ifndef VALIDATORS_H
    #define VALIDATORS_H
 
+   #include "structset.h"
+   #include "stringoperations.h"
+   #include "report.h"
+
+   /* Most times a REPEAT block can run */
+   #define MAX_REPEATS 1000000
+
+   /* Stores the value of a command as it is validated, parsed only once by
+    * the datatype validation and then used by the range validation and
+    * when storing the command */
+   typedef struct
+   {
+      /* The value's text within the line */
+      Span text;
+      /* Part of the value left unconverted */
+      Span remainder;
+      /* Converted value of a real or integer command */
+      double real;
+      int integer;
+   } Operand;
+
    /* Pointers to Function Typedef */
    /* Points to parameter validator functions */
-   typedef int ( *CmdParamFunc )( char**, char** );
+   typedef int ( *CmdParamFunc )( Span*, Operand*, Report* );
    
    /* Points to datatype validator functions */
-   typedef int ( *CmdDataFunc )( char**, char** );
+   typedef int ( *CmdDataFunc )( Span*, Operand*, Report* );
    
    /* Points to value range validator functions */
-   typedef int ( *CmdRangeFunc )( char** );
+   typedef int ( *CmdRangeFunc )( Operand*, Report* );
+
+   /* Describes a command, the operation of its name and the validators
+    * its value goes through */
+   typedef struct
+   {
+      const char* name;
+      Opcode opcode;
+      CmdDataFunc validateDataType;
+      CmdParamFunc validateParameters;
+      CmdRangeFunc validateRange;
+   } CommandDescriptor;
    
    
    /* Verifies if a command name is valid and return if a command name 
     * is found or not found. Provides the main function assistance
-    * to continue validating other command fields.
+    * to continue validating other command fields. The descriptor of a found
+    * command is exported, giving its validators and the opcode for storing
+    * the command once fully validated.
     */
-   int validateCommandName( char* tempLine, CmdDataFunc* validateDataType, CmdParamFunc* validateParameters, CmdRangeFunc* validateRange );
+   int validateCommandName( Span* rest, const CommandDescriptor** command );
 
    /* Validates if a command value is of a real data type. */
-   int validateReal( char** errorString, char** strValue );
+   int validateReal( Span* rest, Operand* value, Report* report );
    
    /* Validates if a command value is of an integer data type. */
-   int validateInt( char** errorString, char** strValue );
+   int validateInt( Span* rest, Operand* value, Report* report );
    
    /* Validates if a command value is of a printable char type. */
-   int validateChar( char** errorString, char** strValue );
+   int validateChar( Span* rest, Operand* value, Report* report );
+
+   /* Validates if a command value is a procedure name. */
+   int validateName( Span* rest, Operand* value, Report* report );
 
    /* Validates if the number of command parameters is only of a single value. */
-   int validateParameters( char** strValue, char** errorString );
+   int validateParameters( Span* rest, Operand* value, Report* report );
    
    /* Validates if the number of command parameters is of a single character
     * for a pattern command.
     */
-   int validatePatternParameters( char** strValue, char** errorString );
+   int validatePatternParameters( Span* rest, Operand* value, Report* report );
+
+   /* Validates if a REPEAT or PROC command has a single value followed by
+    * the [ opening its block.
+    */
+   int validateBlockParameters( Span* rest, Operand* value, Report* report );
+
+   /* Checks if a line holds only the ] closing a block. */
+   int validateBlockEnd( Span* line );
+
+   /* Sets the longest DRAW or MOVE distance allowed, 80 by default. */
+   void setMaxDistance( int distance );
 
    /* To validate the range of a distance to be no bigger than terminal
     * maximum width.
     */
-   int validateDrawRange( char** strValue );
+   int validateDrawRange( Operand* value, Report* report );
    
    /* To validate the range of a distance to be no bigger than terminal
     * maximum width.
     */
-   int validateMoveRange( char** strValue );
+   int validateMoveRange( Operand* value, Report* report );
    
    /* Placeholder function in the case of a rotate range to be assigned
     * in the future.
     */
-   int validateRotateRange( char** strValue );
+   int validateRotateRange( Operand* value, Report* report );
    
+   /* To validate the range of a repeat count to be between 0 and
+    * MAX_REPEATS.
+    */
+   int validateRepeatRange( Operand* value, Report* report );
+
+   /* To validate the length of a procedure name to be at most
+    * PROC_NAME_LENGTH characters.
+    */
+   int validateNameRange( Operand* value, Report* report );
+
    /* To validate the range of foreground colour to be between 0 to 15
     * colours.
     */
-   int validateFgRange( char** strValue );
+   int validateFgRange( Operand* value, Report* report );
    
    /* To validate the range of background colour to be between 0 to 7
     * colours.
     */
-   int validateBgRange( char** strValue );
+   int validateBgRange( Operand* value, Report* report );
    
    /* Validates the range of pattern printable characters */
-   int validatePatternRange ( char** strValue );
+   int validatePatternRange ( Operand* value, Report* report );
    
 #endif
@@ -0,0 +1,249 @@
+/* FILE: viewport.c
+ * AUTHOR: Kyle Notani | 19149918
+ * UNIT: UCP COMP1000
+ * PURPOSE: Clip rasterized lines to the viewport before any of their cells
+ *          are visited, so lines off the viewport cost no raster work.
+ * OTHER: Products of line distances are worked out in long, which holds
+ *        them on 64 bit machines.
+ *        '-1' evaluates to true, '0' evaluates to false.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "viewport.h"
+
+static long floorDivide( long numerator, long denominator );
+static long ceilDivide( long numerator, long denominator );
+
+
+/* NAME: clipLine()
+ * PURPOSE: Clips the line from (x1,y1) to (x2,y2) to the viewport, returning
+ *          whether any of it is visible.
+ * HOW IT WORKS: - Bresenham's line algorithm visits cell i (0 to majorDelta)
+ *                 at i steps along the major axis and
+ *                 m(i) = floor( ( majorDelta / 2 + i * minorDelta ) / majorDelta )
+ *                 steps across the minor axis, the same cells as line() in
+ *                 effects.c.
+ *               - The major axis bounds of the viewport give a range of i
+ *                 directly. As m(i) never decreases, the minor axis bounds
+ *                 give another range of i by solving m(i) >= a and
+ *                 m(i) <= b, both in integers.
+ *               - The visible cells are where both ranges overlap. The
+ *                 segment starts from the first of them with the decision
+ *                 value the algorithm would have reached there, so the
+ *                 visible cells are exactly the ones the whole line would
+ *                 have drawn.
+ * RELATIONS:
+ *    drawLine() - Clips each line before it is drawn.
+ *    frameSegment()/drawSegment() - Draw the clipped segment.
+ * IMPORTS:
+ *    view - The viewport to clip to.
+ *    x1/y1 - Starting cell.
+ *    x2/y2 - Finishing cell.
+ *    seg - Segment to fill with the visible part of the line.
+ * EXPORTS:
+ *    isVisible - Boolean evaluating to '0' (FALSE) if no cell of the line
+ *                lies in the viewport, leaving seg unset, or '-1' (TRUE).
+ */
+
+int clipLine( Viewport* view, int x1, int y1, int x2, int y2, Segment* seg )
+{
+   int isVisible = 0;
+   long deltaX = ( long )x2 - x1;
+   long deltaY = ( long )y2 - y1;
+   long right = ( long )view->left + view->width - 1;
+   long bottom = ( long )view->top + view->height - 1;
+   long majorDelta, minorDelta, majorStart, minorStart;
+   long majorFirst, majorLast, minorFirst, minorLast;
+   long majorStep, minorStep, half;
+   long first, last, low, high, steps, minor;
+
+   seg->stepX = ( deltaX < 0 ) ? -1 : 1;
+   seg->stepY = ( deltaY < 0 ) ? -1 : 1;
+   deltaX = labs( deltaX );
+   deltaY = labs( deltaY );
+
+   /* Same choice of major axis as line() */
+   seg->xIsMajor = ( deltaY > deltaX ) ? 0 : -1;
+   if ( seg->xIsMajor != 0 )
+   {
+      majorDelta = deltaX;
+      minorDelta = deltaY;
+      majorStart = x1;
+      minorStart = y1;
+      majorStep = seg->stepX;
+      minorStep = seg->stepY;
+      majorFirst = view->left;
+      majorLast = right;
+      minorFirst = view->top;
+      minorLast = bottom;
+   }
+   else
+   {
+      majorDelta = deltaY;
+      minorDelta = deltaX;
+      majorStart = y1;
+      minorStart = x1;
+      majorStep = seg->stepY;
+      minorStep = seg->stepX;
+      majorFirst = view->top;
+      majorLast = bottom;
+      minorFirst = view->left;
+      minorLast = right;
+   }
+   half = majorDelta / 2;
+
+   /* Cells within the viewport along the major axis */
+   low = ( majorStep > 0 ) ? majorFirst - majorStart : majorStart - majorLast;
+   high = ( majorStep > 0 ) ? majorLast - majorStart : majorStart - majorFirst;
+   first = ( low > 0 ) ? low : 0;
+   last = ( high < majorDelta ) ? high : majorDelta;
+
+   /* Steps across the minor axis that stay within the viewport */
+   low = ( minorStep > 0 ) ? minorFirst - minorStart : minorStart - minorLast;
+   high = ( minorStep > 0 ) ? minorLast - minorStart : minorStart - minorFirst;
+
+   if ( minorDelta == 0 )
+   {
+      /* m(i) is always 0 */
+      if ( ( low > 0 ) || ( high < 0 ) )
+      {
+         last = -1;
+      }
+   }
+   else
+   {
+      /* m(i) >= low when half + i * minorDelta >= low * majorDelta */
+      steps = ceilDivide( low * majorDelta - half, minorDelta );
+      if ( steps > first )
+      {
+         first = steps;
+      }
+
+      /* m(i) <= high when half + i * minorDelta < ( high + 1 ) * majorDelta */
+      steps = floorDivide( ( high + 1 ) * majorDelta - half - 1, minorDelta );
+      if ( steps < last )
+      {
+         last = steps;
+      }
+   }
+
+   if ( ( view->width > 0 ) && ( view->height > 0 ) && ( first <= last ) )
+   {
+      isVisible = -1;
+
+      seg->majorDelta = ( int )majorDelta;
+      seg->minorDelta = ( int )minorDelta;
+      seg->count = ( int )( last - first + 1 );
+
+      /* State of the algorithm at the first visible cell */
+      minor = 0;
+      seg->decision = 0;
+      if ( majorDelta > 0 )
+      {
+         minor = floorDivide( half + first * minorDelta, majorDelta );
+         seg->decision = ( int )( half + first * minorDelta - minor * majorDelta );
+      }
+
+      if ( seg->xIsMajor != 0 )
+      {
+         seg->x = ( int )( majorStart + majorStep * first );
+         seg->y = ( int )( minorStart + minorStep * minor );
+      }
+      else
+      {
+         seg->x = ( int )( minorStart + minorStep * minor );
+         seg->y = ( int )( majorStart + majorStep * first );
+      }
+   }
+
+   return isVisible;
+}
+
+
+/* NAME: intersectViewport()
+ * PURPOSE: Shrinks a viewport to the part of it within another rectangle.
+ * HOW IT WORKS: Moves each edge of the viewport inwards to the matching edge
+ *               of the bounds if it lies beyond it. A viewport entirely
+ *               outside the bounds is left with no width or height.
+ * RELATIONS:
+ *    draw() - Limits the lines drawn to those within both the viewport and
+ *             the canvas.
+ * IMPORTS:
+ *    view - The viewport to shrink.
+ *    bounds - The rectangle to shrink it to.
+ * EXPORTS:
+ *    none
+ */
+
+void intersectViewport( Viewport* view, Viewport* bounds )
+{
+   long left = ( view->left > bounds->left ) ? view->left : bounds->left;
+   long top = ( view->top > bounds->top ) ? view->top : bounds->top;
+   long right = ( long )view->left + view->width;
+   long bottom = ( long )view->top + view->height;
+
+   if ( ( long )bounds->left + bounds->width < right )
+   {
+      right = ( long )bounds->left + bounds->width;
+   }
+   if ( ( long )bounds->top + bounds->height < bottom )
+   {
+      bottom = ( long )bounds->top + bounds->height;
+   }
+
+   view->left = ( int )left;
+   view->top = ( int )top;
+   view->width = ( right > left ) ? ( int )( right - left ) : 0;
+   view->height = ( bottom > top ) ? ( int )( bottom - top ) : 0;
+}
+
+
+/* NAME: floorDivide()
+ * PURPOSE: Divides, rounding towards negative infinity.
+ * HOW IT WORKS: C89 leaves the rounding of a negative quotient up to the
+ *               compiler, so the quotient is worked out from non-negative
+ *               values only.
+ * RELATIONS:
+ *    clipLine() - Solves for the steps within the viewport.
+ * IMPORTS:
+ *    numerator - Any value.
+ *    denominator - A value greater than 0.
+ * EXPORTS:
+ *    quotient - The largest integer no greater than the exact quotient.
+ */
+
+static long floorDivide( long numerator, long denominator )
+{
+   long quotient;
+
+   if ( numerator >= 0 )
+   {
+      quotient = numerator / denominator;
+   }
+   else
+   {
+      quotient = -( ( -numerator + denominator - 1 ) / denominator );
+   }
+
+   return quotient;
+}
+
+
+/* NAME: ceilDivide()
+ * PURPOSE: Divides, rounding towards positive infinity.
+ * HOW IT WORKS: Negates the floor of the negated quotient.
+ * RELATIONS:
+ *    clipLine() - Solves for the steps within the viewport.
+ * IMPORTS:
+ *    numerator - Any value.
+ *    denominator - A value greater than 0.
+ * EXPORTS:
+ *    quotient - The smallest integer no less than the exact quotient.
+ */
+
+static long ceilDivide( long numerator, long denominator )
+{
+   return -floorDivide( -numerator, denominator );
+}
@@ -0,0 +1,53 @@
+/* FILE: viewport.h
+ * AUTHOR: Kyle Notani | 19149918
+ * UNIT: UCP COMP1000
+ * PURPOSE: Header file associated with viewport.c
+ */
+
+#ifndef VIEWPORT_H
+   #define VIEWPORT_H
+
+   /* Size in cells of the viewport when none is chosen */
+   #define VIEW_WIDTH 1024
+   #define VIEW_HEIGHT 1024
+
+   /* Stores the rectangle of the drawing shown, with its top left cell
+    * placed at the top left of the terminal */
+   typedef struct
+   {
+      int left;
+      int top;
+      int width;
+      int height;
+   } Viewport;
+
+   /* Stores the visible part of a rasterized line as the state of
+    * Bresenham's line algorithm at its first visible cell, so the cells
+    * visited are exactly those of the whole line */
+   typedef struct
+   {
+      /* First visible cell */
+      int x;
+      int y;
+      /* Number of visible cells */
+      int count;
+      /* Distances of the whole line along its major and minor axis */
+      int majorDelta;
+      int minorDelta;
+      /* Decision value at the first visible cell, 0 to majorDelta - 1 */
+      int decision;
+      /* Direction of the line along each axis, 1 or -1 */
+      int stepX;
+      int stepY;
+      /* Whether x is the major axis, '-1' (TRUE) or '0' (FALSE) */
+      int xIsMajor;
+   } Segment;
+
+   /* Clips the line from (x1,y1) to (x2,y2) to the viewport, returning
+    * whether any of it is visible. */
+   int clipLine( Viewport* view, int x1, int y1, int x2, int y2, Segment* seg );
+
+   /* Shrinks a viewport to the part of it within another rectangle. */
+   void intersectViewport( Viewport* view, Viewport* bounds );
+
+#endif